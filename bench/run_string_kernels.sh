@@ -0,0 +1,17 @@
+#!/bin/sh
+# Builds bench/string_kernels_bench.cpp and runs it on the AVX2 path and then
+# on the portable path (MEGALADON_NO_AVX2=1), so the two can be compared.
+#
+# Usage: bench/run_string_kernels.sh [megabytes]   (default 16; CXX picks the compiler)
+
+set -e
+dir=$(dirname "$0")
+src="$dir/../src"
+binary=${TMPDIR:-/tmp}/megaladon_string_kernels_bench
+
+${CXX:-g++} -std=c++17 -O2 -I"$src" "$dir/string_kernels_bench.cpp" \
+    "$src/util/string_kernels.cpp" "$src/util/cpu_features.cpp" -o "$binary"
+
+"$binary" "$@"
+MEGALADON_NO_AVX2=1 "$binary" "$@"
+rm -f "$binary"
@@ -0,0 +1,92 @@
+// Throughput of the string kernels (src/util/string_kernels.h) on the path the
+// CPU dispatches to: AVX2 where it is available, the portable loops otherwise
+// or when MEGALADON_NO_AVX2=1 is set. run_string_kernels.sh builds this and
+// runs it both ways.
+//
+//   g++ -std=c++17 -O2 -Isrc bench/string_kernels_bench.cpp src/util/string_kernels.cpp \
+//       src/util/cpu_features.cpp -o string_kernels_bench
+//   ./string_kernels_bench [megabytes]   (default 16)
+//
+// The text is pseudo-random words of mixed case. Each kernel is timed over the
+// whole text until at least 0.2 s have passed; the best of five such runs is
+// reported, in GB/s of text.
+
+#include "util/string_kernels.h"
+#include "util/cpu_features.h"
+#include <algorithm> // For std::max
+#include <chrono>
+#include <cstdint>   // For uint64_t
+#include <cstdio>
+#include <cstdlib>   // For std::atof
+#include <string>
+#include <vector>
+
+namespace {
+
+volatile size_t sink; // Keeps the results alive
+
+std::string makeText(size_t bytes) {
+    std::string text;
+    text.reserve(bytes);
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    auto next = [&state] {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<unsigned>(state >> 33);
+    };
+    while (text.size() < bytes) {
+        size_t length = 1 + next() % 9;
+        for (size_t i = 0; i < length && text.size() < bytes; ++i) {
+            char c = static_cast<char>('a' + next() % 26);
+            text.push_back(next() % 10 == 0 ? static_cast<char>(c - 'a' + 'A') : c);
+        }
+        if (text.size() < bytes) text.push_back(' ');
+    }
+    return text;
+}
+
+// Best throughput of 'run' over five timed runs, in GB/s of 'bytes'
+template <typename Run>
+double measure(size_t bytes, Run run) {
+    double best = 0;
+    for (int round = 0; round < 5; ++round) {
+        auto start = std::chrono::steady_clock::now();
+        size_t passes = 0;
+        double seconds = 0;
+        do {
+            run();
+            ++passes;
+            seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        } while (seconds < 0.2);
+        best = std::max(best, static_cast<double>(bytes) * static_cast<double>(passes) / seconds / 1e9);
+    }
+    return best;
+}
+
+void report(const char* name, double gigabytesPerSecond) {
+    std::printf("  %-34s %8.2f GB/s\n", name, gigabytesPerSecond);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    double megabytes = argc > 1 ? std::atof(argv[1]) : 16.0;
+    if (!(megabytes > 0)) {
+        std::fprintf(stderr, "usage: %s [megabytes]\n", argv[0]);
+        return 1;
+    }
+    std::string text = makeText(static_cast<size_t>(megabytes * 1024 * 1024));
+    std::vector<char> out(text.size());
+    size_t n = text.size();
+
+    std::printf("string kernels, %s path, %.0f MB of text\n", CpuFeatures::get().avx2 ? "AVX2" : "portable", megabytes);
+
+    // Absent needles scan the whole text; '#' never occurs, so only the first
+    // byte can match and most candidates are rejected without a compare
+    report("find, 2-byte needle (absent)", measure(n, [&] { sink = kernelFind(text, "e#"); }));
+    report("find, 16-byte needle (absent)", measure(n, [&] { sink = kernelFind(text, "abcdefghijklmno#"); }));
+    report("count \"the\"", measure(n, [&] { sink = kernelCount(text, "the"); }));
+    report("to_lower", measure(n, [&] { kernelAsciiLower(text.data(), out.data(), n); sink = static_cast<size_t>(out[n / 2]); }));
+    report("to_upper", measure(n, [&] { kernelAsciiUpper(text.data(), out.data(), n); sink = static_cast<size_t>(out[n / 2]); }));
+    report("count_any_of \"aeiouAEIOU\"", measure(n, [&] { sink = kernelCountAnyOf(text, "aeiouAEIOU"); }));
+    return 0;
+}
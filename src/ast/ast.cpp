@@ -46,6 +46,18 @@ MegaladonValue ListExpr::accept(ExprVisitor<MegaladonValue>& visitor) {
     return visitor.visit(std::static_pointer_cast<ListExpr>(shared_from_this()));
 }
 
+MegaladonValue MapExpr::accept(ExprVisitor<MegaladonValue>& visitor) {
+    return visitor.visit(std::static_pointer_cast<MapExpr>(shared_from_this()));
+}
+
+MegaladonValue SliceExpr::accept(ExprVisitor<MegaladonValue>& visitor) {
+    return visitor.visit(std::static_pointer_cast<SliceExpr>(shared_from_this()));
+}
+
+MegaladonValue MethodCallExpr::accept(ExprVisitor<MegaladonValue>& visitor) {
+    return visitor.visit(std::static_pointer_cast<MethodCallExpr>(shared_from_this()));
+}
+
 
 // --- Statement accept methods ---
 void BlockStmt::accept(StmtVisitor<void>& visitor) {
@@ -78,4 +90,8 @@ void VarStmt::accept(StmtVisitor<void>& visitor) {
 
 void WhileStmt::accept(StmtVisitor<void>& visitor) {
     visitor.visit(std::static_pointer_cast<WhileStmt>(shared_from_this()));
+}
+
+void ForInStmt::accept(StmtVisitor<void>& visitor) {
+    visitor.visit(std::static_pointer_cast<ForInStmt>(shared_from_this()));
 }
\ No newline at end of file
@@ -25,6 +25,9 @@ class SetExpr;
 class UnaryExpr;
 class VariableExpr;
 class ListExpr; // New expression type for lists
+class MapExpr;  // Map literals, e.g. {"a": 1}
+class SliceExpr; // Slices, e.g. list[1:3]
+class MethodCallExpr; // Method calls, e.g. s.split(",")
 
 class Stmt;
 class BlockStmt;
@@ -35,6 +38,7 @@ class PrintStmt;
 class ReturnStmt;
 class VarStmt;
 class WhileStmt;
+class ForInStmt;
 
 
 // --- Expressions ---
@@ -71,6 +75,10 @@ public:
     std::shared_ptr<Expr> callee;
     Token paren;
     std::vector<std::shared_ptr<Expr>> arguments;
+
+    // Native callee this site was last linked to; its arity has been checked
+    // against the argument count, so calls to it skip the check
+    std::shared_ptr<MegaladonCallable> linked;
 };
 
 class GetExpr : public Expr, public std::enable_shared_from_this<GetExpr> {
@@ -85,6 +93,17 @@ public:
     std::shared_ptr<Expr> object;
     Token name; // For property access (e.g., obj.prop)
     std::shared_ptr<Expr> index; // For indexed access (e.g., list[idx])
+
+    // Filled in by the parser: the object when it is a plain variable, whose
+    // value is then read where it lives
+    VariableExpr* variable = nullptr;
+    // While a for-in loop over a range of integers runs, a site indexing a list
+    // with the loop variable checks the range's largest item against the list's
+    // length on its first read instead of checking every index (see
+    // Interpreter::visit(ForInStmt))
+    enum BoundsCheck : unsigned char { CHECK_EACH, CHECK_ONCE, CHECKED };
+    BoundsCheck boundsCheck = CHECK_EACH;
+    double rangeHigh = 0; // Largest item of the range, for CHECK_ONCE
 };
 
 class GroupingExpr : public Expr, public std::enable_shared_from_this<GroupingExpr> {
@@ -126,6 +145,11 @@ public:
     Token name; // For property assignment
     std::shared_ptr<Expr> index; // For indexed assignment
     std::shared_ptr<Expr> value;
+
+    // Filled in by the parser for targets rooted at a variable (xs[i], grid[y][x]):
+    // the variable and the enclosing index expressions, outermost first
+    VariableExpr* root = nullptr;
+    std::vector<GetExpr*> path;
 };
 
 class UnaryExpr : public Expr, public std::enable_shared_from_this<UnaryExpr> {
@@ -153,6 +177,47 @@ public:
     std::vector<std::shared_ptr<Expr>> elements;
 };
 
+class MapExpr : public Expr, public std::enable_shared_from_this<MapExpr> {
+public:
+    MapExpr(std::vector<std::shared_ptr<Expr>> keys, std::vector<std::shared_ptr<Expr>> values)
+        : keys(keys), values(values) {}
+    MegaladonValue accept(ExprVisitor<MegaladonValue>& visitor) override;
+    std::vector<std::shared_ptr<Expr>> keys;
+    std::vector<std::shared_ptr<Expr>> values; // values[i] belongs to keys[i]
+};
+
+class SliceExpr : public Expr, public std::enable_shared_from_this<SliceExpr> {
+public:
+    SliceExpr(std::shared_ptr<Expr> object, Token bracket, std::shared_ptr<Expr> start, std::shared_ptr<Expr> stop)
+        : object(object), bracket(bracket), start(start), stop(stop) {}
+    MegaladonValue accept(ExprVisitor<MegaladonValue>& visitor) override;
+    std::shared_ptr<Expr> object;
+    Token bracket; // For error reporting
+    std::shared_ptr<Expr> start; // nullptr when omitted, e.g. list[:3]
+    std::shared_ptr<Expr> stop;  // nullptr when omitted, e.g. list[1:]
+};
+
+struct NativeMethod; // Defined in builtins.h
+
+// receiver.name(arguments) - calls a native method of the receiver's type.
+// Each call site remembers the last receiver type it saw and the method it
+// found for it, so a site that always sees the same type skips the lookup.
+class MethodCallExpr : public Expr, public std::enable_shared_from_this<MethodCallExpr> {
+public:
+    MethodCallExpr(std::shared_ptr<Expr> object, Token name, Token paren, std::vector<std::shared_ptr<Expr>> arguments)
+        : object(object), name(name), paren(paren), arguments(arguments) {}
+    MegaladonValue accept(ExprVisitor<MegaladonValue>& visitor) override;
+    std::shared_ptr<Expr> object;
+    Token name;
+    Token paren; // For error reporting
+    std::vector<std::shared_ptr<Expr>> arguments;
+
+    // Monomorphic inline cache, filled in by the interpreter; empty while
+    // cachedMethod is null
+    ValueType cachedType = INVALID;
+    const NativeMethod* cachedMethod = nullptr;
+};
+
 // --- Statements ---
 class Stmt : public std::enable_shared_from_this<Stmt> {
 public:
@@ -231,4 +296,20 @@ public:
     std::shared_ptr<Stmt> body;
 };
 
+// for (x in iterable) body - pulls items one at a time from the iterable
+class ForInStmt : public Stmt, public std::enable_shared_from_this<ForInStmt> {
+public:
+    ForInStmt(Token name, std::shared_ptr<Expr> iterable, std::shared_ptr<Stmt> body)
+        : name(name), iterable(iterable), body(body) {}
+    void accept(StmtVisitor<void>& visitor) override;
+    Token name;
+    std::shared_ptr<Expr> iterable;
+    std::shared_ptr<Stmt> body;
+
+    // Sites in the body that index a list variable with the loop variable and
+    // whose bounds can be checked once for a whole range; found on the first run
+    bool indexSitesFound = false;
+    std::vector<GetExpr*> rangeIndexSites;
+};
+
 #endif // MEGALADON_AST_H
\ No newline at end of file
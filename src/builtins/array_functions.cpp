@@ -0,0 +1,231 @@
+#include "builtins.h"
+#include "../types/value.h"
+#include "../types/numeric_array.h"
+#include "../types/set_value.h"
+#include "../types/persistent_vector.h"
+#include "../types/iterable.h"
+#include "../types/tensor_value.h"
+#include "../environment/environment.h"
+#include "../util/error.h"
+#include "../util/numeric_kernels.h"
+#include "../util/symbol_table.h"
+#include <cmath> // For std::ceil, std::fmod
+
+// Reductions accept arrays directly and lists of numbers by converting them once
+static std::shared_ptr<NumericArray> toNumericArray(const MegaladonValue& value, const char* caller) {
+    if (value.isArray()) {
+        return value.asArray();
+    }
+    if (value.isList()) {
+        const auto& list = value.asList();
+        auto array = std::make_shared<NumericArray>(list.size());
+        for (size_t i = 0; i < list.size(); ++i) {
+            if (!list[i].isNumber()) {
+                throw MegaladonError(std::string(caller) + " expects an array or a list of numbers.");
+            }
+            array->values[i] = list[i].asNumber();
+        }
+        return array;
+    }
+    throw MegaladonError(std::string(caller) + " expects an array or a list of numbers.");
+}
+
+// sum/min/max/mean(tensor, [axis]) - over every element, or along one axis
+// (negative axes count from the end), which leaves a tensor of one rank less
+static MegaladonValue reduceTensor(Reduction reduction, ArgumentSpan args, const char* caller) {
+    const Tensor& tensor = *args[0].asTensor();
+    if (args.size() == 1) {
+        return MegaladonValue(tensorReduce(reduction, tensor));
+    }
+    double axis = args[1].isNumber() ? args[1].asNumber() : 0.5;
+    if (std::fmod(axis, 1.0) != 0.0) {
+        throw MegaladonError(std::string(caller) + " axis must be an integer.");
+    }
+    if (axis < 0) axis += static_cast<double>(tensor.rank());
+    if (axis < 0 || axis >= static_cast<double>(tensor.rank())) {
+        throw MegaladonError(std::string(caller) + " axis is out of range for a tensor of shape " +
+                             Tensor::shapeString(tensor.shape()) + ".");
+    }
+    if (tensor.rank() == 1) {
+        return MegaladonValue(tensorReduce(reduction, tensor));
+    }
+    return MegaladonValue(tensorReduce(reduction, tensor, static_cast<size_t>(axis)));
+}
+
+static MegaladonValue tensorToList(const Tensor& tensor) {
+    std::vector<MegaladonValue> list;
+    list.reserve(tensor.shape()[0]);
+    for (size_t i = 0; i < tensor.shape()[0]; ++i) {
+        list.push_back(tensor.rank() == 1 ? MegaladonValue(tensor.data()[i]) : tensorToList(*tensor.row(i)));
+    }
+    return MegaladonValue(std::move(list));
+}
+
+// --- Array Built-in Functions ---
+
+// array(list) - dense copy of a list of numbers
+MegaladonValue array_from(ArgumentSpan args) {
+    if (args.size() != 1) {
+        throw MegaladonError("array(list) expects one argument.");
+    }
+    if (args[0].isArray()) {
+        return MegaladonValue(std::make_shared<NumericArray>(args[0].asArray()->values));
+    }
+    return MegaladonValue(toNumericArray(args[0], "array()"));
+}
+
+// zeros(n) - array; zeros([d1, d2, ...]) - tensor of that shape
+MegaladonValue array_zeros(ArgumentSpan args) {
+    if (args.size() == 1 && args[0].isList()) {
+        std::vector<size_t> shape;
+        for (const auto& dimension : args[0].asList()) {
+            if (!dimension.isNumber() || dimension.asNumber() < 0 || std::fmod(dimension.asNumber(), 1.0) != 0.0) {
+                throw MegaladonError("zeros(shape) dimensions must be non-negative integers.");
+            }
+            shape.push_back(static_cast<size_t>(dimension.asNumber()));
+        }
+        if (shape.empty()) {
+            throw MegaladonError("zeros(shape) expects at least one dimension.");
+        }
+        return MegaladonValue(std::make_shared<Tensor>(std::move(shape)));
+    }
+    if (args.size() != 1 || !args[0].isNumber() || args[0].asNumber() < 0) {
+        throw MegaladonError("zeros(n) expects a non-negative number or a list of dimensions.");
+    }
+    return MegaladonValue(std::make_shared<NumericArray>(static_cast<size_t>(args[0].asNumber())));
+}
+
+// arange(start, stop, [step])
+MegaladonValue array_arange(ArgumentSpan args) {
+    if (args.size() < 2 || args.size() > 3 || !args[0].isNumber() || !args[1].isNumber() ||
+        (args.size() == 3 && !args[2].isNumber())) {
+        throw MegaladonError("arange(start, stop, [step]) expects numbers.");
+    }
+    double start = args[0].asNumber();
+    double stop = args[1].asNumber();
+    double step = args.size() == 3 ? args[2].asNumber() : 1.0;
+    if (step == 0.0) {
+        throw MegaladonError("arange() step must not be zero.");
+    }
+
+    double count = std::ceil((stop - start) / step);
+    auto array = std::make_shared<NumericArray>(count > 0 ? static_cast<size_t>(count) : 0);
+    for (size_t i = 0; i < array->size(); ++i) {
+        array->values[i] = start + static_cast<double>(i) * step;
+    }
+    return MegaladonValue(array);
+}
+
+// to_list(array) / to_list(set) / to_list(vector) / to_list(iterable) - sets keep insertion order;
+// to_list(tensor) gives nested lists
+MegaladonValue array_to_list(ArgumentSpan args) {
+    if (args.size() == 1 && args[0].isTensor()) {
+        return tensorToList(*args[0].asTensor());
+    }
+    if (args.size() == 1 && args[0].isSet()) {
+        return MegaladonValue(args[0].asSet()->values());
+    }
+    if (args.size() == 1 && args[0].isVector()) {
+        return MegaladonValue(args[0].asVector()->toVector());
+    }
+    if (args.size() == 1 && args[0].isIterable()) {
+        const auto& iterable = *args[0].asIterable();
+        std::vector<MegaladonValue> list;
+        size_t length;
+        if (iterable.knownLength(length)) list.reserve(length);
+        auto iterator = iterable.iterate();
+        MegaladonValue item;
+        while (iterator->next(item)) {
+            list.push_back(item);
+        }
+        return MegaladonValue(std::move(list));
+    }
+    if (args.size() != 1 || !args[0].isArray()) {
+        throw MegaladonError("to_list(array) expects one array, tensor, set, vector or iterable argument.");
+    }
+    const auto& array = *args[0].asArray();
+    std::vector<MegaladonValue> list;
+    list.reserve(array.size());
+    for (double value : array.values) {
+        list.push_back(MegaladonValue(value));
+    }
+    return MegaladonValue(std::move(list));
+}
+
+MegaladonValue array_sum(ArgumentSpan args) {
+    if (args.size() == 2 && args[0].isTensor()) return reduceTensor(Reduction::SUM, args, "sum()");
+    if (args.size() != 1) {
+        throw MegaladonError("sum() expects one argument (or a tensor and an axis).");
+    }
+    if (args[0].isTensor()) return reduceTensor(Reduction::SUM, args, "sum()");
+    auto array = toNumericArray(args[0], "sum()");
+    return MegaladonValue(kernelSum(array->data(), array->size()));
+}
+
+MegaladonValue array_min(ArgumentSpan args) {
+    if (args.size() == 2 && args[0].isTensor()) return reduceTensor(Reduction::MIN, args, "min()");
+    if (args.size() != 1) {
+        throw MegaladonError("min() expects one argument (or a tensor and an axis).");
+    }
+    if (args[0].isTensor()) return reduceTensor(Reduction::MIN, args, "min()");
+    auto array = toNumericArray(args[0], "min()");
+    if (array->size() == 0) {
+        throw MegaladonError("min() of an empty sequence.");
+    }
+    return MegaladonValue(kernelMin(array->data(), array->size()));
+}
+
+MegaladonValue array_max(ArgumentSpan args) {
+    if (args.size() == 2 && args[0].isTensor()) return reduceTensor(Reduction::MAX, args, "max()");
+    if (args.size() != 1) {
+        throw MegaladonError("max() expects one argument (or a tensor and an axis).");
+    }
+    if (args[0].isTensor()) return reduceTensor(Reduction::MAX, args, "max()");
+    auto array = toNumericArray(args[0], "max()");
+    if (array->size() == 0) {
+        throw MegaladonError("max() of an empty sequence.");
+    }
+    return MegaladonValue(kernelMax(array->data(), array->size()));
+}
+
+MegaladonValue array_mean(ArgumentSpan args) {
+    if (args.size() == 2 && args[0].isTensor()) return reduceTensor(Reduction::MEAN, args, "mean()");
+    if (args.size() != 1) {
+        throw MegaladonError("mean() expects one argument (or a tensor and an axis).");
+    }
+    if (args[0].isTensor()) return reduceTensor(Reduction::MEAN, args, "mean()");
+    auto array = toNumericArray(args[0], "mean()");
+    if (array->size() == 0) {
+        throw MegaladonError("mean() of an empty sequence.");
+    }
+    return MegaladonValue(kernelSum(array->data(), array->size()) / static_cast<double>(array->size()));
+}
+
+MegaladonValue array_dot(ArgumentSpan args) {
+    if (args.size() != 2) {
+        throw MegaladonError("dot(a, b) expects two arguments.");
+    }
+    auto a = toNumericArray(args[0], "dot()");
+    auto b = toNumericArray(args[1], "dot()");
+    if (a->size() != b->size()) {
+        throw MegaladonError("dot() operands must have the same length.");
+    }
+    return MegaladonValue(kernelDot(a->data(), b->data(), a->size()));
+}
+
+// --- Register Array Built-ins ---
+void registerArrayBuiltins(std::shared_ptr<Environment>& env) {
+    // All of these only read their arguments, so they are pure
+    auto define = [&env](const char* name, int arity, NativeFunctionBuiltin::Function function) {
+        env->define(SymbolTable::intern(name), MegaladonValue(std::make_shared<NativeFunctionBuiltin>(name, arity, function, true)));
+    };
+    define("array", 1, array_from);
+    define("zeros", 1, array_zeros);
+    define("arange", -1, array_arange);
+    define("to_list", 1, array_to_list);
+    define("sum", -1, array_sum);
+    define("min", -1, array_min);
+    define("max", -1, array_max);
+    define("mean", -1, array_mean);
+    define("dot", 2, array_dot);
+}
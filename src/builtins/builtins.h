@@ -1,9 +1,14 @@
 #pragma once
 
 #include "../types/value.h" // Ensures MegaladonCallable is fully defined BEFORE MegaladonBuiltin
+#include "../util/symbol_table.h" // For SymbolId
 #include <string>
 #include <vector>
 #include <memory> // For std::shared_ptr
+#include <unordered_map>
+#include <utility>     // For std::index_sequence
+#include <type_traits> // For std::is_void_v, std::decay_t
+#include "../util/error.h" // For MegaladonError
 
 // Forward declarations to avoid circular dependencies if needed
 class Interpreter;
@@ -21,24 +26,207 @@ protected:
     int _arity;
 };
 
-// Specific built-in functions
-class PrintBuiltin : public MegaladonBuiltin {
+// Adapts a plain function over the arguments into a callable builtin. The
+// function reads them where the caller keeps them (fastCall passes the span
+// through without copying). Functions with optional arguments use arity -1 and
+// validate the argument count themselves. Functions that call back into the
+// script (top_k with a key) take the interpreter as well. A function registered
+// as pure must be safe to call from several threads (see isPure).
+class NativeFunctionBuiltin : public MegaladonBuiltin {
 public:
-    PrintBuiltin() : MegaladonBuiltin("print", 1) {}
-    MegaladonValue call(Interpreter& interpreter, const std::vector<MegaladonValue>& arguments) override;
+    using Function = MegaladonValue (*)(ArgumentSpan arguments);
+    using CallingFunction = MegaladonValue (*)(Interpreter& interpreter, ArgumentSpan arguments);
+
+    NativeFunctionBuiltin(const std::string& name, int arity, Function function, bool pure = false)
+        : MegaladonBuiltin(name, arity), function(function), pure(pure) {}
+    NativeFunctionBuiltin(const std::string& name, int arity, CallingFunction function)
+        : MegaladonBuiltin(name, arity), callingFunction(function) {}
+    MegaladonValue call(Interpreter& interpreter, const std::vector<MegaladonValue>& arguments) override {
+        return fastCall(interpreter, ArgumentSpan(arguments.data(), arguments.size()));
+    }
+    MegaladonValue fastCall(Interpreter& interpreter, ArgumentSpan arguments) override {
+        if (callingFunction) return callingFunction(interpreter, arguments);
+        return function(arguments);
+    }
+    bool isPure() const override { return pure; }
+
+private:
+    Function function = nullptr;
+    CallingFunction callingFunction = nullptr;
+    bool pure = false;
 };
 
-class InputBuiltin : public MegaladonBuiltin {
+// --- Native Methods ---
+// A method reached with receiver.name(args); arguments[0] is the receiver and the
+// method checks the count of the rest itself. Methods that change the receiver
+// (list.add, list.sort, ...) are mutators: the interpreter hands them the
+// receiver moved out of the variable or element it lives in and stores it back
+// afterwards, so the change is made in place without copying the list.
+// Mutators that call back into the script (sort with a comparator) also get the
+// interpreter. They work on a copy of the receiver, which the script can still
+// read (and change) where it lives while they run; the result then replaces it.
+struct NativeMethod {
+    using Reader = MegaladonValue (*)(const std::vector<MegaladonValue>& arguments);
+    using Mutator = MegaladonValue (*)(std::vector<MegaladonValue>& arguments);
+    using CallingMutator = MegaladonValue (*)(Interpreter& interpreter, std::vector<MegaladonValue>& arguments);
+
+    // Exactly one of these is set
+    Reader read = nullptr;
+    Mutator mutate = nullptr;
+    CallingMutator callingMutate = nullptr;
+
+    bool mutates() const { return mutate != nullptr || callingMutate != nullptr; }
+    bool callsScript() const { return callingMutate != nullptr; }
+    MegaladonValue call(Interpreter& interpreter, std::vector<MegaladonValue>& arguments) const {
+        if (callingMutate) return callingMutate(interpreter, arguments);
+        return mutate ? mutate(arguments) : read(arguments);
+    }
+};
+
+// The methods of one value type, keyed on interned method names. Entries are
+// never removed, so pointers to them stay valid for call-site caches.
+class MethodTable {
 public:
-    InputBuiltin() : MegaladonBuiltin("input", 0) {} // Assuming input takes no args directly, or one prompt arg
-    MegaladonValue call(Interpreter& interpreter, const std::vector<MegaladonValue>& arguments) override;
+    void define(const char* name, NativeMethod::Reader read);
+    void define(const char* name, NativeMethod::Mutator mutate);
+    void define(const char* name, NativeMethod::CallingMutator mutate);
+    const NativeMethod* find(SymbolId name) const; // nullptr if there is no such method
+
+private:
+    std::unordered_map<SymbolId, NativeMethod> methods;
+};
+
+// Table for values of 'type'; types without methods get an empty table.
+// The tables are built once, on first use.
+const MethodTable& methodsFor(ValueType type);
+
+// String methods: len, substring, to_lower, to_upper, trim, split, ... (string_methods.cpp)
+void registerStringMethods(MethodTable& table);
+
+// List methods: add, insert_at, remove_at, remove, pop, get, set, clear,
+// sort, sort_stable, sort_by, index_of, contains (list_methods.cpp)
+void registerListMethods(MethodTable& table);
+// --- End Native Methods ---
+
+// --- Typed Natives ---
+// How a typed native's parameter is read from an argument. Reads are checked and
+// name the builtin and argument position in the error.
+template <typename T>
+struct NativeArgument;
+
+template <>
+struct NativeArgument<MegaladonValue> {
+    static const MegaladonValue& from(const MegaladonValue& value, const std::string&, size_t) { return value; }
+};
+
+template <>
+struct NativeArgument<double> {
+    static double from(const MegaladonValue& value, const std::string& name, size_t position) {
+        if (!value.isNumber()) throw argumentError(name, position, "a number");
+        return value.asNumber();
+    }
+    static MegaladonError argumentError(const std::string& name, size_t position, const char* expected) {
+        return MegaladonError(name + "() argument " + std::to_string(position + 1) + " must be " + expected + ".");
+    }
+};
+
+template <>
+struct NativeArgument<bool> {
+    static bool from(const MegaladonValue& value, const std::string& name, size_t position) {
+        if (!value.isBoolean()) throw NativeArgument<double>::argumentError(name, position, "a boolean");
+        return value.asBoolean();
+    }
+};
+
+template <>
+struct NativeArgument<MegaladonString> {
+    static const MegaladonString& from(const MegaladonValue& value, const std::string& name, size_t position) {
+        if (!value.isString()) throw NativeArgument<double>::argumentError(name, position, "a string");
+        return value.asString();
+    }
 };
 
-class LenBuiltin : public MegaladonBuiltin {
+// Adapts 'Function', a plain C++ function 'Result f(Interpreter&, Params...)',
+// into a builtin. The arity comes from the signature and the parameters are
+// unpacked from the argument span at compile time, so calling it through
+// fastCall builds no vector. A void result becomes VOID.
+template <auto Function>
+class TypedBuiltin;
+
+template <typename Result, typename... Params, Result (*Function)(Interpreter&, Params...)>
+class TypedBuiltin<Function> : public MegaladonBuiltin {
 public:
-    LenBuiltin() : MegaladonBuiltin("len", 1) {}
-    MegaladonValue call(Interpreter& interpreter, const std::vector<MegaladonValue>& arguments) override;
+    explicit TypedBuiltin(const std::string& name) : MegaladonBuiltin(name, static_cast<int>(sizeof...(Params))) {}
+
+    MegaladonValue call(Interpreter& interpreter, const std::vector<MegaladonValue>& arguments) override {
+        if (arguments.size() != sizeof...(Params)) {
+            throw MegaladonError(name + "() expects " + std::to_string(sizeof...(Params)) + " arguments but got " +
+                                 std::to_string(arguments.size()) + ".");
+        }
+        return fastCall(interpreter, ArgumentSpan(arguments.data(), arguments.size()));
+    }
+
+    MegaladonValue fastCall(Interpreter& interpreter, ArgumentSpan arguments) override {
+        return invoke(interpreter, arguments, std::index_sequence_for<Params...>());
+    }
+
+private:
+    template <size_t... Index>
+    MegaladonValue invoke(Interpreter& interpreter, ArgumentSpan arguments, std::index_sequence<Index...>) {
+        (void)arguments; // Unused by natives without parameters
+        if constexpr (std::is_void_v<Result>) {
+            Function(interpreter, NativeArgument<std::decay_t<Params>>::from(arguments[Index], name, Index)...);
+            return MegaladonValue();
+        } else {
+            return MegaladonValue(Function(interpreter, NativeArgument<std::decay_t<Params>>::from(arguments[Index], name, Index)...));
+        }
+    }
 };
+// --- End Typed Natives ---
 
 // Forward declaration for the registration function
-void registerBuiltins(std::shared_ptr<Environment>& env);
\ No newline at end of file
+void registerBuiltins(std::shared_ptr<Environment>& env);
+
+// Writes 'value' and a newline to the buffered standard output (print and the
+// print statement; see OutputBuffer)
+void printLine(const MegaladonValue& value);
+
+// A new empty map tracked by the interpreter's heap, like the ones map literals
+// make. Maps come from the global heap, not the interpreter's pool: pure natives
+// read them, and can drop the last reference to them, on ThreadPool workers.
+std::shared_ptr<MegaladonMap> newMap(Interpreter& interpreter);
+
+// Numeric array constructors and reductions (array_functions.cpp)
+void registerArrayBuiltins(std::shared_ptr<Environment>& env);
+
+// Map lookups and updates: get, get_all, set, has, remove, keys (map_functions.cpp).
+// has and remove also accept sets.
+void registerMapBuiltins(std::shared_ptr<Environment>& env);
+
+// Set construction and algebra: to_set, add, union, intersection, difference (set_functions.cpp)
+void registerSetBuiltins(std::shared_ptr<Environment>& env);
+
+// Lazy sequences for for-in loops: range, chars, lines, view, read_lines,
+// read_records (iterable_functions.cpp)
+void registerIterableBuiltins(std::shared_ptr<Environment>& env);
+
+// Persistent vectors: vec, push, assoc (vector_functions.cpp)
+void registerVectorBuiltins(std::shared_ptr<Environment>& env);
+
+// Binary buffers: bytes, read_bytes, unpack, pack, find, decode (bytes_functions.cpp)
+void registerBytesBuiltins(std::shared_ptr<Environment>& env);
+
+// Dense tensors: tensor, reshape, shape, matmul, transpose (tensor_functions.cpp)
+void registerTensorBuiltins(std::shared_ptr<Environment>& env);
+
+// Selection without a full sort: top_k, nth, partition (selection_functions.cpp)
+void registerSelectionBuiltins(std::shared_ptr<Environment>& env);
+
+// Higher-order sequence builtins: map, filter, reduce, any, all, zip (collection_functions.cpp)
+void registerCollectionBuiltins(std::shared_ptr<Environment>& env);
+
+// Chunked file processing: map_file, map_file_stats (file_functions.cpp)
+void registerFileBuiltins(std::shared_ptr<Environment>& env);
+
+// JSON: json_parse, json_get, json_stringify (json_functions.cpp)
+void registerJsonBuiltins(std::shared_ptr<Environment>& env);
\ No newline at end of file
@@ -0,0 +1,139 @@
+#include "builtins.h"
+#include "../types/value.h"
+#include "../types/bytes_value.h"
+#include "../environment/environment.h"
+#include "../util/error.h"
+#include "../util/symbol_table.h"
+#include <cmath> // For std::fmod
+
+static const MegaladonBytes& bytesArgument(ArgumentSpan args, const char* usage) {
+    if (args.empty() || !args[0].isBytes()) {
+        throw MegaladonError(std::string(usage) + " expects bytes as its first argument.");
+    }
+    return args[0].asBytes();
+}
+
+static size_t offsetArgument(const MegaladonValue& value, const char* usage) {
+    double number = value.isNumber() ? value.asNumber() : -1.0;
+    // The range test also rejects NaN and infinities, and keeps the cast below defined
+    if (!(number >= 0 && number < 9.0e18) || std::fmod(number, 1.0) != 0.0) {
+        throw MegaladonError(std::string(usage) + " offset must be a non-negative integer below 9e18.");
+    }
+    return static_cast<size_t>(number);
+}
+
+// Parses the format and checks that it fits at 'offset'
+static MegaladonBytes::NumberFormat formatArgument(const MegaladonBytes& bytes, size_t offset, const MegaladonValue& value, const char* usage) {
+    MegaladonBytes::NumberFormat format;
+    if (!value.isString() || !MegaladonBytes::parseFormat(value.asString().view(), format)) {
+        throw MegaladonError(std::string(usage) + " format must be one of u8, i8, u16, i16, u32, i32, u64, i64, f32, f64, "
+                             "optionally followed by 'le' or 'be'.");
+    }
+    if (offset > bytes.size() || bytes.size() - offset < format.width) {
+        throw MegaladonError(std::string(usage) + " reads past the end of the bytes.");
+    }
+    return format;
+}
+
+// --- Bytes Built-in Functions ---
+
+// bytes(length) - zero-filled; bytes(string) / bytes(list of 0..255) - copies
+MegaladonValue bytes_new(ArgumentSpan args) {
+    if (args.size() != 1) {
+        throw MegaladonError("bytes(length | string | list) expects one argument.");
+    }
+    const MegaladonValue& source = args[0];
+    if (source.isNumber()) {
+        return MegaladonValue(MegaladonBytes(offsetArgument(source, "bytes()")));
+    }
+    if (source.isString()) {
+        return MegaladonValue(MegaladonBytes::copyOf(source.asString().view()));
+    }
+    if (source.isList()) {
+        const auto& list = source.asList();
+        MegaladonBytes bytes(list.size());
+        for (size_t i = 0; i < list.size(); ++i) {
+            if (!list[i].isNumber() || list[i].asNumber() < 0 || list[i].asNumber() > 255 || std::fmod(list[i].asNumber(), 1.0) != 0.0) {
+                throw MegaladonError("bytes() list elements must be integers from 0 to 255.");
+            }
+            bytes.data()[i] = static_cast<uint8_t>(list[i].asNumber());
+        }
+        return MegaladonValue(bytes);
+    }
+    throw MegaladonError("bytes() expects a length, a string or a list of byte values.");
+}
+
+// read_bytes(path) - maps the file instead of copying it
+MegaladonValue bytes_read_file(ArgumentSpan args) {
+    if (args.size() != 1 || !args[0].isString()) {
+        throw MegaladonError("read_bytes(path) expects a file path.");
+    }
+    return MegaladonValue(MegaladonBytes::mapFile(args[0].asString().str()));
+}
+
+// unpack(bytes, offset, format) - e.g. unpack(header, 4, "u32be")
+MegaladonValue bytes_unpack(ArgumentSpan args) {
+    if (args.size() != 3) {
+        throw MegaladonError("unpack(bytes, offset, format) expects three arguments.");
+    }
+    const MegaladonBytes& bytes = bytesArgument(args, "unpack()");
+    size_t offset = offsetArgument(args[1], "unpack()");
+    return MegaladonValue(bytes.read(offset, formatArgument(bytes, offset, args[2], "unpack()")));
+}
+
+// pack(bytes, offset, format, value) - writes in place, returns the value
+MegaladonValue bytes_pack(ArgumentSpan args) {
+    if (args.size() != 4 || !args[3].isNumber()) {
+        throw MegaladonError("pack(bytes, offset, format, value) expects bytes, an offset, a format and a number.");
+    }
+    const MegaladonBytes& bytes = bytesArgument(args, "pack()");
+    size_t offset = offsetArgument(args[1], "pack()");
+    bytes.write(offset, formatArgument(bytes, offset, args[2], "pack()"), args[3].asNumber());
+    return args[3];
+}
+
+// find(haystack, needle, [from]) - index of the first match, or -1.
+// Works on bytes (with a bytes or string needle) and on strings.
+MegaladonValue bytes_find(ArgumentSpan args) {
+    if (args.size() < 2 || args.size() > 3) {
+        throw MegaladonError("find(haystack, needle, [from]) expects two or three arguments.");
+    }
+    size_t from = args.size() == 3 ? offsetArgument(args[2], "find()") : 0;
+    const MegaladonValue& needle = args[1];
+    if (!needle.isBytes() && !needle.isString()) {
+        throw MegaladonError("find() needle must be bytes or a string.");
+    }
+    std::string_view needleView = needle.isBytes() ? needle.asBytes().view() : needle.asString().view();
+
+    size_t position;
+    if (args[0].isBytes()) {
+        position = args[0].asBytes().find(needleView, from);
+    } else if (args[0].isString()) {
+        std::string_view haystack = args[0].asString().view();
+        position = from > haystack.size() ? std::string_view::npos : haystack.find(needleView, from);
+    } else {
+        throw MegaladonError("find() expects bytes or a string to search in.");
+    }
+    return MegaladonValue(position == std::string_view::npos ? -1.0 : static_cast<double>(position));
+}
+
+// decode(bytes) - string with a copy of the bytes (strings are immutable, bytes are not)
+MegaladonValue bytes_decode(ArgumentSpan args) {
+    if (args.size() != 1) {
+        throw MegaladonError("decode(bytes) expects one argument.");
+    }
+    return MegaladonValue(MegaladonString(bytesArgument(args, "decode()").view()));
+}
+
+// --- Register Bytes Built-ins ---
+void registerBytesBuiltins(std::shared_ptr<Environment>& env) {
+    auto define = [&env](const char* name, int arity, NativeFunctionBuiltin::Function function) {
+        env->define(SymbolTable::intern(name), MegaladonValue(std::make_shared<NativeFunctionBuiltin>(name, arity, function)));
+    };
+    define("bytes", 1, bytes_new);
+    define("read_bytes", 1, bytes_read_file);
+    define("unpack", 3, bytes_unpack);
+    define("pack", 4, bytes_pack);
+    define("find", -1, bytes_find);
+    define("decode", 1, bytes_decode);
+}
@@ -0,0 +1,223 @@
+#include "builtins.h"
+#include "../types/value.h"
+#include "../types/iterable.h"
+#include "../environment/environment.h"
+#include "../util/error.h"
+#include "../util/symbol_table.h"
+#include "../util/thread_pool.h"
+#include <algorithm> // For std::min
+
+// --- Higher-Order Built-in Functions ---
+// Each of these calls the script's function from one native loop through
+// fastCall, with the argument read in place from the input, instead of running
+// a script loop that builds the result one add() at a time. Outputs are
+// allocated once at their final size.
+//
+// map and filter take an optional 'parallel' flag. When the function is pure
+// (see MegaladonCallable::isPure) and the input is long, the calls are split
+// across the shared thread pool. Script functions are never pure, since the
+// interpreter is single-threaded; for them the flag is ignored.
+
+// Inputs shorter than this are not worth waking the pool for
+constexpr size_t PARALLEL_CALLS_MIN = 4096;
+constexpr size_t PARALLEL_CALLS_GRAIN = 1024;
+
+// The items of a list, or of any other iterable value collected into 'collected'
+static const std::vector<MegaladonValue>& itemsOf(const MegaladonValue& value, std::vector<MegaladonValue>& collected,
+                                                  const char* caller) {
+    if (value.isList()) return value.asList();
+    auto iterator = iterateValue(value);
+    if (!iterator) {
+        throw MegaladonError(std::string(caller) + " expects a list or another iterable value.");
+    }
+    size_t length = 0;
+    if (value.isIterable() && value.asIterable()->knownLength(length)) collected.reserve(length);
+    MegaladonValue item;
+    while (iterator->next(item)) {
+        collected.push_back(item);
+    }
+    return collected;
+}
+
+static std::shared_ptr<MegaladonCallable> functionArgument(const MegaladonValue& value, int arity, const char* caller) {
+    if (!value.isFunction()) {
+        throw MegaladonError(std::string(caller) + " expects a function.");
+    }
+    std::shared_ptr<MegaladonCallable> function = value.asCallable();
+    if (function->arity() != arity && function->arity() != -1) {
+        throw MegaladonError(std::string(caller) + " expects a function of " + std::to_string(arity) +
+                             (arity == 1 ? " argument." : " arguments."));
+    }
+    return function;
+}
+
+// Whether args[index], the optional parallel flag, asks for parallel calls and they are safe
+static bool runInParallel(ArgumentSpan args, size_t index, const MegaladonCallable& function,
+                          size_t count, const char* caller) {
+    if (args.size() <= index) return false;
+    if (!args[index].isBoolean()) {
+        throw MegaladonError(std::string(caller) + " parallel flag must be a boolean.");
+    }
+    return args[index].asBoolean() && function.isPure() && count >= PARALLEL_CALLS_MIN;
+}
+
+// Same rule as if and while conditions
+static bool isTruthy(const MegaladonValue& value) {
+    if (value.isVoid()) return false;
+    if (value.isBoolean()) return value.asBoolean();
+    return true;
+}
+
+// map(items, function, [parallel]) - list of function(item) for each item
+static MegaladonValue collection_map(Interpreter& interpreter, ArgumentSpan args) {
+    if (args.size() < 2 || args.size() > 3) {
+        throw MegaladonError("map(items, function, [parallel]) expects two or three arguments.");
+    }
+    std::vector<MegaladonValue> collected;
+    const auto& items = itemsOf(args[0], collected, "map()");
+    auto function = functionArgument(args[1], 1, "map()");
+
+    std::vector<MegaladonValue> results(items.size());
+    auto apply = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            results[i] = function->fastCall(interpreter, ArgumentSpan(&items[i], 1));
+        }
+    };
+    if (runInParallel(args, 2, *function, items.size(), "map()")) {
+        ThreadPool::shared().parallelFor(items.size(), PARALLEL_CALLS_GRAIN, apply);
+    } else {
+        apply(0, items.size());
+    }
+    return MegaladonValue(std::move(results));
+}
+
+// filter(items, predicate, [parallel]) - the items for which predicate(item) is true, in order
+static MegaladonValue collection_filter(Interpreter& interpreter, ArgumentSpan args) {
+    if (args.size() < 2 || args.size() > 3) {
+        throw MegaladonError("filter(items, predicate, [parallel]) expects two or three arguments.");
+    }
+    std::vector<MegaladonValue> collected;
+    const auto& items = itemsOf(args[0], collected, "filter()");
+    auto predicate = functionArgument(args[1], 1, "filter()");
+
+    // Decide every item first, so the result can be allocated at its exact size
+    std::vector<unsigned char> keep(items.size());
+    auto test = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            keep[i] = isTruthy(predicate->fastCall(interpreter, ArgumentSpan(&items[i], 1)));
+        }
+    };
+    if (runInParallel(args, 2, *predicate, items.size(), "filter()")) {
+        ThreadPool::shared().parallelFor(items.size(), PARALLEL_CALLS_GRAIN, test);
+    } else {
+        test(0, items.size());
+    }
+
+    size_t kept = 0;
+    for (unsigned char flag : keep) kept += flag;
+    std::vector<MegaladonValue> results;
+    results.reserve(kept);
+    for (size_t i = 0; i < items.size(); ++i) {
+        if (keep[i]) results.push_back(items[i]);
+    }
+    return MegaladonValue(std::move(results));
+}
+
+// reduce(items, function, [initial]) - folds the items from the left with
+// function(accumulator, item); without 'initial' the first item starts the fold
+static MegaladonValue collection_reduce(Interpreter& interpreter, ArgumentSpan args) {
+    if (args.size() < 2 || args.size() > 3) {
+        throw MegaladonError("reduce(items, function, [initial]) expects two or three arguments.");
+    }
+    std::vector<MegaladonValue> collected;
+    const auto& items = itemsOf(args[0], collected, "reduce()");
+    auto function = functionArgument(args[1], 2, "reduce()");
+
+    size_t start = 0;
+    MegaladonValue pair[2];
+    if (args.size() == 3) {
+        pair[0] = args[2];
+    } else if (!items.empty()) {
+        pair[0] = items[0];
+        start = 1;
+    } else {
+        throw MegaladonError("reduce() of an empty sequence needs an initial value.");
+    }
+    for (size_t i = start; i < items.size(); ++i) {
+        pair[1] = items[i];
+        pair[0] = function->fastCall(interpreter, ArgumentSpan(pair, 2));
+    }
+    return pair[0];
+}
+
+// Shared by any and all: finds the first item whose truth (of predicate(item),
+// if given) is 'wanted'
+static bool findTruth(Interpreter& interpreter, ArgumentSpan args, bool wanted, const char* caller) {
+    std::vector<MegaladonValue> collected;
+    const auto& items = itemsOf(args[0], collected, caller);
+    if (args.size() == 1) {
+        for (const auto& item : items) {
+            if (isTruthy(item) == wanted) return true;
+        }
+        return false;
+    }
+    auto predicate = functionArgument(args[1], 1, caller);
+    for (const auto& item : items) {
+        if (isTruthy(predicate->fastCall(interpreter, ArgumentSpan(&item, 1))) == wanted) return true;
+    }
+    return false;
+}
+
+// any(items, [predicate]) - whether some item (or predicate(item)) is true; stops at the first
+static MegaladonValue collection_any(Interpreter& interpreter, ArgumentSpan args) {
+    if (args.empty() || args.size() > 2) {
+        throw MegaladonError("any(items, [predicate]) expects one or two arguments.");
+    }
+    return MegaladonValue(findTruth(interpreter, args, true, "any()"));
+}
+
+// all(items, [predicate]) - whether every item (or predicate(item)) is true; stops at the first false
+static MegaladonValue collection_all(Interpreter& interpreter, ArgumentSpan args) {
+    if (args.empty() || args.size() > 2) {
+        throw MegaladonError("all(items, [predicate]) expects one or two arguments.");
+    }
+    return MegaladonValue(!findTruth(interpreter, args, false, "all()"));
+}
+
+// zip(a, b, ...) - list of [a[i], b[i], ...], as long as the shortest input
+static MegaladonValue collection_zip(ArgumentSpan args) {
+    if (args.empty()) {
+        throw MegaladonError("zip(items, ...) expects at least one argument.");
+    }
+    std::vector<std::vector<MegaladonValue>> collected(args.size());
+    std::vector<const std::vector<MegaladonValue>*> inputs;
+    inputs.reserve(args.size());
+    size_t length = static_cast<size_t>(-1);
+    for (size_t i = 0; i < args.size(); ++i) {
+        inputs.push_back(&itemsOf(args[i], collected[i], "zip()"));
+        length = std::min(length, inputs.back()->size());
+    }
+
+    std::vector<MegaladonValue> results;
+    results.reserve(length);
+    for (size_t i = 0; i < length; ++i) {
+        std::vector<MegaladonValue> tuple;
+        tuple.reserve(inputs.size());
+        for (const auto* input : inputs) tuple.push_back((*input)[i]);
+        results.push_back(MegaladonValue(std::move(tuple)));
+    }
+    return MegaladonValue(std::move(results));
+}
+
+// --- Register Higher-Order Built-in Functions ---
+void registerCollectionBuiltins(std::shared_ptr<Environment>& env) {
+    auto define = [&env](const char* name, NativeFunctionBuiltin::CallingFunction function) {
+        env->define(SymbolTable::intern(name), MegaladonValue(std::make_shared<NativeFunctionBuiltin>(name, -1, function)));
+    };
+    define("map", collection_map);
+    define("filter", collection_filter);
+    define("reduce", collection_reduce);
+    define("any", collection_any);
+    define("all", collection_all);
+    env->define(SymbolTable::intern("zip"), MegaladonValue(std::make_shared<NativeFunctionBuiltin>("zip", -1, collection_zip, true)));
+}
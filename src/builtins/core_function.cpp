@@ -1,60 +1,149 @@
 #include "builtins.h"
 #include "../types/value.h"
+#include "../types/numeric_array.h"
+#include "../types/map_value.h"
+#include "../types/set_value.h"
+#include "../types/iterable.h"
+#include "../types/persistent_vector.h"
+#include "../types/tensor_value.h"
 #include "../interpreter/interpreter.h" // For Interpreter access in call methods
+#include "../util/symbol_table.h" // For SymbolTable::intern
+#include "../util/number_format.h" // For MAX_NUMBER_PRECISION
+#include "../util/output_buffer.h"
+#include "../util/error.h"
 #include <iostream>
 #include <string>
 #include <cmath> // For std::fmod
 
-// --- PrintBuiltin ---
-MegaladonValue PrintBuiltin::call(Interpreter& interpreter, const std::vector<MegaladonValue>& arguments) {
-    // Suppress unused parameter warning for 'interpreter'
-    (void)interpreter;
+// --- Core Built-in Functions ---
+// Registered through TypedBuiltin, so the interpreter calls them on its fast path
 
-    if (arguments.empty()) {
-        std::cout << "void\n"; // Changed from VOID to 'void' string
-    } else {
-        std::cout << arguments[0].toString() << "\n";
+// Shared by print() and the print statement: formats the value into the
+// output buffer, except that long strings are handed to it as they are
+void printLine(const MegaladonValue& value) {
+    OutputBuffer& out = OutputBuffer::standardOutput();
+    if (value.isString()) {
+        out.writeLine(value.asString().view());
+        return;
     }
-    return MegaladonValue(); // VOID
+    out.appendLine([&value](std::string& text) { value.appendTo(text); });
+}
+
+std::shared_ptr<MegaladonMap> newMap(Interpreter& interpreter) {
+    auto map = std::make_shared<MegaladonMap>();
+    interpreter.heap.track(map);
+    return map;
 }
 
-// --- InputBuiltin ---
-MegaladonValue InputBuiltin::call(Interpreter& interpreter, const std::vector<MegaladonValue>& arguments) {
-    // Suppress unused parameter warnings
+// print(value)
+static void builtin_print(Interpreter& interpreter, const MegaladonValue& value) {
     (void)interpreter;
-    // You might want to use arguments[0] as a prompt if provided
-    if (arguments.size() > 0 && arguments[0].isString()) {
-        std::cout << arguments[0].asString();
-    }
+    printLine(value);
+}
 
+// flush() - writes buffered print output now
+static void builtin_flush(Interpreter& interpreter) {
+    (void)interpreter;
+    OutputBuffer::standardOutput().flush();
+}
+
+// input() - one line from standard input
+static MegaladonValue builtin_input(Interpreter& interpreter) {
+    (void)interpreter;
+    OutputBuffer::standardOutput().flush(); // Show what was printed before waiting
     std::string line;
     std::getline(std::cin, line);
     return MegaladonValue(line);
 }
 
-// --- LenBuiltin ---
-MegaladonValue LenBuiltin::call(Interpreter& interpreter, const std::vector<MegaladonValue>& arguments) {
-    // Suppress unused parameter warning for 'interpreter'
+// len(value)
+static double builtin_len(Interpreter& interpreter, const MegaladonValue& arg) {
     (void)interpreter;
-
-    if (arguments.size() != 1) {
-        throw std::runtime_error("MegaladonError: len() expects 1 argument.");
-    }
-
-    const MegaladonValue& arg = arguments[0];
     if (arg.isString()) {
-        return MegaladonValue(static_cast<double>(arg.asString().length()));
+        return static_cast<double>(arg.asString().length());
     } else if (arg.isList()) {
-        return MegaladonValue(static_cast<double>(arg.asList().size()));
+        return static_cast<double>(arg.asList().size());
+    } else if (arg.isArray()) {
+        return static_cast<double>(arg.asArray()->size());
+    } else if (arg.isMap()) {
+        return static_cast<double>(arg.asMap()->size());
+    } else if (arg.isSet()) {
+        return static_cast<double>(arg.asSet()->size());
+    } else if (arg.isBytes()) {
+        return static_cast<double>(arg.asBytes().size());
+    } else if (arg.isVector()) {
+        return static_cast<double>(arg.asVector()->size());
+    } else if (arg.isTensor()) {
+        const auto& shape = arg.asTensor()->shape();
+        return static_cast<double>(shape.empty() ? 1 : shape[0]);
+    } else if (arg.isIterable()) {
+        size_t length;
+        if (!arg.asIterable()->knownLength(length)) {
+            throw std::runtime_error("MegaladonError: len() of " + arg.toString() + " is not known without iterating it.");
+        }
+        return static_cast<double>(length);
     } else {
-        throw std::runtime_error("MegaladonError: len() argument must be a string or a list.");
+        throw std::runtime_error("MegaladonError: len() argument must be a string, a list, an array, a map, a set, a vector, bytes, a tensor or an iterable.");
+    }
+}
+
+// gc_collect() runs a full collection and returns the number of objects freed
+static double builtin_gc_collect(Interpreter& interpreter) {
+    return static_cast<double>(interpreter.heap.collectMajor());
+}
+
+// gc_stats() returns a one-line summary of heap size and pause times
+static std::string builtin_gc_stats(Interpreter& interpreter) {
+    return interpreter.heap.stats().toString();
+}
+
+// memory_stats() returns bytes in use per size class of the interpreter's pool
+static std::string builtin_memory_stats(Interpreter& interpreter) {
+    return interpreter.pool->statsString();
+}
+
+// str(value, [digits]) - the text print would show; with digits, every number in
+// the value is written with exactly that many digits after the point
+static MegaladonValue core_str(ArgumentSpan arguments) {
+    if (arguments.empty() || arguments.size() > 2) {
+        throw MegaladonError("str(value, [digits]) expects one or two arguments.");
+    }
+    int precision = -1;
+    if (arguments.size() == 2) {
+        const MegaladonValue& digits = arguments[1];
+        if (!digits.isNumber() || digits.asNumber() < 0 || digits.asNumber() > MAX_NUMBER_PRECISION ||
+            std::fmod(digits.asNumber(), 1.0) != 0.0) {
+            throw MegaladonError("str() digits must be an integer from 0 to " + std::to_string(MAX_NUMBER_PRECISION) + ".");
+        }
+        precision = static_cast<int>(digits.asNumber());
     }
+    if (arguments[0].isString()) return arguments[0];
+    std::string text;
+    arguments[0].appendTo(text, precision);
+    return MegaladonValue(std::move(text));
 }
 
 // --- Register Built-ins ---
 void registerBuiltins(std::shared_ptr<Environment>& env) {
-    env->define("print", MegaladonValue(std::make_shared<PrintBuiltin>()));
-    env->define("input", MegaladonValue(std::make_shared<InputBuiltin>()));
-    env->define("len", MegaladonValue(std::make_shared<LenBuiltin>()));
+    // Builtins are keyed by the same interned ids the lexer assigns to identifiers
+    env->define(SymbolTable::intern("print"), MegaladonValue(std::make_shared<TypedBuiltin<builtin_print>>("print")));
+    env->define(SymbolTable::intern("flush"), MegaladonValue(std::make_shared<TypedBuiltin<builtin_flush>>("flush")));
+    env->define(SymbolTable::intern("input"), MegaladonValue(std::make_shared<TypedBuiltin<builtin_input>>("input")));
+    env->define(SymbolTable::intern("len"), MegaladonValue(std::make_shared<TypedBuiltin<builtin_len>>("len")));
+    env->define(SymbolTable::intern("str"), MegaladonValue(std::make_shared<NativeFunctionBuiltin>("str", -1, core_str, true)));
+    env->define(SymbolTable::intern("gc_collect"), MegaladonValue(std::make_shared<TypedBuiltin<builtin_gc_collect>>("gc_collect")));
+    env->define(SymbolTable::intern("gc_stats"), MegaladonValue(std::make_shared<TypedBuiltin<builtin_gc_stats>>("gc_stats")));
+    env->define(SymbolTable::intern("memory_stats"), MegaladonValue(std::make_shared<TypedBuiltin<builtin_memory_stats>>("memory_stats")));
+    registerArrayBuiltins(env);
+    registerMapBuiltins(env);
+    registerSetBuiltins(env);
+    registerIterableBuiltins(env);
+    registerVectorBuiltins(env);
+    registerBytesBuiltins(env);
+    registerTensorBuiltins(env);
+    registerSelectionBuiltins(env);
+    registerCollectionBuiltins(env);
+    registerFileBuiltins(env);
+    registerJsonBuiltins(env);
     // Add other built-in functions here
 }
\ No newline at end of file
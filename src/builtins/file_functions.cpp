@@ -0,0 +1,191 @@
+#include "builtins.h"
+#include "../types/value.h"
+#include "../types/file_records.h"
+#include "../environment/environment.h"
+#include "../util/error.h"
+#include "../util/symbol_table.h"
+#include "../util/thread_pool.h"
+#include <algorithm> // For std::min, std::max
+#include <chrono>
+#include <cstdio>    // For std::snprintf
+
+// --- Chunked File Built-in Functions ---
+// map_file splits a file into chunks that end on record boundaries, hands each
+// chunk's records to a mapper and folds the mapper's results, in file order,
+// with a reducer.
+//
+// A wave of chunks is read at a time. Splitting the chunks into records is
+// native work and runs on the shared thread pool, one chunk per task. A pure
+// mapper (see MegaladonCallable::isPure) runs in the same tasks. A script
+// mapper runs on the calling interpreter, one chunk after another, because the
+// interpreter is single-threaded (see ThreadPool). The reducer always does.
+
+// Chunks are cut at the first record boundary after this many bytes
+constexpr size_t MAP_FILE_CHUNK = size_t(4) << 20;
+// At most this many chunks (and their records) are held at once
+constexpr size_t MAP_FILE_MAX_WAVE = 16;
+
+namespace {
+// Counters of one map_file call, read by map_file_stats(); a reducer can call
+// it to report progress while the call runs
+struct MapFileProgress {
+    size_t chunks = 0;
+    size_t records = 0;
+    size_t bytes = 0;
+    size_t totalBytes = 0; // 0 when the input is not a regular file
+    bool running = false;
+    std::chrono::steady_clock::time_point started;
+    std::chrono::steady_clock::time_point stopped;
+
+    std::string toString() const {
+        if (started == std::chrono::steady_clock::time_point()) return "map_file: not run";
+        auto end = running ? std::chrono::steady_clock::now() : stopped;
+        double seconds = std::chrono::duration<double>(end - started).count();
+        double megabytes = static_cast<double>(bytes) / (1024.0 * 1024.0);
+        char size[64];
+        if (totalBytes > 0) {
+            std::snprintf(size, sizeof(size), "%.1f of %.1f MB (%.0f%%)", megabytes,
+                          static_cast<double>(totalBytes) / (1024.0 * 1024.0),
+                          100.0 * static_cast<double>(bytes) / static_cast<double>(totalBytes));
+        } else {
+            std::snprintf(size, sizeof(size), "%.1f MB", megabytes);
+        }
+        char buffer[256];
+        std::snprintf(buffer, sizeof(buffer), "map_file: %s, %zu chunks, %zu records, %s, %.3f s, %.1f MB/s",
+                      running ? "running" : "done", chunks, records, size, seconds, seconds > 0 ? megabytes / seconds : 0.0);
+        return buffer;
+    }
+};
+
+// What map_file_stats() reports: the innermost map_file call still running
+// (a reducer may call map_file itself), or else the call that finished last
+std::shared_ptr<MapFileProgress> latestProgress;
+
+// The counters of one map_file call, published as the latest while it runs;
+// marks the run finished however map_file leaves
+struct ProgressRun {
+    std::shared_ptr<MapFileProgress> progress = std::make_shared<MapFileProgress>();
+    std::shared_ptr<MapFileProgress> enclosing = latestProgress;
+
+    ProgressRun() {
+        progress->running = true;
+        progress->started = std::chrono::steady_clock::now();
+        latestProgress = progress;
+    }
+    ~ProgressRun() {
+        progress->running = false;
+        progress->stopped = std::chrono::steady_clock::now();
+        if (enclosing && enclosing->running) latestProgress = enclosing; // Back to the call that is still going
+    }
+};
+
+// One chunk of the current wave
+struct Chunk {
+    std::shared_ptr<const char> owner;
+    std::string_view text;
+    MegaladonValue value; // The records, then the mapper's result
+    size_t records = 0;
+};
+} // namespace
+
+static std::shared_ptr<MegaladonCallable> functionArgument(const MegaladonValue& value, int arity, const char* role) {
+    if (!value.isFunction()) {
+        throw MegaladonError(std::string("map_file() ") + role + " must be a function.");
+    }
+    std::shared_ptr<MegaladonCallable> function = value.asCallable();
+    if (function->arity() != arity && function->arity() != -1) {
+        throw MegaladonError(std::string("map_file() ") + role + " must take " + std::to_string(arity) +
+                             (arity == 1 ? " argument." : " arguments."));
+    }
+    return function;
+}
+
+// map_file(path, mapper, reducer, [initial], [delimiter]) - reducer(accumulator,
+// mapper(records)) over the file's chunks in order. Without 'initial' the first
+// chunk's result starts the fold, and a file with no records gives void.
+// Records are lines unless a delimiter is given; "-" reads standard input.
+// Only native work runs in parallel: splitting chunks into records, and pure
+// (native) mappers. Script mappers and reducers run serially on the calling
+// interpreter; running them on workers with interpreters of their own is not
+// implemented.
+static MegaladonValue file_map_file(Interpreter& interpreter, ArgumentSpan args) {
+    if (args.size() < 3 || args.size() > 5 || !args[0].isString()) {
+        throw MegaladonError("map_file(path, mapper, reducer, [initial], [delimiter]) expects a file path and two functions.");
+    }
+    auto mapper = functionArgument(args[1], 1, "mapper");
+    auto reducer = functionArgument(args[2], 2, "reducer");
+    std::string delimiter = "\n";
+    if (args.size() == 5) {
+        if (!args[4].isString() || args[4].asString().empty()) {
+            throw MegaladonError("map_file() delimiter must be a non-empty string.");
+        }
+        delimiter = args[4].asString().str();
+    }
+
+    ProgressRun run;
+    MapFileProgress& progress = *run.progress;
+    auto reader = FileChunkReader::open(args[0].asString().str(), delimiter, MAP_FILE_CHUNK);
+    progress.totalBytes = reader->totalBytes();
+
+    ThreadPool& pool = ThreadPool::shared();
+    size_t waveSize = std::min(MAP_FILE_MAX_WAVE, pool.size());
+    bool mapInTask = mapper->isPure();
+    std::vector<Chunk> wave;
+
+    MegaladonValue pair[2];
+    bool folding = args.size() >= 4;
+    if (folding) pair[0] = args[3];
+
+    bool more = true;
+    while (more) {
+        wave.clear();
+        while (wave.size() < waveSize) {
+            Chunk chunk;
+            if (!reader->next(chunk.owner, chunk.text)) {
+                more = false;
+                break;
+            }
+            wave.push_back(std::move(chunk));
+        }
+
+        pool.parallelFor(wave.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                Chunk& chunk = wave[i];
+                std::vector<MegaladonValue> records;
+                appendRecords(chunk.owner, chunk.text, delimiter, records);
+                chunk.records = records.size();
+                chunk.value = MegaladonValue(std::move(records));
+                if (mapInTask) chunk.value = mapper->fastCall(interpreter, ArgumentSpan(&chunk.value, 1));
+            }
+        });
+
+        for (Chunk& chunk : wave) {
+            if (!mapInTask) chunk.value = mapper->fastCall(interpreter, ArgumentSpan(&chunk.value, 1));
+            if (folding) {
+                pair[1] = std::move(chunk.value);
+                pair[0] = reducer->fastCall(interpreter, ArgumentSpan(pair, 2));
+            } else {
+                pair[0] = std::move(chunk.value);
+                folding = true;
+            }
+            progress.chunks++;
+            progress.records += chunk.records;
+            progress.bytes += chunk.text.size();
+        }
+    }
+    return pair[0];
+}
+
+// map_file_stats() returns a one-line summary of the latest map_file call:
+// chunks, records and bytes done so far, elapsed time and throughput
+static std::string builtin_map_file_stats(Interpreter& interpreter) {
+    (void)interpreter;
+    return latestProgress ? latestProgress->toString() : MapFileProgress().toString();
+}
+
+// --- Register Chunked File Built-ins ---
+void registerFileBuiltins(std::shared_ptr<Environment>& env) {
+    env->define(SymbolTable::intern("map_file"), MegaladonValue(std::make_shared<NativeFunctionBuiltin>("map_file", -1, file_map_file)));
+    env->define(SymbolTable::intern("map_file_stats"),
+                MegaladonValue(std::make_shared<TypedBuiltin<builtin_map_file_stats>>("map_file_stats")));
+}
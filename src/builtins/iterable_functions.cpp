@@ -0,0 +1,104 @@
+#include "builtins.h"
+#include "../types/value.h"
+#include "../types/iterable.h"
+#include "../types/file_records.h"
+#include "../environment/environment.h"
+#include "../util/error.h"
+#include "../util/symbol_table.h"
+#include <algorithm> // For std::min
+#include <cmath>     // For std::fmod, std::isfinite, std::ceil
+#include <limits>    // For std::numeric_limits
+
+static bool isIndex(const MegaladonValue& value) {
+    return value.isNumber() && value.asNumber() >= 0 && std::fmod(value.asNumber(), 1.0) == 0.0;
+}
+
+// --- Iterable Built-in Functions ---
+
+// range(stop) / range(start, stop, [step])
+MegaladonValue iterable_range(ArgumentSpan args) {
+    if (args.empty() || args.size() > 3) {
+        throw MegaladonError("range() expects one to three numbers.");
+    }
+    for (const auto& arg : args) {
+        if (!arg.isNumber()) {
+            throw MegaladonError("range() expects one to three numbers.");
+        }
+    }
+    double start = args.size() == 1 ? 0.0 : args[0].asNumber();
+    double stop = args.size() == 1 ? args[0].asNumber() : args[1].asNumber();
+    double step = args.size() == 3 ? args[2].asNumber() : 1.0;
+    if (!std::isfinite(start) || !std::isfinite(stop) || !std::isfinite(step)) {
+        throw MegaladonError("range() bounds and step must be finite.");
+    }
+    if (step == 0.0) {
+        throw MegaladonError("range() step must not be zero.");
+    }
+    // The count is later cast to size_t, which is undefined outside its range
+    double count = std::ceil((stop - start) / step);
+    if (!(count < static_cast<double>(std::numeric_limits<size_t>::max()))) {
+        throw MegaladonError("range() has too many items.");
+    }
+    return MegaladonValue(std::shared_ptr<MegaladonIterable>(std::make_shared<RangeIterable>(start, stop, step)));
+}
+
+// chars(string)
+MegaladonValue iterable_chars(ArgumentSpan args) {
+    if (args.size() != 1 || !args[0].isString()) {
+        throw MegaladonError("chars(string) expects one string argument.");
+    }
+    return MegaladonValue(std::shared_ptr<MegaladonIterable>(std::make_shared<CharsIterable>(args[0].asString())));
+}
+
+// lines(string) - splits on '\n' (a trailing '\r' is dropped too)
+MegaladonValue iterable_lines(ArgumentSpan args) {
+    if (args.size() != 1 || !args[0].isString()) {
+        throw MegaladonError("lines(string) expects one string argument.");
+    }
+    return MegaladonValue(std::shared_ptr<MegaladonIterable>(std::make_shared<LinesIterable>(args[0].asString())));
+}
+
+// read_lines(path) - lines of a file, read lazily; "-" reads standard input
+MegaladonValue iterable_read_lines(ArgumentSpan args) {
+    if (args.size() != 1 || !args[0].isString()) {
+        throw MegaladonError("read_lines(path) expects a file path.");
+    }
+    return MegaladonValue(std::shared_ptr<MegaladonIterable>(std::make_shared<FileRecordsIterable>(args[0].asString().str(), "\n")));
+}
+
+// read_records(path, delimiter) - like read_lines, split on any non-empty delimiter
+MegaladonValue iterable_read_records(ArgumentSpan args) {
+    if (args.size() != 2 || !args[0].isString() || !args[1].isString() || args[1].asString().empty()) {
+        throw MegaladonError("read_records(path, delimiter) expects a file path and a non-empty delimiter string.");
+    }
+    return MegaladonValue(std::shared_ptr<MegaladonIterable>(
+        std::make_shared<FileRecordsIterable>(args[0].asString().str(), args[1].asString().str())));
+}
+
+// view(list, start, [stop]) - elements [start, stop) without copying
+MegaladonValue iterable_view(ArgumentSpan args) {
+    if (args.size() < 2 || args.size() > 3 || !args[0].isList() || !isIndex(args[1]) ||
+        (args.size() == 3 && !isIndex(args[2]))) {
+        throw MegaladonError("view(list, start, [stop]) expects a list and non-negative integer bounds.");
+    }
+    const auto& storage = args[0].listStorage();
+    size_t length = storage->elements.size();
+    // Clamped while still doubles: casting a bound past size_t's range is undefined
+    double stopBound = args.size() == 3 ? std::min(args[2].asNumber(), static_cast<double>(length)) : static_cast<double>(length);
+    size_t stop = static_cast<size_t>(stopBound);
+    size_t start = static_cast<size_t>(std::min(args[1].asNumber(), static_cast<double>(stop)));
+    return MegaladonValue(std::shared_ptr<MegaladonIterable>(std::make_shared<ListViewIterable>(storage, start, stop)));
+}
+
+// --- Register Iterable Built-ins ---
+void registerIterableBuiltins(std::shared_ptr<Environment>& env) {
+    auto define = [&env](const char* name, int arity, NativeFunctionBuiltin::Function function) {
+        env->define(SymbolTable::intern(name), MegaladonValue(std::make_shared<NativeFunctionBuiltin>(name, arity, function)));
+    };
+    define("range", -1, iterable_range);
+    define("chars", 1, iterable_chars);
+    define("lines", 1, iterable_lines);
+    define("view", -1, iterable_view);
+    define("read_lines", 1, iterable_read_lines);
+    define("read_records", 2, iterable_read_records);
+}
@@ -0,0 +1,622 @@
+#include "builtins.h"
+#include "../types/value.h"
+#include "../types/map_value.h"
+#include "../types/set_value.h"
+#include "../types/iterable.h"
+#include "../types/numeric_array.h"
+#include "../types/persistent_vector.h"
+#include "../environment/environment.h"
+#include "../util/error.h"
+#include "../util/json_kernels.h"
+#include "../util/number_format.h"
+#include "../util/symbol_table.h"
+#include <charconv> // For std::from_chars
+#include <cmath>    // For std::isfinite, std::trunc, std::fabs
+#include <cstdlib>  // For std::strtod
+#include <iterator> // For std::make_move_iterator
+
+// --- JSON Built-in Functions ---
+// json_parse works in two stages, like simdjson. Stage one
+// (jsonStructuralIndex) finds every structural character, string and scalar
+// with SIMD bit masks. Stage two walks that index and builds the lists, maps,
+// strings and numbers directly, so it never scans whitespace or skips string
+// contents byte by byte. The whole text is validated, except that bytes in
+// strings are not checked to be UTF-8.
+//
+// json_get is the on-demand mode: it walks the index to one value and builds
+// only that. Whole objects and arrays along the way are skipped in a single
+// step. The index of the last few texts it was given is kept, so repeated
+// lookups into one document index it once.
+//
+// json_stringify writes the whole value into one string.
+
+// Deeper nesting is rejected rather than risking the native stack
+constexpr size_t JSON_MAX_DEPTH = 1024;
+
+namespace {
+bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// Structural index of a text, plus where each object or array ends
+struct JsonDocument {
+    std::vector<uint32_t> positions;
+    std::vector<uint32_t> closes; // For '{' and '[' entries, the entry of the matching '}' or ']'
+};
+
+class JsonParser {
+public:
+    JsonParser(Interpreter& interpreter, std::string_view text, const std::vector<uint32_t>& positions, const char* caller)
+        : interpreter(interpreter), text(text), positions(positions), caller(caller) {}
+
+    // Builds the value whose first entry is positions[next]
+    MegaladonValue parseValue(size_t depth) {
+        if (next >= positions.size()) fail("unexpected end of text", text.size());
+        size_t at = positions[next++];
+        switch (text[at]) {
+            case '{': return parseObject(at, depth);
+            case '[': return parseArray(at, depth);
+            case '"': return MegaladonValue(parseString(at));
+            case 't': expectLiteral(at, "true"); return MegaladonValue(true);
+            case 'f': expectLiteral(at, "false"); return MegaladonValue(false);
+            case 'n': expectLiteral(at, "null"); return MegaladonValue();
+            default:
+                if (text[at] == '-' || isDigit(text[at])) return MegaladonValue(parseNumber(at));
+                fail(std::string("unexpected '") + text[at] + "'", at);
+        }
+    }
+
+    // The string whose opening quote is at 'at'
+    MegaladonString parseString(size_t at) {
+        size_t start = at + 1;
+        size_t end = jsonFindSpecial(text, start);
+        if (end < text.size() && text[end] == '"') return MegaladonString(text.substr(start, end - start));
+
+        std::string out(text.substr(start, end - start));
+        size_t p = end;
+        while (true) {
+            if (p >= text.size()) fail("unterminated string", at);
+            if (text[p] == '"') return MegaladonString(std::move(out));
+            if (text[p] != '\\') fail("control character in string", p);
+            if (p + 1 >= text.size()) fail("unterminated string", at);
+            char escape = text[p + 1];
+            switch (escape) {
+                case '"': case '\\': case '/': out += escape; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': p = appendUnicodeEscape(out, p) - 2; break;
+                default: fail("invalid escape in string", p);
+            }
+            p += 2;
+            size_t run = jsonFindSpecial(text, p);
+            out.append(text.substr(p, run - p));
+            p = run;
+        }
+    }
+
+    [[noreturn]] void fail(const std::string& what, size_t at) const {
+        throw MegaladonError(std::string(caller) + ": " + what + " at byte " + std::to_string(at) + ".");
+    }
+
+    // Entry the next parseValue starts at
+    size_t next = 0;
+
+private:
+    // Objects and arrays collect their members on 'scratch' and are built at
+    // their final size once they close
+    MegaladonValue parseObject(size_t at, size_t depth) {
+        if (depth >= JSON_MAX_DEPTH) fail("nesting is too deep", at);
+        size_t base = scratch.size();
+        if (peek() == '}') {
+            ++next;
+        } else {
+            while (true) {
+                if (peek() != '"') fail("expected a string key", offset());
+                scratch.push_back(MegaladonValue(parseString(positions[next++])));
+                if (peek() != ':') fail("expected ':' after an object key", offset());
+                ++next;
+                scratch.push_back(parseValue(depth + 1));
+                char c = peek();
+                ++next;
+                if (c == '}') break;
+                if (c != ',') fail("expected ',' or '}' after an object value", positions[next - 1]);
+            }
+        }
+        auto map = newMap(interpreter);
+        map->reserve((scratch.size() - base) / 2);
+        for (size_t i = base; i < scratch.size(); i += 2) {
+            map->set(scratch[i], scratch[i + 1]); // Later duplicates overwrite earlier ones, like map literals
+        }
+        scratch.resize(base);
+        return MegaladonValue(map);
+    }
+
+    MegaladonValue parseArray(size_t at, size_t depth) {
+        if (depth >= JSON_MAX_DEPTH) fail("nesting is too deep", at);
+        size_t base = scratch.size();
+        if (peek() == ']') {
+            ++next;
+        } else {
+            while (true) {
+                scratch.push_back(parseValue(depth + 1));
+                char c = peek();
+                ++next;
+                if (c == ']') break;
+                if (c != ',') fail("expected ',' or ']' after an array element", positions[next - 1]);
+            }
+        }
+        std::vector<MegaladonValue> elements(std::make_move_iterator(scratch.begin() + base),
+                                             std::make_move_iterator(scratch.end()));
+        scratch.resize(base);
+        return MegaladonValue(std::move(elements));
+    }
+
+    double parseNumber(size_t at) {
+        // -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+        size_t p = at;
+        if (text[p] == '-') ++p;
+        if (p >= text.size() || !isDigit(text[p])) fail("invalid number", at);
+        if (text[p] == '0') {
+            ++p;
+        } else {
+            while (p < text.size() && isDigit(text[p])) ++p;
+        }
+        if (p < text.size() && text[p] == '.') {
+            ++p;
+            if (p >= text.size() || !isDigit(text[p])) fail("invalid number", at);
+            while (p < text.size() && isDigit(text[p])) ++p;
+        }
+        if (p < text.size() && (text[p] == 'e' || text[p] == 'E')) {
+            ++p;
+            if (p < text.size() && (text[p] == '+' || text[p] == '-')) ++p;
+            if (p >= text.size() || !isDigit(text[p])) fail("invalid number", at);
+            while (p < text.size() && isDigit(text[p])) ++p;
+        }
+        if (!endsScalar(p)) fail("invalid number", at);
+
+        double value = 0.0;
+        auto result = std::from_chars(text.data() + at, text.data() + p, value);
+        if (result.ec == std::errc::result_out_of_range) {
+            // Underflow rounds to zero (or a denormal); overflow is an error
+            value = std::strtod(std::string(text.substr(at, p - at)).c_str(), nullptr);
+            if (!std::isfinite(value)) fail("number out of range", at);
+        }
+        return value;
+    }
+
+    void expectLiteral(size_t at, std::string_view literal) {
+        if (text.compare(at, literal.size(), literal) != 0 || !endsScalar(at + literal.size())) {
+            fail("invalid literal", at);
+        }
+    }
+
+    // Reads the four hex digits of the \u escape at 'p' (and the low half of a
+    // surrogate pair) and appends the character as UTF-8; returns the offset
+    // after the escape
+    size_t appendUnicodeEscape(std::string& out, size_t p) {
+        uint32_t code = hexQuad(p);
+        p += 6;
+        if (code >= 0xD800 && code <= 0xDBFF) {
+            if (text.compare(p, 2, "\\u") != 0) fail("unpaired surrogate in \\u escape", p - 6);
+            uint32_t low = hexQuad(p);
+            if (low < 0xDC00 || low > 0xDFFF) fail("unpaired surrogate in \\u escape", p - 6);
+            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+            p += 6;
+        } else if (code >= 0xDC00 && code <= 0xDFFF) {
+            fail("unpaired surrogate in \\u escape", p - 6);
+        }
+        if (code < 0x80) {
+            out += static_cast<char>(code);
+        } else if (code < 0x800) {
+            out += static_cast<char>(0xC0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else if (code < 0x10000) {
+            out += static_cast<char>(0xE0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (code >> 18));
+            out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+        return p;
+    }
+
+    // The value of the four hex digits after the "\u" at 'p'
+    uint32_t hexQuad(size_t p) const {
+        if (p + 6 > text.size()) fail("invalid \\u escape", p);
+        uint32_t code = 0;
+        for (size_t i = p + 2; i < p + 6; ++i) {
+            char c = text[i];
+            uint32_t digit;
+            if (c >= '0' && c <= '9') digit = static_cast<uint32_t>(c - '0');
+            else if (c >= 'a' && c <= 'f') digit = static_cast<uint32_t>(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F') digit = static_cast<uint32_t>(c - 'A' + 10);
+            else fail("invalid \\u escape", p);
+            code = code << 4 | digit;
+        }
+        return code;
+    }
+
+    // Whether a number or literal may end before text[p]
+    bool endsScalar(size_t p) const {
+        if (p >= text.size()) return true;
+        switch (text[p]) {
+            case ' ': case '\t': case '\n': case '\r':
+            case ',': case ':': case '[': case ']': case '{': case '}':
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    // The character of the next entry, or '\0' past the last one
+    char peek() const {
+        return next < positions.size() ? text[positions[next]] : '\0';
+    }
+
+    size_t offset() const {
+        return next < positions.size() ? positions[next] : text.size();
+    }
+
+    Interpreter& interpreter;
+    std::string_view text;
+    const std::vector<uint32_t>& positions;
+    const char* caller;
+    std::vector<MegaladonValue> scratch; // Members of the objects and arrays still open
+};
+
+// The text of a json_parse or json_get argument: a string or a byte buffer
+std::string_view jsonText(const MegaladonValue& value, const char* caller) {
+    std::string_view text;
+    if (value.isString()) {
+        text = value.asString().view();
+    } else if (value.isBytes()) {
+        text = value.asBytes().view();
+    } else {
+        throw MegaladonError(std::string(caller) + " expects a string or bytes.");
+    }
+    if (text.size() > JSON_MAX_TEXT) {
+        throw MegaladonError(std::string(caller) + ": text is larger than 4 GB.");
+    }
+    return text;
+}
+
+void indexText(std::string_view text, std::vector<uint32_t>& positions, const char* caller) {
+    if (!jsonStructuralIndex(text, positions)) {
+        throw MegaladonError(std::string(caller) + ": unterminated string at the end of the text.");
+    }
+    if (positions.empty()) {
+        throw MegaladonError(std::string(caller) + ": no value in the text.");
+    }
+}
+
+// --- On-demand documents ---
+
+// Texts json_get has indexed recently. The entries hold the strings, which
+// are immutable, so a text whose bytes are at the same address with the same
+// length is the same text.
+constexpr size_t DOCUMENT_CACHE_SIZE = 4;
+
+struct CachedDocument {
+    MegaladonString text;
+    std::shared_ptr<const JsonDocument> document;
+};
+
+CachedDocument documentCache[DOCUMENT_CACHE_SIZE];
+size_t nextCacheSlot = 0;
+
+std::shared_ptr<const JsonDocument> buildDocument(std::string_view text) {
+    auto document = std::make_shared<JsonDocument>();
+    indexText(text, document->positions, "json_get()");
+    const auto& positions = document->positions;
+    document->closes.resize(positions.size());
+    std::vector<uint32_t> open;
+    for (size_t i = 0; i < positions.size(); ++i) {
+        char c = text[positions[i]];
+        if (c == '{' || c == '[') {
+            open.push_back(static_cast<uint32_t>(i));
+        } else if (c == '}' || c == ']') {
+            if (open.empty() || text[positions[open.back()]] != (c == '}' ? '{' : '[')) {
+                throw MegaladonError("json_get(): unmatched '" + std::string(1, c) + "' at byte " +
+                                     std::to_string(positions[i]) + ".");
+            }
+            document->closes[open.back()] = static_cast<uint32_t>(i);
+            open.pop_back();
+        }
+    }
+    if (!open.empty()) {
+        throw MegaladonError("json_get(): unclosed '" + std::string(1, text[positions[open.back()]]) + "' at byte " +
+                             std::to_string(positions[open.back()]) + ".");
+    }
+    return document;
+}
+
+std::shared_ptr<const JsonDocument> documentFor(const MegaladonValue& value, std::string_view text) {
+    // Inline strings live in the value itself, so their address says nothing;
+    // they are also too short to be worth caching
+    bool cacheable = value.isString() && text.size() > MegaladonString::INLINE_CAPACITY;
+    if (cacheable) {
+        for (const auto& entry : documentCache) {
+            if (entry.document && entry.text.size() == text.size() && entry.text.view().data() == text.data()) {
+                return entry.document;
+            }
+        }
+    }
+    auto document = buildDocument(text);
+    if (cacheable) {
+        documentCache[nextCacheSlot] = CachedDocument{value.asString(), document};
+        nextCacheSlot = (nextCacheSlot + 1) % DOCUMENT_CACHE_SIZE;
+    }
+    return document;
+}
+
+// The entry after the value that starts at entry 'i'
+size_t skipValue(const JsonDocument& document, std::string_view text, size_t i) {
+    char c = text[document.positions[i]];
+    return c == '{' || c == '[' ? document.closes[i] + 1 : i + 1;
+}
+} // namespace
+
+// json_parse(text) - the value of a JSON document (a string or bytes).
+// Objects become maps, arrays lists and null void.
+static MegaladonValue json_parse(Interpreter& interpreter, ArgumentSpan args) {
+    std::string_view text = jsonText(args[0], "json_parse()");
+    std::vector<uint32_t> positions;
+    indexText(text, positions, "json_parse()");
+    JsonParser parser(interpreter, text, positions, "json_parse()");
+    MegaladonValue value = parser.parseValue(0);
+    if (parser.next < positions.size()) parser.fail("unexpected text after the value", positions[parser.next]);
+    return value;
+}
+
+// json_get(text, key_or_index, ...) - only the value at that path in a JSON
+// document, e.g. json_get(text, "items", 0, "name"); void if the path is not
+// there. Negative indexes count from the end. Parts of the document that are
+// skipped are only checked for matching brackets and closed strings.
+static MegaladonValue json_get(Interpreter& interpreter, ArgumentSpan args) {
+    if (args.empty()) {
+        throw MegaladonError("json_get(text, key_or_index, ...) expects a JSON text and a path.");
+    }
+    std::string_view text = jsonText(args[0], "json_get()");
+    auto document = documentFor(args[0], text);
+    const auto& positions = document->positions;
+    JsonParser parser(interpreter, text, positions, "json_get()");
+
+    size_t node = 0;
+    for (size_t a = 1; a < args.size(); ++a) {
+        const MegaladonValue& step = args[a];
+        char kind = text[positions[node]];
+        size_t close = kind == '{' || kind == '[' ? document->closes[node] : 0;
+        if (step.isString()) {
+            if (kind != '{') return MegaladonValue();
+            std::string_view wanted = step.asString().view();
+            size_t i = node + 1;
+            bool found = false;
+            while (i < close) {
+                if (text[positions[i]] != '"') parser.fail("expected a string key", positions[i]);
+                size_t keyStart = positions[i] + 1;
+                size_t keyEnd = jsonFindSpecial(text, keyStart);
+                bool match = keyEnd < text.size() && text[keyEnd] == '"'
+                                 ? text.substr(keyStart, keyEnd - keyStart) == wanted
+                                 : parser.parseString(positions[i]).view() == wanted;
+                if (i + 2 >= close || text[positions[i + 1]] != ':') parser.fail("expected ':' and a value after an object key", positions[i]);
+                if (match) {
+                    node = i + 2;
+                    found = true;
+                    break;
+                }
+                i = skipValue(*document, text, i + 2);
+                if (i < close) {
+                    if (text[positions[i]] != ',') parser.fail("expected ',' or '}' after an object value", positions[i]);
+                    ++i;
+                }
+            }
+            if (!found) return MegaladonValue();
+        } else if (step.isNumber()) {
+            if (kind != '[') return MegaladonValue();
+            double index = step.asNumber();
+            if (std::trunc(index) != index) {
+                throw MegaladonError("json_get() array indexes must be integers.");
+            }
+            if (std::fabs(index) >= static_cast<double>(close)) return MegaladonValue(); // More than the entries
+            std::vector<size_t> elements; // Only filled for negative indexes
+            long long wanted = static_cast<long long>(index);
+            size_t i = node + 1;
+            long long count = 0;
+            bool found = false;
+            while (i < close) {
+                if (wanted >= 0 && count == wanted) {
+                    node = i;
+                    found = true;
+                    break;
+                }
+                if (wanted < 0) elements.push_back(i);
+                ++count;
+                i = skipValue(*document, text, i);
+                if (i < close) {
+                    if (text[positions[i]] != ',') parser.fail("expected ',' or ']' after an array element", positions[i]);
+                    ++i;
+                }
+            }
+            if (wanted < 0 && -wanted <= count) {
+                node = elements[static_cast<size_t>(count + wanted)];
+                found = true;
+            }
+            if (!found) return MegaladonValue();
+        } else {
+            throw MegaladonError("json_get() path steps must be strings (keys) or numbers (indexes).");
+        }
+    }
+    parser.next = node;
+    return parser.parseValue(0);
+}
+
+// --- Serializer ---
+namespace {
+class JsonWriter {
+public:
+    explicit JsonWriter(std::string& out) : out(out) {}
+
+    void write(const MegaladonValue& value, size_t depth) {
+        if (depth >= JSON_MAX_DEPTH) {
+            throw MegaladonError("json_stringify(): nesting is too deep (is the value inside itself?).");
+        }
+        switch (value.type) {
+            case VOID: out += "null"; return;
+            case BOOLEAN: out += value.asBoolean() ? "true" : "false"; return;
+            case NUMBER: writeNumber(value.asNumber()); return;
+            case STRING: writeString(value.asString().view()); return;
+            case LIST: {
+                const auto& list = value.asList();
+                out += '[';
+                for (size_t i = 0; i < list.size(); ++i) {
+                    if (i > 0) out += ',';
+                    write(list[i], depth + 1);
+                }
+                out += ']';
+                return;
+            }
+            case ARRAY: {
+                const auto& values = value.asArray()->values;
+                out += '[';
+                for (size_t i = 0; i < values.size(); ++i) {
+                    if (i > 0) out += ',';
+                    writeNumber(values[i]);
+                }
+                out += ']';
+                return;
+            }
+            case VECTOR: {
+                const auto& vector = *value.asVector();
+                out += '[';
+                for (size_t i = 0; i < vector.size(); ++i) {
+                    if (i > 0) out += ',';
+                    write(vector.get(i), depth + 1);
+                }
+                out += ']';
+                return;
+            }
+            case SET: {
+                const auto& set = *value.asSet();
+                out += '[';
+                bool first = true;
+                for (size_t i = 0; i < set.positionCount(); ++i) {
+                    const MegaladonValue* element = set.elementAt(i);
+                    if (!element) continue;
+                    if (!first) out += ',';
+                    write(*element, depth + 1);
+                    first = false;
+                }
+                out += ']';
+                return;
+            }
+            case ITERABLE: {
+                auto iterator = iterateValue(value);
+                out += '[';
+                MegaladonValue item;
+                bool first = true;
+                while (iterator->next(item)) {
+                    if (!first) out += ',';
+                    write(item, depth + 1);
+                    first = false;
+                }
+                out += ']';
+                return;
+            }
+            case MAP: {
+                out += '{';
+                bool first = true;
+                for (const auto& entry : value.asMap()->entries()) {
+                    if (entry.removed()) continue;
+                    if (!first) out += ',';
+                    writeKey(entry.key);
+                    out += ':';
+                    write(entry.value, depth + 1);
+                    first = false;
+                }
+                out += '}';
+                return;
+            }
+            case FUNCTION: throw MegaladonError("json_stringify() cannot write a function.");
+            case BYTES: throw MegaladonError("json_stringify() cannot write bytes; decode them to a string first.");
+            case TENSOR: throw MegaladonError("json_stringify() cannot write a tensor; convert it to a list first.");
+            default: throw MegaladonError("json_stringify() cannot write this value.");
+        }
+    }
+
+private:
+    void writeNumber(double number) {
+        if (!std::isfinite(number)) {
+            throw MegaladonError("json_stringify() cannot write NaN or infinity.");
+        }
+        appendNumber(out, number);
+    }
+
+    // JSON keys are strings; number and boolean keys are written as their text
+    void writeKey(const MegaladonValue& key) {
+        if (key.isString()) {
+            writeString(key.asString().view());
+            return;
+        }
+        out += '"';
+        if (key.isNumber()) {
+            writeNumber(key.asNumber());
+        } else {
+            out += key.asBoolean() ? "true" : "false";
+        }
+        out += '"';
+    }
+
+    // Copies the runs between characters that need escaping in one append each
+    void writeString(std::string_view text) {
+        static const char hex[] = "0123456789abcdef";
+        out += '"';
+        size_t p = 0;
+        while (true) {
+            size_t special = jsonFindSpecial(text, p);
+            out.append(text.data() + p, special - p);
+            if (special == text.size()) break;
+            char c = text[special];
+            switch (c) {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\b': out += "\\b"; break;
+                case '\f': out += "\\f"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                case '\t': out += "\\t"; break;
+                default:
+                    out += "\\u00";
+                    out += hex[(c >> 4) & 0xF];
+                    out += hex[c & 0xF];
+            }
+            p = special + 1;
+        }
+        out += '"';
+    }
+
+    std::string& out;
+};
+} // namespace
+
+// json_stringify(value) - compact JSON text for lists, maps, numbers, strings,
+// booleans and void (null). Arrays, vectors, sets and lazy sequences are
+// written as arrays; number and boolean map keys become strings.
+static MegaladonValue json_stringify(ArgumentSpan args) {
+    std::string out;
+    JsonWriter(out).write(args[0], 0);
+    return MegaladonValue(std::move(out));
+}
+
+// --- Register JSON Built-ins ---
+void registerJsonBuiltins(std::shared_ptr<Environment>& env) {
+    env->define(SymbolTable::intern("json_parse"), MegaladonValue(std::make_shared<NativeFunctionBuiltin>("json_parse", 1, json_parse)));
+    env->define(SymbolTable::intern("json_get"), MegaladonValue(std::make_shared<NativeFunctionBuiltin>("json_get", -1, json_get)));
+    env->define(SymbolTable::intern("json_stringify"),
+                MegaladonValue(std::make_shared<NativeFunctionBuiltin>("json_stringify", 1, json_stringify, true)));
+}
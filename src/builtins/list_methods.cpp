@@ -1,8 +1,11 @@
 #include "builtins.h"
 #include "../types/value.h"
 #include "../util/error.h"
-#include <algorithm> // For std::sort
-#include <cmath>    // For std::fmod
+#include "../util/sort_kernels.h"
+#include <algorithm> // For std::remove, std::stable_sort, std::lower_bound
+#include <cmath>    // For std::fmod, std::isnan
+#include <cstdint>  // For uint32_t
+#include <string_view>
 
 // Helper to check if a value is an integer number
 bool isInteger(const MegaladonValue& val) {
@@ -163,56 +166,226 @@ MegaladonValue list_remove(std::vector<MegaladonValue>& arguments) { // Removed
     return MegaladonValue(); // Return VOID
 }
 
-// Comparator for sorting MegaladonValues (simple numeric/string comparison)
-bool megaladonValueLessThan(const MegaladonValue& a, const MegaladonValue& b) {
-    if (a.isNumber() && b.isNumber()) {
-        return a.asNumber() < b.asNumber();
+// --- Sorting ---
+// Lists of numbers are radix sorted; lists of strings are sorted as views of
+// their bytes, on several threads when long. Either way the element types are
+// checked once, not on every comparison. Other lists need a comparator.
+
+namespace {
+enum class ElementKind { NUMBERS, STRINGS, MIXED };
+
+ElementKind elementKind(const std::vector<MegaladonValue>& values) {
+    if (values.empty() || values[0].isNumber()) {
+        for (const auto& value : values) {
+            if (!value.isNumber()) return ElementKind::MIXED;
+        }
+        return ElementKind::NUMBERS;
     }
-    if (a.isString() && b.isString()) {
-        return a.asString() < b.asString();
+    if (!values[0].isString()) return ElementKind::MIXED;
+    for (const auto& value : values) {
+        if (!value.isString()) return ElementKind::MIXED;
     }
-    // Define behavior for other types or throw an error for unsupported comparisons
-    throw std::runtime_error("MegaladonError: Cannot compare these types for sorting.");
+    return ElementKind::STRINGS;
 }
 
-// list.sort()
-MegaladonValue list_sort(std::vector<MegaladonValue>& arguments) { // Removed const
-    if (arguments.size() != 1 || !arguments[0].isList()) {
-        throw std::runtime_error("MegaladonError: list.sort() expects a list object.");
-    }
-
-    auto& list = arguments[0].asListMutable(); // Modify in place
-    if (!list.empty()) {
-        // Basic check if elements are comparable before sorting
-        ValueType first_type = list[0].type;
-        bool all_same_type = true;
-        for (size_t i = 1; i < list.size(); ++i) {
-            if (list[i].type != first_type || (!list[i].isNumber() && !list[i].isString())) {
-                all_same_type = false;
-                break;
+// Sorts 'order' by the string values it points at. The views are taken up front
+// (flattening any ropes), so the comparisons are plain byte compares that can
+// run on the pool.
+void sortOrderByStrings(const std::vector<MegaladonValue>& values, std::vector<uint32_t>& order, bool stable) {
+    std::vector<std::pair<std::string_view, uint32_t>> views;
+    views.reserve(order.size());
+    for (uint32_t index : order) views.emplace_back(values[index].asString().view(), index);
+    parallelSort(views, [](const auto& a, const auto& b) { return a.first < b.first; }, stable);
+    for (size_t i = 0; i < order.size(); ++i) order[i] = views[i].second;
+}
+
+// Rearranges 'list' so list[i] is the old list[order[i]]
+void applyOrder(std::vector<MegaladonValue>& list, const std::vector<uint32_t>& order) {
+    std::vector<MegaladonValue> sorted;
+    sorted.reserve(list.size());
+    for (uint32_t index : order) sorted.push_back(std::move(list[index]));
+    list.swap(sorted);
+}
+
+std::vector<uint32_t> identityOrder(size_t n) {
+    std::vector<uint32_t> order(n);
+    for (size_t i = 0; i < n; ++i) order[i] = static_cast<uint32_t>(i);
+    return order;
+}
+
+// Sorts the list held by 'receiver' and records that it is sorted, unless it
+// ends in NaNs, which binary search cannot find
+void sortHomogeneous(MegaladonValue& receiver, bool stable, const char* caller) {
+    auto& list = receiver.asListMutable(); // Modify in place
+    switch (elementKind(list)) {
+        case ElementKind::NUMBERS: {
+            std::vector<double> numbers(list.size());
+            for (size_t i = 0; i < list.size(); ++i) numbers[i] = list[i].asNumber();
+            radixSortDoubles(numbers.data(), numbers.size());
+            for (size_t i = 0; i < list.size(); ++i) list[i] = MegaladonValue(numbers[i]);
+            if (numbers.empty() || !std::isnan(numbers.back())) {
+                receiver.listStorage()->sortState = ListStorage::SORTED_NUMBERS;
             }
+            return;
         }
-
-        if (!all_same_type) {
-            throw std::runtime_error("MegaladonError: List contains incomparable types for sorting.");
+        case ElementKind::STRINGS: {
+            std::vector<uint32_t> order = identityOrder(list.size());
+            sortOrderByStrings(list, order, stable);
+            applyOrder(list, order);
+            receiver.listStorage()->sortState = ListStorage::SORTED_STRINGS;
+            return;
         }
+        case ElementKind::MIXED:
+            throw std::runtime_error(std::string("MegaladonError: ") + caller +
+                                     " needs a list of numbers or of strings, or a comparator.");
+    }
+}
 
-        std::sort(list.begin(), list.end(), megaladonValueLessThan);
+std::shared_ptr<MegaladonCallable> callableArgument(const MegaladonValue& value, int arity, const char* caller) {
+    if (!value.isFunction()) {
+        throw std::runtime_error(std::string("MegaladonError: ") + caller + " expects a function.");
+    }
+    std::shared_ptr<MegaladonCallable> function = value.asCallable();
+    if (function->arity() != arity && function->arity() != -1) {
+        throw std::runtime_error(std::string("MegaladonError: ") + caller + " expects a function of " +
+                                 std::to_string(arity) + (arity == 1 ? " argument." : " arguments."));
+    }
+    return function;
+}
+
+// comparator(a, b) returns true (or a negative number) when a belongs before b.
+// Sorting goes through an index vector, so a comparator that throws leaves the
+// list as it was. The sort is stable.
+void sortWithComparator(Interpreter& interpreter, std::vector<MegaladonValue>& list, const MegaladonValue& comparator) {
+    auto function = callableArgument(comparator, 2, "list.sort(comparator)");
+    std::vector<uint32_t> order = identityOrder(list.size());
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        MegaladonValue pair[2] = {list[a], list[b]};
+        MegaladonValue before = function->fastCall(interpreter, ArgumentSpan(pair, 2));
+        if (before.isBoolean()) return before.asBoolean();
+        if (before.isNumber()) return before.asNumber() < 0;
+        throw std::runtime_error("MegaladonError: list.sort() comparator must return a boolean or a number.");
+    });
+    applyOrder(list, order);
+}
+} // namespace
+
+// list.sort([comparator]) - ascending numbers or strings; equal strings may change order
+MegaladonValue list_sort(Interpreter& interpreter, std::vector<MegaladonValue>& arguments) {
+    if (arguments.size() < 1 || arguments.size() > 2 || !arguments[0].isList()) {
+        throw std::runtime_error("MegaladonError: list.sort() expects a list object and an optional comparator.");
+    }
+    if (arguments.size() == 2) {
+        sortWithComparator(interpreter, arguments[0].asListMutable(), arguments[1]);
+    } else {
+        sortHomogeneous(arguments[0], false, "list.sort()");
     }
     return MegaladonValue(); // Return VOID
 }
 
-// --- Register List Methods ---
-// This part would typically be in core_function.cpp or a similar central registration point
-// It demonstrates how you'd define methods accessible via dot notation on a List type in Megaladon.
-// This requires your interpreter to handle method calls (e.g., list.add(item)).
+// list.sort_stable([comparator]) - like sort, but equal elements keep their order
+MegaladonValue list_sort_stable(Interpreter& interpreter, std::vector<MegaladonValue>& arguments) {
+    if (arguments.size() < 1 || arguments.size() > 2 || !arguments[0].isList()) {
+        throw std::runtime_error("MegaladonError: list.sort_stable() expects a list object and an optional comparator.");
+    }
+    if (arguments.size() == 2) {
+        sortWithComparator(interpreter, arguments[0].asListMutable(), arguments[1]);
+    } else {
+        sortHomogeneous(arguments[0], true, "list.sort_stable()");
+    }
+    return MegaladonValue();
+}
 
-/*
-// Example of how to register list methods if you have a way to define methods on types
-void registerListMethods(std::shared_ptr<Environment>& env) {
-    // This part is more complex as it depends on how you represent classes/objects
-    // For now, assuming direct built-in functions that take the list as the first arg.
-    // If you have a MegaladonList class that encapsulates std::vector<MegaladonValue>,
-    // its methods would look different.
-}
-*/
\ No newline at end of file
+// list.sort_by(key) - stable sort by key(element), which is called once per
+// element and must return numbers for all elements or strings for all
+MegaladonValue list_sort_by(Interpreter& interpreter, std::vector<MegaladonValue>& arguments) {
+    if (arguments.size() != 2 || !arguments[0].isList()) {
+        throw std::runtime_error("MegaladonError: list.sort_by() expects a list object and a key function.");
+    }
+    auto function = callableArgument(arguments[1], 1, "list.sort_by(key)");
+    auto& list = arguments[0].asListMutable();
+    std::vector<MegaladonValue> keys;
+    keys.reserve(list.size());
+    for (const auto& element : list) {
+        keys.push_back(function->fastCall(interpreter, ArgumentSpan(&element, 1)));
+    }
+
+    std::vector<uint32_t> order = identityOrder(list.size());
+    switch (elementKind(keys)) {
+        case ElementKind::NUMBERS: {
+            std::vector<double> numbers(keys.size());
+            for (size_t i = 0; i < keys.size(); ++i) numbers[i] = keys[i].asNumber();
+            radixSortByKeys(numbers, order);
+            break;
+        }
+        case ElementKind::STRINGS:
+            sortOrderByStrings(keys, order, true);
+            break;
+        case ElementKind::MIXED:
+            throw std::runtime_error("MegaladonError: list.sort_by() keys must be all numbers or all strings.");
+    }
+    applyOrder(list, order);
+    return MegaladonValue();
+}
+
+// --- Searching ---
+// A list last changed by sort() is known to be sorted (ListStorage::sortState),
+// and is searched by binary search; any other list is scanned.
+
+namespace {
+constexpr size_t NOT_FOUND = static_cast<size_t>(-1);
+
+size_t findInList(const ListStorage& storage, const MegaladonValue& value) {
+    const auto& list = storage.elements;
+    if (storage.sortState == ListStorage::SORTED_NUMBERS) {
+        if (!value.isNumber()) return NOT_FOUND;
+        double target = value.asNumber();
+        auto it = std::lower_bound(list.begin(), list.end(), target,
+                                   [](const MegaladonValue& element, double key) { return element.asNumber() < key; });
+        return it != list.end() && it->asNumber() == target ? static_cast<size_t>(it - list.begin()) : NOT_FOUND;
+    }
+    if (storage.sortState == ListStorage::SORTED_STRINGS) {
+        if (!value.isString()) return NOT_FOUND;
+        std::string_view target = value.asString().view();
+        auto it = std::lower_bound(list.begin(), list.end(), target,
+                                   [](const MegaladonValue& element, std::string_view key) { return element.asString().view() < key; });
+        return it != list.end() && it->asString().view() == target ? static_cast<size_t>(it - list.begin()) : NOT_FOUND;
+    }
+    auto it = std::find(list.begin(), list.end(), value);
+    return it != list.end() ? static_cast<size_t>(it - list.begin()) : NOT_FOUND;
+}
+} // namespace
+
+// list.index_of(value) - index of the first element equal to value, or -1
+MegaladonValue list_index_of(const std::vector<MegaladonValue>& arguments) {
+    if (arguments.size() != 2 || !arguments[0].isList()) {
+        throw std::runtime_error("MegaladonError: list.index_of() expects a list object and a value to find.");
+    }
+    size_t index = findInList(*arguments[0].listStorage(), arguments[1]);
+    return MegaladonValue(index == NOT_FOUND ? -1.0 : static_cast<double>(index));
+}
+
+// list.contains(value)
+MegaladonValue list_contains(const std::vector<MegaladonValue>& arguments) {
+    if (arguments.size() != 2 || !arguments[0].isList()) {
+        throw std::runtime_error("MegaladonError: list.contains() expects a list object and a value to find.");
+    }
+    return MegaladonValue(findInList(*arguments[0].listStorage(), arguments[1]) != NOT_FOUND);
+}
+
+// --- Register List Methods ---
+void registerListMethods(MethodTable& table) {
+    table.define("add", list_add);
+    table.define("insert_at", list_insert_at);
+    table.define("remove_at", list_remove_at);
+    table.define("remove", list_remove);
+    table.define("pop", list_pop);
+    table.define("get", list_get);
+    table.define("set", list_set);
+    table.define("clear", list_clear);
+    table.define("sort", list_sort);
+    table.define("sort_stable", list_sort_stable);
+    table.define("sort_by", list_sort_by);
+    table.define("index_of", list_index_of);
+    table.define("contains", list_contains);
+}
@@ -0,0 +1,101 @@
+#include "builtins.h"
+#include "../types/value.h"
+#include "../types/map_value.h"
+#include "../types/set_value.h"
+#include "../environment/environment.h"
+#include "../util/error.h"
+#include "../util/symbol_table.h"
+
+static MegaladonMap& mapArgument(ArgumentSpan args, const char* usage) {
+    if (args.empty() || !args[0].isMap()) {
+        throw MegaladonError(std::string(usage) + " expects a map as its first argument.");
+    }
+    return *args[0].asMap();
+}
+
+// --- Map Built-in Functions ---
+
+// get(map, key, [default]) - missing keys return 'default' (or void)
+MegaladonValue map_get(ArgumentSpan args) {
+    if (args.size() < 2 || args.size() > 3) {
+        throw MegaladonError("get(map, key, [default]) expects two or three arguments.");
+    }
+    const MegaladonValue* value = mapArgument(args, "get()").get(args[1]);
+    if (value) {
+        return *value;
+    }
+    return args.size() == 3 ? args[2] : MegaladonValue();
+}
+
+// get_all(map, keys, [default]) - list of the values of every key in the list
+// 'keys'; missing keys give 'default' (or void). The lookups overlap their
+// cache misses, so on large maps this is faster than get() in a loop.
+MegaladonValue map_get_all(ArgumentSpan args) {
+    if (args.size() < 2 || args.size() > 3 || !args[1].isList()) {
+        throw MegaladonError("get_all(map, keys, [default]) expects a map and a list of keys.");
+    }
+    const MegaladonMap& map = mapArgument(args, "get_all()");
+    const std::vector<MegaladonValue>& keys = args[1].asList();
+    std::vector<const MegaladonValue*> found(keys.size());
+    map.getMany(keys.data(), keys.size(), found.data());
+
+    MegaladonValue fallback = args.size() == 3 ? args[2] : MegaladonValue();
+    std::vector<MegaladonValue> values;
+    values.reserve(keys.size());
+    for (const MegaladonValue* value : found) {
+        values.push_back(value ? *value : fallback);
+    }
+    return MegaladonValue(std::move(values));
+}
+
+// set(map, key, value) - inserts or overwrites, returns the value
+MegaladonValue map_set(ArgumentSpan args) {
+    if (args.size() != 3) {
+        throw MegaladonError("set(map, key, value) expects three arguments.");
+    }
+    mapArgument(args, "set()").set(args[1], args[2]);
+    return args[2];
+}
+
+// has(map, key) / has(set, value)
+MegaladonValue map_has(ArgumentSpan args) {
+    if (args.size() != 2) {
+        throw MegaladonError("has(collection, key) expects two arguments.");
+    }
+    if (args[0].isSet()) {
+        return MegaladonValue(args[0].asSet()->has(args[1]));
+    }
+    return MegaladonValue(mapArgument(args, "has()").has(args[1]));
+}
+
+// remove(map, key) / remove(set, value) - returns whether it was present
+MegaladonValue map_remove(ArgumentSpan args) {
+    if (args.size() != 2) {
+        throw MegaladonError("remove(collection, key) expects two arguments.");
+    }
+    if (args[0].isSet()) {
+        return MegaladonValue(args[0].asSet()->remove(args[1]));
+    }
+    return MegaladonValue(mapArgument(args, "remove()").remove(args[1]));
+}
+
+// keys(map) - list of keys in insertion order
+MegaladonValue map_keys(ArgumentSpan args) {
+    if (args.size() != 1) {
+        throw MegaladonError("keys(map) expects one argument.");
+    }
+    return MegaladonValue(mapArgument(args, "keys()").keys());
+}
+
+// --- Register Map Built-ins ---
+void registerMapBuiltins(std::shared_ptr<Environment>& env) {
+    auto define = [&env](const char* name, int arity, NativeFunctionBuiltin::Function function) {
+        env->define(SymbolTable::intern(name), MegaladonValue(std::make_shared<NativeFunctionBuiltin>(name, arity, function)));
+    };
+    define("get", -1, map_get);
+    define("get_all", -1, map_get_all);
+    define("set", 3, map_set);
+    define("has", 2, map_has);
+    define("remove", 2, map_remove);
+    define("keys", 1, map_keys);
+}
@@ -0,0 +1,35 @@
+#include "builtins.h"
+
+// --- MethodTable ---
+void MethodTable::define(const char* name, NativeMethod::Reader read) {
+    NativeMethod method;
+    method.read = read;
+    methods[SymbolTable::intern(name)] = method;
+}
+
+void MethodTable::define(const char* name, NativeMethod::Mutator mutate) {
+    NativeMethod method;
+    method.mutate = mutate;
+    methods[SymbolTable::intern(name)] = method;
+}
+
+void MethodTable::define(const char* name, NativeMethod::CallingMutator mutate) {
+    NativeMethod method;
+    method.callingMutate = mutate;
+    methods[SymbolTable::intern(name)] = method;
+}
+
+const NativeMethod* MethodTable::find(SymbolId name) const {
+    auto it = methods.find(name);
+    return it == methods.end() ? nullptr : &it->second;
+}
+
+const MethodTable& methodsFor(ValueType type) {
+    static const std::vector<MethodTable> tables = [] {
+        std::vector<MethodTable> built(INVALID + 1);
+        registerStringMethods(built[STRING]);
+        registerListMethods(built[LIST]);
+        return built;
+    }();
+    return tables[type];
+}
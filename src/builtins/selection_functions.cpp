@@ -0,0 +1,231 @@
+#include "builtins.h"
+#include "../types/value.h"
+#include "../environment/environment.h"
+#include "../util/error.h"
+#include "../util/number_format.h"
+#include "../util/sort_kernels.h"
+#include "../util/symbol_table.h"
+#include <algorithm>   // For std::nth_element, std::make_heap, std::sort
+#include <cmath>       // For std::floor, std::isnan
+#include <cstdint>     // For uint32_t
+#include <functional>  // For std::less
+#include <string_view>
+#include <type_traits> // For std::is_same_v
+
+// --- Selection Built-in Functions ---
+// Ranking a few elements out of many without sorting all of them: quickselect
+// (std::nth_element) finds the element at a rank in O(n), and a bounded heap
+// keeps the best k of n in O(n log k). Lists known to be sorted (see
+// ListStorage::sortState) are answered by indexing.
+
+static bool isCount(const MegaladonValue& value) {
+    return value.isNumber() && value.asNumber() >= 0 && std::floor(value.asNumber()) == value.asNumber();
+}
+
+// A count checked by isCount, capped at 'limit'; compared as a double first so
+// that a huge count is never cast
+static size_t countUpTo(const MegaladonValue& value, size_t limit) {
+    return value.asNumber() < static_cast<double>(limit) ? static_cast<size_t>(value.asNumber()) : limit;
+}
+
+// Calls body(keys, less) with a key per value: the numbers, ordered with NaNs
+// last as list.sort() orders them, or views of the strings. The body may
+// reorder 'keys'.
+template <typename Body>
+static void withOrderedKeys(const std::vector<MegaladonValue>& values, const char* caller, Body body) {
+    if (values.empty() || values[0].isNumber()) {
+        std::vector<double> keys;
+        keys.reserve(values.size());
+        for (const auto& value : values) {
+            if (!value.isNumber()) break;
+            keys.push_back(value.asNumber());
+        }
+        if (keys.size() == values.size()) {
+            body(keys, lessNanLast);
+            return;
+        }
+    } else if (values[0].isString()) {
+        std::vector<std::string_view> keys;
+        keys.reserve(values.size());
+        for (const auto& value : values) {
+            if (!value.isString()) break;
+            keys.push_back(value.asString().view());
+        }
+        if (keys.size() == values.size()) {
+            body(keys, std::less<std::string_view>());
+            return;
+        }
+    }
+    throw MegaladonError(std::string(caller) + " needs numbers or strings, not a mix.");
+}
+
+static std::vector<uint32_t> identityOrder(size_t n) {
+    std::vector<uint32_t> order(n);
+    for (size_t i = 0; i < n; ++i) order[i] = static_cast<uint32_t>(i);
+    return order;
+}
+
+// Below this many candidates per kept element, selecting with std::nth_element
+// beats pushing through a heap
+constexpr size_t HEAP_SELECT_RATIO = 8;
+
+// Indexes of the k highest keys, highest first; equal keys keep list order.
+template <typename Key, typename Less>
+static std::vector<uint32_t> topIndexes(const std::vector<Key>& keys, size_t k, Less less) {
+    auto before = [&](uint32_t a, uint32_t b) {
+        if (less(keys[b], keys[a])) return true;
+        return !less(keys[a], keys[b]) && a < b;
+    };
+    size_t n = keys.size();
+    std::vector<uint32_t> top;
+    if (k == 0) return top;
+    if (k * HEAP_SELECT_RATIO < n) {
+        // Max-heap under 'before': the front is the weakest element kept so far
+        top = identityOrder(k);
+        std::make_heap(top.begin(), top.end(), before);
+        for (size_t i = k; i < n; ++i) {
+            if (!before(static_cast<uint32_t>(i), top.front())) continue;
+            std::pop_heap(top.begin(), top.end(), before);
+            top.back() = static_cast<uint32_t>(i);
+            std::push_heap(top.begin(), top.end(), before);
+        }
+    } else {
+        top = identityOrder(n);
+        if (k < n) std::nth_element(top.begin(), top.begin() + k, top.end(), before);
+        top.resize(k);
+    }
+    std::sort(top.begin(), top.end(), before);
+    return top;
+}
+
+// top_k(list, k, [key]) - the k largest elements (by key(element) if given),
+// largest first; ties keep list order and NaNs come after every number
+static MegaladonValue selection_top_k(Interpreter& interpreter, ArgumentSpan args) {
+    if (args.size() < 2 || args.size() > 3 || !args[0].isList() || !isCount(args[1]) ||
+        (args.size() == 3 && !args[2].isFunction())) {
+        throw MegaladonError("top_k(list, k, [key]) expects a list, a non-negative integer and an optional key function.");
+    }
+    // The key is called with one argument
+    if (args.size() == 3 && args[2].asCallable()->arity() != 1 && args[2].asCallable()->arity() != -1) {
+        throw MegaladonError("top_k() key must take 1 argument.");
+    }
+    const ListStorage& storage = *args[0].listStorage();
+    const auto& list = storage.elements;
+    size_t k = countUpTo(args[1], list.size());
+    std::vector<MegaladonValue> result;
+    result.reserve(k);
+
+    if (args.size() == 2 && storage.sortState != ListStorage::SORT_UNKNOWN) {
+        // The largest elements are at the end: take runs of equal elements from
+        // the back, each in list order. Trailing NaNs rank below every number.
+        size_t end = list.size();
+        if (storage.sortState == ListStorage::SORTED_NUMBERS) {
+            while (end > 0 && std::isnan(list[end - 1].asNumber())) --end;
+        }
+        size_t nans = end;
+        while (result.size() < k && end > 0) {
+            size_t start = end - 1;
+            while (start > 0 && list[start - 1] == list[end - 1]) --start;
+            for (size_t i = start; i < end && result.size() < k; ++i) result.push_back(list[i]);
+            end = start;
+        }
+        for (size_t i = nans; i < list.size() && result.size() < k; ++i) result.push_back(list[i]);
+        return MegaladonValue(std::move(result));
+    }
+
+    std::vector<MegaladonValue> keys;
+    if (args.size() == 3) {
+        auto key = args[2].asCallable();
+        keys.reserve(list.size());
+        for (const auto& element : list) keys.push_back(key->fastCall(interpreter, ArgumentSpan(&element, 1)));
+    }
+    std::vector<uint32_t> top;
+    withOrderedKeys(args.size() == 3 ? keys : list, "top_k()", [&](const auto& ranked, auto less) {
+        if constexpr (std::is_same_v<std::decay_t<decltype(ranked)>, std::vector<double>>) {
+            // A NaN score ranks below every number rather than above, as it sorts
+            top = topIndexes(ranked, k, [](double a, double b) { return a == a ? a < b : b == b; });
+        } else {
+            top = topIndexes(ranked, k, less);
+        }
+    });
+    for (uint32_t index : top) result.push_back(list[index]);
+    return MegaladonValue(std::move(result));
+}
+
+// nth(list, n) - the element that sorting the list ascending would put at index n
+static MegaladonValue selection_nth(ArgumentSpan args) {
+    if (args.size() != 2 || !args[0].isList() || !isCount(args[1])) {
+        throw MegaladonError("nth(list, n) expects a list and a non-negative integer.");
+    }
+    const ListStorage& storage = *args[0].listStorage();
+    const auto& list = storage.elements;
+    size_t n = countUpTo(args[1], list.size());
+    if (n >= list.size()) {
+        std::string message = "nth() index ";
+        appendNumber(message, args[1].asNumber());
+        throw MegaladonError(message + " is out of range for a list of " + std::to_string(list.size()) + " elements.");
+    }
+    if (storage.sortState != ListStorage::SORT_UNKNOWN) return list[n];
+
+    MegaladonValue result;
+    withOrderedKeys(list, "nth()", [&](auto& keys, auto less) {
+        if constexpr (std::is_same_v<std::decay_t<decltype(keys)>, std::vector<double>>) {
+            std::nth_element(keys.begin(), keys.begin() + n, keys.end(), less);
+            result = MegaladonValue(keys[n]);
+        } else {
+            std::vector<uint32_t> order = identityOrder(list.size());
+            std::nth_element(order.begin(), order.begin() + n, order.end(),
+                             [&](uint32_t a, uint32_t b) { return less(keys[a], keys[b]); });
+            result = list[order[n]];
+        }
+    });
+    return result;
+}
+
+// partition(list, n) - [the n smallest elements, the rest], each in list order
+static MegaladonValue selection_partition(ArgumentSpan args) {
+    if (args.size() != 2 || !args[0].isList() || !isCount(args[1])) {
+        throw MegaladonError("partition(list, n) expects a list and a non-negative integer.");
+    }
+    const auto& list = args[0].asList();
+    size_t n = countUpTo(args[1], list.size());
+    std::vector<MegaladonValue> low;
+    std::vector<MegaladonValue> high;
+    low.reserve(n);
+    high.reserve(list.size() - n);
+
+    withOrderedKeys(list, "partition()", [&](const auto& keys, auto less) {
+        if (n == list.size()) {
+            low = list;
+            return;
+        }
+        // Everything below the pivot goes low, and as many elements equal to it as fit
+        auto ranked = keys;
+        std::nth_element(ranked.begin(), ranked.begin() + n, ranked.end(), less);
+        auto pivot = ranked[n];
+        size_t below = 0;
+        for (const auto& key : keys) below += less(key, pivot) ? 1 : 0;
+        size_t equalsLow = n - below;
+        for (size_t i = 0; i < list.size(); ++i) {
+            if (less(keys[i], pivot)) {
+                low.push_back(list[i]);
+            } else if (equalsLow > 0 && !less(pivot, keys[i])) {
+                low.push_back(list[i]);
+                --equalsLow;
+            } else {
+                high.push_back(list[i]);
+            }
+        }
+    });
+    std::vector<MegaladonValue> result;
+    result.push_back(MegaladonValue(std::move(low)));
+    result.push_back(MegaladonValue(std::move(high)));
+    return MegaladonValue(std::move(result));
+}
+
+// --- Register Selection Built-in Functions ---
+void registerSelectionBuiltins(std::shared_ptr<Environment>& env) {
+    env->define(SymbolTable::intern("top_k"), MegaladonValue(std::make_shared<NativeFunctionBuiltin>("top_k", -1, selection_top_k)));
+    env->define(SymbolTable::intern("nth"), MegaladonValue(std::make_shared<NativeFunctionBuiltin>("nth", 2, selection_nth)));
+    env->define(SymbolTable::intern("partition"), MegaladonValue(std::make_shared<NativeFunctionBuiltin>("partition", 2, selection_partition)));
+}
@@ -0,0 +1,64 @@
+#include "builtins.h"
+#include "../types/value.h"
+#include "../types/set_value.h"
+#include "../environment/environment.h"
+#include "../util/error.h"
+#include "../util/symbol_table.h"
+
+static const MegaladonSet& setOperand(const MegaladonValue& value, const char* usage) {
+    if (!value.isSet()) {
+        throw MegaladonError(std::string(usage) + " expects set arguments.");
+    }
+    return *value.asSet();
+}
+
+// --- Set Built-in Functions ---
+
+// to_set(list) - drops duplicates, keeps first occurrences in order
+MegaladonValue set_from(ArgumentSpan args) {
+    if (args.size() != 1 || !args[0].isList()) {
+        throw MegaladonError("to_set(list) expects one list argument.");
+    }
+    return MegaladonValue(std::make_shared<MegaladonSet>(args[0].asList()));
+}
+
+// add(set, value) - returns whether 'value' was new
+MegaladonValue set_add(ArgumentSpan args) {
+    if (args.size() != 2 || !args[0].isSet()) {
+        throw MegaladonError("add(set, value) expects a set and a value.");
+    }
+    return MegaladonValue(args[0].asSet()->add(args[1]));
+}
+
+MegaladonValue set_union(ArgumentSpan args) {
+    if (args.size() != 2) {
+        throw MegaladonError("union(a, b) expects two sets.");
+    }
+    return MegaladonValue(setUnion(setOperand(args[0], "union()"), setOperand(args[1], "union()")));
+}
+
+MegaladonValue set_intersection(ArgumentSpan args) {
+    if (args.size() != 2) {
+        throw MegaladonError("intersection(a, b) expects two sets.");
+    }
+    return MegaladonValue(setIntersection(setOperand(args[0], "intersection()"), setOperand(args[1], "intersection()")));
+}
+
+MegaladonValue set_difference(ArgumentSpan args) {
+    if (args.size() != 2) {
+        throw MegaladonError("difference(a, b) expects two sets.");
+    }
+    return MegaladonValue(setDifference(setOperand(args[0], "difference()"), setOperand(args[1], "difference()")));
+}
+
+// --- Register Set Built-ins ---
+void registerSetBuiltins(std::shared_ptr<Environment>& env) {
+    auto define = [&env](const char* name, int arity, NativeFunctionBuiltin::Function function) {
+        env->define(SymbolTable::intern(name), MegaladonValue(std::make_shared<NativeFunctionBuiltin>(name, arity, function)));
+    };
+    define("to_set", 1, set_from);
+    define("add", 2, set_add);
+    define("union", 2, set_union);
+    define("intersection", 2, set_intersection);
+    define("difference", 2, set_difference);
+}
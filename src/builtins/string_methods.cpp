@@ -1,9 +1,10 @@
 #include "builtins.h"
 #include "../types/value.h"
 #include "../util/error.h" // Assuming MegaladonError is defined here
+#include "../util/string_kernels.h"
 #include <string>
-#include <algorithm> // for std::transform, etc.
-#include <cctype>    // for std::tolower, std::toupper
+#include <string_view>
+#include <cctype>    // for std::isspace
 #include <cmath>     // for std::fmod
 
 // --- String Built-in Functions ---
@@ -20,7 +21,7 @@ MegaladonValue string_substring(const std::vector<MegaladonValue>& args) {
     if (args.size() < 2 || args.size() > 3 || !args[0].isString() || !args[1].isNumber()) {
         throw MegaladonError("String.substring(startIndex, [endIndex]) expects string, start_index (number), and optional end_index (number).");
     }
-    std::string s = args[0].asString();
+    const MegaladonString& s = args[0].asString();
     size_t start = static_cast<size_t>(args[1].asNumber());
     size_t end = s.length(); // Default to end of string
 
@@ -35,7 +36,7 @@ MegaladonValue string_substring(const std::vector<MegaladonValue>& args) {
     if (end > s.length()) end = s.length();
     if (start > end) return MegaladonValue("");
 
-    return MegaladonValue(s.substr(start, end - start));
+    return MegaladonValue(s.substr(start, end - start)); // Shares the parent buffer
 }
 
 MegaladonValue string_to_lower(const std::vector<MegaladonValue>& args) {
@@ -43,10 +44,10 @@ MegaladonValue string_to_lower(const std::vector<MegaladonValue>& args) {
     if (args.size() != 1 || !args[0].isString()) {
         throw MegaladonError("String.to_lower() expects one string argument.");
     }
-    std::string s = args[0].asString();
-    std::transform(s.begin(), s.end(), s.begin(),
-                   [](unsigned char c){ return static_cast<char>(std::tolower(c)); });
-    return MegaladonValue(s);
+    std::string_view source = args[0].asString().view();
+    std::string s(source.size(), '\0');
+    kernelAsciiLower(source.data(), s.data(), source.size());
+    return MegaladonValue(std::move(s));
 }
 
 MegaladonValue string_to_upper(const std::vector<MegaladonValue>& args) {
@@ -54,10 +55,10 @@ MegaladonValue string_to_upper(const std::vector<MegaladonValue>& args) {
     if (args.size() != 1 || !args[0].isString()) {
         throw MegaladonError("String.to_upper() expects one string argument.");
     }
-    std::string s = args[0].asString();
-    std::transform(s.begin(), s.end(), s.begin(),
-                   [](unsigned char c){ return static_cast<char>(std::toupper(c)); });
-    return MegaladonValue(s);
+    std::string_view source = args[0].asString().view();
+    std::string s(source.size(), '\0');
+    kernelAsciiUpper(source.data(), s.data(), source.size());
+    return MegaladonValue(std::move(s));
 }
 
 MegaladonValue string_trim(const std::vector<MegaladonValue>& args) {
@@ -65,16 +66,14 @@ MegaladonValue string_trim(const std::vector<MegaladonValue>& args) {
     if (args.size() != 1 || !args[0].isString()) {
         throw MegaladonError("String.trim() expects one string argument.");
     }
-    std::string s = args[0].asString();
+    const MegaladonString& s = args[0].asString();
+    size_t first = 0;
+    size_t last = s.length();
     // Trim leading whitespace
-    s.erase(s.begin(), std::find_if(s.begin(), s.end(), [](unsigned char ch) {
-        return !std::isspace(ch);
-    }));
+    while (first < last && std::isspace(static_cast<unsigned char>(s[first]))) first++;
     // Trim trailing whitespace
-    s.erase(std::find_if(s.rbegin(), s.rend(), [](unsigned char ch) {
-        return !std::isspace(ch);
-    }).base(), s.end());
-    return MegaladonValue(s);
+    while (last > first && std::isspace(static_cast<unsigned char>(s[last - 1]))) last--;
+    return MegaladonValue(s.substr(first, last - first));
 }
 
 MegaladonValue string_starts_with(const std::vector<MegaladonValue>& args) {
@@ -82,8 +81,8 @@ MegaladonValue string_starts_with(const std::vector<MegaladonValue>& args) {
     if (args.size() != 2 || !args[0].isString() || !args[1].isString()) {
         throw MegaladonError("String.starts_with(prefix) expects two string arguments.");
     }
-    const std::string& str = args[0].asString();
-    const std::string& prefix = args[1].asString();
+    std::string_view str = args[0].asString().view();
+    std::string_view prefix = args[1].asString().view();
     return MegaladonValue(str.rfind(prefix, 0) == 0);
 }
 
@@ -92,8 +91,8 @@ MegaladonValue string_ends_with(const std::vector<MegaladonValue>& args) {
     if (args.size() != 2 || !args[0].isString() || !args[1].isString()) {
         throw MegaladonError("String.ends_with(suffix) expects two string arguments.");
     }
-    const std::string& str = args[0].asString();
-    const std::string& suffix = args[1].asString();
+    std::string_view str = args[0].asString().view();
+    std::string_view suffix = args[1].asString().view();
     if (str.length() < suffix.length()) return MegaladonValue(false);
     return MegaladonValue(str.compare(str.length() - suffix.length(), suffix.length(), suffix) == 0);
 }
@@ -103,9 +102,9 @@ MegaladonValue string_contains(const std::vector<MegaladonValue>& args) {
     if (args.size() != 2 || !args[0].isString() || !args[1].isString()) {
         throw MegaladonError("String.contains(substring) expects two string arguments.");
     }
-    const std::string& str = args[0].asString();
-    const std::string& substr = args[1].asString();
-    return MegaladonValue(str.find(substr) != std::string::npos);
+    std::string_view str = args[0].asString().view();
+    std::string_view substr = args[1].asString().view();
+    return MegaladonValue(kernelFind(str, substr) != std::string_view::npos);
 }
 
 MegaladonValue string_replace(const std::vector<MegaladonValue>& args) {
@@ -113,16 +112,27 @@ MegaladonValue string_replace(const std::vector<MegaladonValue>& args) {
     if (args.size() != 3 || !args[0].isString() || !args[1].isString() || !args[2].isString()) {
         throw MegaladonError("String.replace(old, new) expects three string arguments: original, old_substring, new_substring.");
     }
-    std::string str = args[0].asString();
-    const std::string& old_substr = args[1].asString();
-    const std::string& new_substr = args[2].asString();
+    const MegaladonString& original = args[0].asString();
+    std::string_view str = original.view();
+    std::string_view old_substr = args[1].asString().view();
+    std::string_view new_substr = args[2].asString().view();
 
+    size_t occurrences = old_substr.empty() ? 0 : kernelCount(str, old_substr);
+    if (occurrences == 0) {
+        return MegaladonValue(original); // Nothing to replace, share the original
+    }
+
+    std::string result;
+    result.reserve(str.length() - occurrences * old_substr.length() + occurrences * new_substr.length());
+    size_t last = 0;
     size_t pos = 0;
-    while ((pos = str.find(old_substr, pos)) != std::string::npos) {
-        str.replace(pos, old_substr.length(), new_substr);
-        pos += new_substr.length(); // Advance position by new_substr length
+    while ((pos = kernelFind(str, old_substr, last)) != std::string_view::npos) {
+        result.append(str.data() + last, pos - last);
+        result.append(new_substr.data(), new_substr.length());
+        last = pos + old_substr.length(); // Continue after the replaced occurrence
     }
-    return MegaladonValue(str);
+    result.append(str.data() + last, str.length() - last);
+    return MegaladonValue(std::move(result));
 }
 
 MegaladonValue string_split(const std::vector<MegaladonValue>& args) {
@@ -130,29 +140,30 @@ MegaladonValue string_split(const std::vector<MegaladonValue>& args) {
     if (args.size() < 1 || args.size() > 2 || !args[0].isString()) {
         throw MegaladonError("String.split([delimiter]) expects string and optional delimiter (string).");
     }
-    std::string s = args[0].asString();
-    std::string delimiter = (args.size() == 2 && args[1].isString()) ? args[1].asString() : " "; // Default delimiter is space
+    const MegaladonString& s = args[0].asString();
+    std::string_view delimiter = (args.size() == 2 && args[1].isString()) ? args[1].asString().view() : " "; // Default delimiter is space
 
     std::vector<MegaladonValue> result_list;
-    size_t pos = 0;
-    std::string token;
     // Handle empty delimiter edge case (splits into chars)
     if (delimiter.empty()) {
-        for(char c : s) {
-            result_list.push_back(MegaladonValue(std::string(1, c)));
+        result_list.reserve(s.length());
+        for (size_t i = 0; i < s.length(); ++i) {
+            result_list.push_back(MegaladonValue(s.substr(i, 1)));
         }
-        return MegaladonValue(result_list);
+        return MegaladonValue(std::move(result_list));
     }
 
-    // Standard splitting
-    while ((pos = s.find(delimiter)) != std::string::npos) {
-        token = s.substr(0, pos);
-        result_list.push_back(MegaladonValue(token));
-        s.erase(0, pos + delimiter.length());
+    // Standard splitting; every part is a slice of the original string
+    std::string_view view = s.view();
+    size_t start = 0;
+    size_t pos = 0;
+    while ((pos = kernelFind(view, delimiter, start)) != std::string_view::npos) {
+        result_list.push_back(MegaladonValue(s.substr(start, pos - start)));
+        start = pos + delimiter.length();
     }
-    result_list.push_back(MegaladonValue(s)); // Add the last part
+    result_list.push_back(MegaladonValue(s.substr(start))); // Add the last part
 
-    return MegaladonValue(result_list);
+    return MegaladonValue(std::move(result_list));
 }
 
 MegaladonValue string_index_of(const std::vector<MegaladonValue>& args) {
@@ -160,8 +171,8 @@ MegaladonValue string_index_of(const std::vector<MegaladonValue>& args) {
     if (args.size() < 2 || args.size() > 3 || !args[0].isString() || !args[1].isString()) {
         throw MegaladonError("String.index_of(substring, [startIndex]) expects string, substring (string), and optional start_index (number).");
     }
-    const std::string& str = args[0].asString();
-    const std::string& substr = args[1].asString();
+    std::string_view str = args[0].asString().view();
+    std::string_view substr = args[1].asString().view();
     size_t start_pos = 0;
     if (args.size() == 3) {
         if (!args[2].isNumber()) {
@@ -170,8 +181,8 @@ MegaladonValue string_index_of(const std::vector<MegaladonValue>& args) {
         start_pos = static_cast<size_t>(args[2].asNumber());
     }
 
-    size_t found_pos = str.find(substr, start_pos);
-    if (found_pos != std::string::npos) {
+    size_t found_pos = kernelFind(str, substr, start_pos);
+    if (found_pos != std::string_view::npos) {
         return MegaladonValue(static_cast<double>(found_pos));
     } else {
         return MegaladonValue(-1.0); // -1 if not found
@@ -183,12 +194,13 @@ MegaladonValue string_to_list(const std::vector<MegaladonValue>& args) {
     if (args.size() != 1 || !args[0].isString()) {
         throw MegaladonError("String.to_list() expects one string argument.");
     }
-    std::string s = args[0].asString();
+    const MegaladonString& s = args[0].asString();
     std::vector<MegaladonValue> char_list;
-    for (char c : s) {
-        char_list.push_back(MegaladonValue(std::string(1, c)));
+    char_list.reserve(s.length());
+    for (size_t i = 0; i < s.length(); ++i) {
+        char_list.push_back(MegaladonValue(s.substr(i, 1)));
     }
-    return MegaladonValue(char_list);
+    return MegaladonValue(std::move(char_list));
 }
 
 MegaladonValue string_count_vowels(const std::vector<MegaladonValue>& args) {
@@ -196,13 +208,22 @@ MegaladonValue string_count_vowels(const std::vector<MegaladonValue>& args) {
     if (args.size() != 1 || !args[0].isString()) {
         throw MegaladonError("String.count_vowels() expects one string argument.");
     }
-    std::string s = args[0].asString();
-    int vowels = 0;
-    for (char c : s) {
-        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c))); // Correct usage of tolower
-        if (c == 'a' || c == 'e' || c == 'i' || c == 'o' || c == 'u') {
-            vowels++;
-        }
-    }
-    return MegaladonValue(static_cast<double>(vowels));
-}
\ No newline at end of file
+    return MegaladonValue(static_cast<double>(kernelCountAnyOf(args[0].asString().view(), "aeiouAEIOU")));
+}
+
+// --- Register String Methods ---
+void registerStringMethods(MethodTable& table) {
+    table.define("len", string_len);
+    table.define("substring", string_substring);
+    table.define("to_lower", string_to_lower);
+    table.define("to_upper", string_to_upper);
+    table.define("trim", string_trim);
+    table.define("starts_with", string_starts_with);
+    table.define("ends_with", string_ends_with);
+    table.define("contains", string_contains);
+    table.define("replace", string_replace);
+    table.define("split", string_split);
+    table.define("index_of", string_index_of);
+    table.define("to_list", string_to_list);
+    table.define("count_vowels", string_count_vowels);
+}
@@ -0,0 +1,152 @@
+#include "builtins.h"
+#include "../types/value.h"
+#include "../types/numeric_array.h"
+#include "../types/tensor_value.h"
+#include "../environment/environment.h"
+#include "../util/error.h"
+#include "../util/numeric_kernels.h"
+#include "../util/symbol_table.h"
+#include <algorithm> // For std::copy
+#include <cmath>     // For std::fmod
+#include <cstdint>   // For SIZE_MAX
+
+static const Tensor& tensorArgument(const MegaladonValue& value, const char* usage) {
+    if (!value.isTensor()) {
+        throw MegaladonError(std::string(usage) + " expects a tensor.");
+    }
+    return *value.asTensor();
+}
+
+// Lengths down the first elements of a nested list: [[1, 2, 3], [4, 5, 6]] is (2, 3)
+static std::vector<size_t> nestedShape(const MegaladonValue& value) {
+    std::vector<size_t> shape;
+    const MegaladonValue* level = &value;
+    while (level->isList()) {
+        const auto& list = level->asList();
+        shape.push_back(list.size());
+        if (list.empty()) break;
+        level = &list[0];
+    }
+    return shape;
+}
+
+// Copies the numbers of a nested list in row-major order, checking that every
+// level has the length 'shape' expects
+static void copyNested(const MegaladonValue& value, const std::vector<size_t>& shape, size_t axis, double*& out) {
+    if (axis == shape.size()) {
+        if (!value.isNumber()) {
+            throw MegaladonError("tensor() expects a nested list of numbers.");
+        }
+        *out++ = value.asNumber();
+        return;
+    }
+    if (!value.isList() || value.asList().size() != shape[axis]) {
+        throw MegaladonError("tensor() rows must all have the same shape.");
+    }
+    for (const auto& element : value.asList()) {
+        copyNested(element, shape, axis + 1, out);
+    }
+}
+
+// --- Tensor Built-in Functions ---
+
+// tensor(nested list) / tensor(array) / tensor(tensor) - always a new buffer
+MegaladonValue tensor_new(ArgumentSpan args) {
+    const MegaladonValue& source = args[0];
+    if (source.isTensor()) {
+        const Tensor& original = *source.asTensor();
+        auto copy = std::make_shared<Tensor>(original.shape());
+        std::copy(original.data(), original.data() + original.size(), copy->data());
+        return MegaladonValue(copy);
+    }
+    if (source.isArray()) {
+        const auto& values = source.asArray()->values;
+        auto copy = std::make_shared<Tensor>(std::vector<size_t>{values.size()});
+        std::copy(values.begin(), values.end(), copy->data());
+        return MegaladonValue(copy);
+    }
+    if (!source.isList()) {
+        throw MegaladonError("tensor() expects a nested list of numbers, an array or a tensor.");
+    }
+    std::vector<size_t> shape = nestedShape(source);
+    auto tensor = std::make_shared<Tensor>(shape);
+    double* out = tensor->data();
+    copyNested(source, shape, 0, out);
+    return MegaladonValue(tensor);
+}
+
+// reshape(tensor, shape) - a view with the same elements; one dimension may be -1
+MegaladonValue tensor_reshape(ArgumentSpan args) {
+    const Tensor& tensor = tensorArgument(args[0], "reshape(tensor, shape)");
+    if (!args[1].isList() || args[1].asList().empty()) {
+        throw MegaladonError("reshape() shape must be a non-empty list of dimensions.");
+    }
+    std::vector<size_t> shape;
+    size_t inferred = SIZE_MAX;
+    size_t known = 1;
+    for (const auto& dimension : args[1].asList()) {
+        double number = dimension.isNumber() ? dimension.asNumber() : 0.5;
+        if (number == -1 && inferred == SIZE_MAX) {
+            inferred = shape.size();
+            shape.push_back(0);
+            continue;
+        }
+        if (!(number >= 0 && number < 9.0e18) || std::fmod(number, 1.0) != 0.0) {
+            throw MegaladonError("reshape() dimensions must be non-negative integers (or a single -1).");
+        }
+        shape.push_back(static_cast<size_t>(number));
+        if (shape.back() != 0 && known > SIZE_MAX / shape.back()) {
+            throw MegaladonError("reshape() shape has too many elements.");
+        }
+        known *= shape.back();
+    }
+    if (inferred != SIZE_MAX) {
+        if (known == 0 || tensor.size() % known != 0) {
+            throw MegaladonError("Cannot reshape a tensor of shape " + Tensor::shapeString(tensor.shape()) + " into " +
+                                 Tensor::shapeString(shape) + ".");
+        }
+        shape[inferred] = tensor.size() / known;
+    }
+    return MegaladonValue(tensor.reshaped(std::move(shape)));
+}
+
+// shape(tensor) - list of dimensions
+MegaladonValue tensor_shape(ArgumentSpan args) {
+    const Tensor& tensor = tensorArgument(args[0], "shape(tensor)");
+    std::vector<MegaladonValue> dimensions;
+    for (size_t dimension : tensor.shape()) {
+        dimensions.push_back(MegaladonValue(static_cast<double>(dimension)));
+    }
+    return MegaladonValue(std::move(dimensions));
+}
+
+// matmul(a, b) - matrix product; two 1-D tensors give their dot product
+MegaladonValue tensor_matmul(ArgumentSpan args) {
+    const Tensor& a = tensorArgument(args[0], "matmul(a, b)");
+    const Tensor& b = tensorArgument(args[1], "matmul(a, b)");
+    if (a.rank() == 1 && b.rank() == 1) {
+        if (a.size() != b.size()) {
+            throw MegaladonError("matmul() operands must have the same length.");
+        }
+        return MegaladonValue(kernelDot(a.data(), b.data(), a.size()));
+    }
+    return MegaladonValue(tensorMatmul(a, b));
+}
+
+// transpose(tensor) - swaps the last two axes
+MegaladonValue tensor_transpose(ArgumentSpan args) {
+    tensorArgument(args[0], "transpose(tensor)");
+    return MegaladonValue(tensorTranspose(args[0].asTensor()));
+}
+
+// --- Register Tensor Built-ins ---
+void registerTensorBuiltins(std::shared_ptr<Environment>& env) {
+    auto define = [&env](const char* name, int arity, NativeFunctionBuiltin::Function function) {
+        env->define(SymbolTable::intern(name), MegaladonValue(std::make_shared<NativeFunctionBuiltin>(name, arity, function)));
+    };
+    define("tensor", 1, tensor_new);
+    define("reshape", 2, tensor_reshape);
+    define("shape", 1, tensor_shape);
+    define("matmul", 2, tensor_matmul);
+    define("transpose", 1, tensor_transpose);
+}
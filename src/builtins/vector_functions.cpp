@@ -0,0 +1,84 @@
+#include "builtins.h"
+#include "../types/value.h"
+#include "../types/persistent_vector.h"
+#include "../types/iterable.h"
+#include "../environment/environment.h"
+#include "../util/error.h"
+#include "../util/symbol_table.h"
+#include <cmath> // For std::fmod
+
+static const std::shared_ptr<const PersistentVector>& vectorArgument(ArgumentSpan args, const char* usage) {
+    if (args.empty() || !args[0].isVector()) {
+        throw MegaladonError(std::string(usage) + " expects a vector as its first argument.");
+    }
+    return args[0].asVector();
+}
+
+// --- Vector Built-in Functions ---
+// Vectors never change; push and assoc return a new vector that shares
+// everything but the touched leaf with the old one, so keeping old versions
+// around (snapshots, undo history) is cheap.
+
+// vec() / vec(list) / vec(iterable)
+MegaladonValue vector_from(ArgumentSpan args) {
+    if (args.empty()) {
+        return MegaladonValue(PersistentVector::fromValues({}));
+    }
+    if (args.size() != 1) {
+        throw MegaladonError("vec([items]) expects at most one argument.");
+    }
+    if (args[0].isList()) {
+        return MegaladonValue(PersistentVector::fromValues(args[0].asList()));
+    }
+    if (args[0].isVector()) {
+        return args[0];
+    }
+    auto iterator = iterateValue(args[0]);
+    if (!iterator) {
+        throw MegaladonError("vec() expects a list or another iterable value.");
+    }
+    std::vector<MegaladonValue> items;
+    MegaladonValue item;
+    while (iterator->next(item)) {
+        items.push_back(item);
+    }
+    return MegaladonValue(PersistentVector::fromValues(items));
+}
+
+// push(vector, value) - new vector with 'value' appended, O(1) amortized
+MegaladonValue vector_push(ArgumentSpan args) {
+    if (args.size() != 2) {
+        throw MegaladonError("push(vector, value) expects two arguments.");
+    }
+    return MegaladonValue(vectorArgument(args, "push()")->push(args[1]));
+}
+
+// assoc(vector, index, value) - new vector with one element replaced, O(log32 n).
+// Index len(vector) appends, like push.
+MegaladonValue vector_assoc(ArgumentSpan args) {
+    if (args.size() != 3) {
+        throw MegaladonError("assoc(vector, index, value) expects three arguments.");
+    }
+    const auto& vector = vectorArgument(args, "assoc()");
+    if (!args[1].isNumber() || std::fmod(args[1].asNumber(), 1.0) != 0.0) {
+        throw MegaladonError("assoc() index must be an integer.");
+    }
+    double index = args[1].asNumber();
+    if (index < 0 || index > static_cast<double>(vector->size())) {
+        throw MegaladonError("assoc() index out of bounds.");
+    }
+    if (static_cast<size_t>(index) == vector->size()) {
+        return MegaladonValue(vector->push(args[2]));
+    }
+    return MegaladonValue(vector->set(static_cast<size_t>(index), args[2]));
+}
+
+// --- Register Vector Built-ins ---
+void registerVectorBuiltins(std::shared_ptr<Environment>& env) {
+    auto define = [&env](const char* name, int arity, NativeFunctionBuiltin::Function function) {
+        env->define(SymbolTable::intern(name), MegaladonValue(std::make_shared<NativeFunctionBuiltin>(name, arity, function)));
+    };
+    define("vec", -1, vector_from);
+    define("push", 2, vector_push);
+    define("assoc", 3, vector_assoc);
+}
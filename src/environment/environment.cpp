@@ -1,46 +1,117 @@
 #include "environment.h"
 #include "../util/error.h" // Assuming MegaladonError is defined here
 
+// Tokens built outside the lexer may not carry an interned id yet
+static SymbolId symbolOf(const Token& token) {
+    return token.symbol != NO_SYMBOL ? token.symbol : SymbolTable::intern(token.lexeme);
+}
+
 Environment::Environment() : enclosing(nullptr) {}
 
-Environment::Environment(std::shared_ptr<Environment> enclosing) : enclosing(std::move(enclosing)) {}
+Environment::Environment(std::shared_ptr<Environment> enclosing, const PoolAllocator<char>& allocator)
+    : names(allocator), values(allocator), slotIndex(allocator), enclosing(std::move(enclosing)) {}
 
-void Environment::define(const std::string& name, const MegaladonValue& value) {
-    values[name] = value;
+MegaladonValue* Environment::find(SymbolId name) {
+    if (!slotIndex.empty()) {
+        if (name < slotIndex.size() && slotIndex[name] != 0) {
+            return &values[slotIndex[name] - 1];
+        }
+        return nullptr;
+    }
+    if (nameIndex.size() != 0) {
+        uint32_t entry = nameIndex.find(name, [&](uint32_t i) { return names[i] == name; });
+        return entry == HashIndex::NOT_FOUND ? nullptr : &values[entry];
+    }
+    for (size_t i = 0; i < names.size(); ++i) {
+        if (names[i] == name) return &values[i];
+    }
+    return nullptr;
 }
 
-MegaladonValue Environment::get(const Token& name) {
-    if (values.count(name.lexeme)) {
-        return values.at(name.lexeme);
+void Environment::define(SymbolId name, const MegaladonValue& value) {
+    if (name == NO_SYMBOL) {
+        // Not an index: slotIndex would be sized to name + 1, which wraps to 0
+        throw std::runtime_error("MegaladonError: Internal error: Defining a variable without a symbol id.");
     }
+    if (MegaladonValue* slot = find(name)) {
+        *slot = value; // Redefinition in the same scope overwrites
+        return;
+    }
+
+    names.push_back(name);
+    values.push_back(value);
 
-    if (enclosing != nullptr) {
-        return enclosing->get(name);
+    if (names.size() <= INDEX_THRESHOLD) return;
+    if (enclosing) {
+        auto idOf = [this](uint32_t i) { return static_cast<size_t>(names[i]); };
+        if (nameIndex.size() == 0) {
+            // Scope just outgrew the linear scan: index every existing variable
+            nameIndex.rebuild(static_cast<uint32_t>(names.size()), idOf);
+        } else {
+            nameIndex.insert(name, static_cast<uint32_t>(names.size() - 1), idOf);
+        }
+    } else if (slotIndex.empty()) {
+        for (size_t i = 0; i < names.size(); ++i) {
+            if (names[i] >= slotIndex.size()) slotIndex.resize(names[i] + 1, 0);
+            slotIndex[names[i]] = static_cast<uint32_t>(i + 1);
+        }
+    } else {
+        if (name >= slotIndex.size()) slotIndex.resize(name + 1, 0);
+        slotIndex[name] = static_cast<uint32_t>(names.size());
     }
+}
 
-    throw MegaladonError(name, "Undefined variable '" + name.lexeme + "'.");
+void Environment::define(const Token& name, const MegaladonValue& value) {
+    define(symbolOf(name), value);
 }
 
-void Environment::assign(const Token& name, const MegaladonValue& value) {
-    if (values.count(name.lexeme)) {
-        values[name.lexeme] = value;
-        return;
+MegaladonValue Environment::get(const Token& name) {
+    SymbolId id = symbolOf(name);
+    for (Environment* scope = this; scope != nullptr; scope = scope->enclosing.get()) {
+        if (MegaladonValue* slot = scope->find(id)) {
+            return *slot;
+        }
     }
 
-    if (enclosing != nullptr) {
-        enclosing->assign(name, value);
-        return;
+    throw MegaladonError(name, "Undefined variable '" + name.lexeme + "'.");
+}
+
+void Environment::assign(const Token& name, const MegaladonValue& value) {
+    SymbolId id = symbolOf(name);
+    for (Environment* scope = this; scope != nullptr; scope = scope->enclosing.get()) {
+        if (MegaladonValue* slot = scope->find(id)) {
+            *slot = value;
+            return;
+        }
     }
 
     throw MegaladonError(name, "Undefined variable '" + name.lexeme + "'.");
 }
 
-MegaladonValue Environment::getAt(int distance, const std::string& name) {
-    return ancestor(distance)->values.at(name);
+MegaladonValue Environment::getAt(int distance, SymbolId name) {
+    MegaladonValue* slot = ancestor(distance)->find(name);
+    if (slot == nullptr) {
+        throw std::runtime_error("MegaladonError: Internal error: Resolved variable '" + SymbolTable::name(name) + "' not found.");
+    }
+    return *slot;
 }
 
 void Environment::assignAt(int distance, const Token& name, const MegaladonValue& value) {
-    ancestor(distance)->values[name.lexeme] = value;
+    ancestor(distance)->define(symbolOf(name), value);
+}
+
+MegaladonValue* Environment::slot(const Token& name) {
+    SymbolId id = symbolOf(name);
+    for (Environment* scope = this; scope != nullptr; scope = scope->enclosing.get()) {
+        if (MegaladonValue* slot = scope->find(id)) {
+            return slot;
+        }
+    }
+    return nullptr;
+}
+
+MegaladonValue* Environment::slotAt(int distance, SymbolId name) {
+    return ancestor(distance)->find(name);
 }
 
 std::shared_ptr<Environment> Environment::ancestor(int distance) {
@@ -53,4 +124,26 @@ std::shared_ptr<Environment> Environment::ancestor(int distance) {
         environment = environment->enclosing;
     }
     return environment;
-}
\ No newline at end of file
+}
+
+void Environment::traceReferences(const std::function<void(HeapObject*)>& visit) {
+    if (enclosing) visit(enclosing.get());
+    for (const auto& value : values) {
+        traceValue(value, visit);
+    }
+}
+
+void Environment::clearReferences() {
+    // Move everything out first so destructors never see a half-cleared scope
+    auto dropped = std::move(values);
+    std::shared_ptr<Environment> parent = std::move(enclosing);
+    values.clear();
+    names.clear();
+    slotIndex.clear();
+    nameIndex.clear();
+}
+
+size_t Environment::approximateSize() const {
+    return sizeof(Environment) + names.capacity() * sizeof(SymbolId) +
+           values.capacity() * sizeof(MegaladonValue) + slotIndex.capacity() * sizeof(uint32_t) + nameIndex.approximateSize();
+}
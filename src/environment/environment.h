@@ -1,27 +1,55 @@
 #pragma once
 
 #include <string>
-#include <map>
+#include <vector>
+#include <cstdint> // For uint32_t
 #include <memory> // For std::shared_ptr, std::enable_shared_from_this
 #include "../types/value.h" // For MegaladonValue
 #include "../lexer/token.h" // For Token
+#include "../util/symbol_table.h" // For SymbolId
+#include "../util/hash_index.h" // For HashIndex
+#include "../memory/heap.h" // For HeapObject
+#include "../memory/pool_allocator.h" // For PoolAllocator
 
-class Environment : public std::enable_shared_from_this<Environment> {
+class Environment : public std::enable_shared_from_this<Environment>, public HeapObject {
 public:
     Environment();
-    Environment(std::shared_ptr<Environment> enclosing);
+    // 'allocator' serves the scope's variable storage (the interpreter passes its pool)
+    Environment(std::shared_ptr<Environment> enclosing, const PoolAllocator<char>& allocator = PoolAllocator<char>());
 
-    void define(const std::string& name, const MegaladonValue& value);
+    void define(SymbolId name, const MegaladonValue& value);
+    void define(const Token& name, const MegaladonValue& value); // Interns the name if the token carries no id
     MegaladonValue get(const Token& name);
     void assign(const Token& name, const MegaladonValue& value);
 
     // For local variable resolution
-    MegaladonValue getAt(int distance, const std::string& name);
+    MegaladonValue getAt(int distance, SymbolId name);
     void assignAt(int distance, const Token& name, const MegaladonValue& value);
 
     std::shared_ptr<Environment> ancestor(int distance);
 
+    // The variable's own storage, for updating its value in place (nullptr if undefined).
+    // Only valid until the next define() in the scope that holds it.
+    MegaladonValue* slot(const Token& name);
+    MegaladonValue* slotAt(int distance, SymbolId name);
+
+    // HeapObject: the parent scope and any closures stored in variables
+    void traceReferences(const std::function<void(HeapObject*)>& visit) override;
+    void clearReferences() override;
+    size_t approximateSize() const override;
+
 private:
-    std::map<std::string, MegaladonValue> values;
+    // Scopes with more variables than this also keep an index: the global scope a
+    // direct id -> slot array (sized to the largest id it holds), other scopes a
+    // hash index, since growing an array to a global symbol id per call is O(#symbols)
+    static constexpr size_t INDEX_THRESHOLD = 8;
+
+    MegaladonValue* find(SymbolId name); // Slot for 'name' in this scope only, or nullptr
+
+    // Variables in definition order. Lookups compare integer symbol ids, never strings.
+    std::vector<SymbolId, PoolAllocator<SymbolId>> names;
+    std::vector<MegaladonValue, PoolAllocator<MegaladonValue>> values;
+    std::vector<uint32_t, PoolAllocator<uint32_t>> slotIndex; // Global scope: symbol id -> slot + 1 (0 = not defined here)
+    HashIndex nameIndex; // Other scopes: symbol id -> slot
     std::shared_ptr<Environment> enclosing; // Pointer to the parent environment
-};
\ No newline at end of file
+};
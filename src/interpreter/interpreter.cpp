@@ -1,18 +1,43 @@
 #include "interpreter.h"
-#include "../builtins/builtins.h" // For registerBuiltins
+#include "../builtins/builtins.h" // For registerBuiltins, printLine, newMap
 #include "../util/error.h"
+#include "../util/output_buffer.h"
+#include "../types/numeric_array.h" // For element-wise array operators
+#include "../types/map_value.h"
+#include "../types/iterable.h" // For iterateValue
+#include "../types/persistent_vector.h"
+#include "../types/tensor_value.h"
 #include <iostream>
 #include <string> // For std::stod
+#include <algorithm> // For std::max
+#include <cstdint> // For int64_t
+#include <utility> // For std::exchange
 
 // Constructor
-Interpreter::Interpreter() {
+Interpreter::Interpreter() : pool(std::make_shared<MemoryPool>()) {
     globals = std::make_shared<Environment>();
+    heap.track(globals);
     environment = globals; // Current environment starts as global
 
     // Register built-in functions
     registerBuiltins(globals);
 }
 
+Interpreter::~Interpreter() {
+    // Functions stored in the scopes they close over form cycles; break them all
+    environment.reset();
+    globals.reset();
+    heap.releaseAll();
+}
+
+std::shared_ptr<Environment> Interpreter::newEnvironment(std::shared_ptr<Environment> enclosing) {
+    // Both the scope object and its variable storage come from the interpreter's pool
+    auto scope = std::allocate_shared<Environment>(PoolAllocator<Environment>(pool), std::move(enclosing),
+                                                   PoolAllocator<char>(pool));
+    heap.track(scope);
+    return scope;
+}
+
 // Main interpretation loop
 void Interpreter::interpret(const std::vector<std::shared_ptr<Stmt>>& statements) {
     try {
@@ -21,9 +46,11 @@ void Interpreter::interpret(const std::vector<std::shared_ptr<Stmt>>& statements
         }
     } catch (const MegaladonError& e) {
         // You would typically report this error to the user
+        OutputBuffer::standardOutput().flush(); // So the error follows the output before it
         std::cerr << "Runtime Error: " << e.what() << "\n";
         // Optionally, reset state or exit
     } catch (const std::runtime_error& e) {
+        OutputBuffer::standardOutput().flush();
         std::cerr << "Internal Runtime Error: " << e.what() << "\n";
     }
 }
@@ -96,6 +123,10 @@ MegaladonValue Interpreter::visit(std::shared_ptr<BinaryExpr> expr) {
     MegaladonValue left = evaluate(expr->left);
     MegaladonValue right = evaluate(expr->right);
 
+    if (left.isArray() || right.isArray() || left.isTensor() || right.isTensor()) {
+        return arrayBinary(expr->op, left, right);
+    }
+
     switch (expr->op.type) {
         case TokenType::GREATER:
             checkNumberOperands(expr->op, left, right);
@@ -117,15 +148,19 @@ MegaladonValue Interpreter::visit(std::shared_ptr<BinaryExpr> expr) {
                 return MegaladonValue(left.asNumber() + right.asNumber());
             }
             if (left.isString() && right.isString()) {
-                return MegaladonValue(left.asString() + right.asString());
+                return MegaladonValue(MegaladonString::concat(left.asString(), right.asString()));
             }
             if (left.isList() && right.isList()) {
                 std::vector<MegaladonValue> newList = left.asList();
                 const auto& rightList = right.asList();
                 newList.insert(newList.end(), rightList.begin(), rightList.end());
-                return MegaladonValue(newList);
+                return MegaladonValue(std::move(newList));
+            }
+            if (left.isVector() && right.isVector()) {
+                // Shares the whole left side; only the right side's elements are copied
+                return MegaladonValue(left.asVector()->concat(*right.asVector()));
             }
-            throw MegaladonError(expr->op, "Operands must be two numbers, two strings, or two lists.");
+            throw MegaladonError(expr->op, "Operands must be two numbers, two strings, two lists or two vectors.");
         case TokenType::SLASH:
             checkNumberOperands(expr->op, left, right);
             if (right.asNumber() == 0) {
@@ -145,25 +180,102 @@ MegaladonValue Interpreter::visit(std::shared_ptr<BinaryExpr> expr) {
     }
 }
 
-MegaladonValue Interpreter::visit(std::shared_ptr<CallExpr> expr) {
-    MegaladonValue callee = evaluate(expr->callee);
+// Element-wise arithmetic and comparisons on numeric arrays and tensors run as
+// SIMD kernels. One side may be a plain number, which is broadcast to every
+// element; two tensors are broadcast against each other by shape.
+MegaladonValue Interpreter::arrayBinary(const Token& op, const MegaladonValue& left, const MegaladonValue& right) {
+    if (op.type == TokenType::EQUAL_EQUAL) return MegaladonValue(isEqual(left, right));
+    if (op.type == TokenType::BANG_EQUAL) return MegaladonValue(!isEqual(left, right));
+
+    ArithmeticOp arithmetic = ArithmeticOp::ADD;
+    CompareOp comparison = CompareOp::LESS;
+    bool isComparison = false;
+    switch (op.type) {
+        case TokenType::PLUS: arithmetic = ArithmeticOp::ADD; break;
+        case TokenType::MINUS: arithmetic = ArithmeticOp::SUBTRACT; break;
+        case TokenType::STAR: arithmetic = ArithmeticOp::MULTIPLY; break;
+        case TokenType::SLASH: arithmetic = ArithmeticOp::DIVIDE; break;
+        case TokenType::LESS: comparison = CompareOp::LESS; isComparison = true; break;
+        case TokenType::LESS_EQUAL: comparison = CompareOp::LESS_EQUAL; isComparison = true; break;
+        case TokenType::GREATER: comparison = CompareOp::GREATER; isComparison = true; break;
+        case TokenType::GREATER_EQUAL: comparison = CompareOp::GREATER_EQUAL; isComparison = true; break;
+        default:
+            throw MegaladonError(op, "Operator not supported on arrays.");
+    }
 
-    std::vector<MegaladonValue> arguments;
-    for (const auto& arg : expr->arguments) {
-        arguments.push_back(evaluate(arg));
+    if (left.isTensor() || right.isTensor()) {
+        if (left.isTensor() && right.isTensor()) {
+            const Tensor& a = *left.asTensor();
+            const Tensor& b = *right.asTensor();
+            return MegaladonValue(isComparison ? tensorCompare(comparison, a, b) : tensorArithmetic(arithmetic, a, b));
+        }
+        const MegaladonValue& scalar = left.isTensor() ? right : left;
+        if (!scalar.isNumber()) {
+            throw MegaladonError(op, "Tensors can only be combined with tensors or numbers.");
+        }
+        bool scalarOnLeft = !left.isTensor();
+        const Tensor& tensor = scalarOnLeft ? *right.asTensor() : *left.asTensor();
+        return MegaladonValue(isComparison ? tensorCompare(comparison, tensor, scalar.asNumber(), scalarOnLeft)
+                                           : tensorArithmetic(arithmetic, tensor, scalar.asNumber(), scalarOnLeft));
     }
 
+    if (left.isArray() && right.isArray()) {
+        const NumericArray& a = *left.asArray();
+        const NumericArray& b = *right.asArray();
+        if (a.size() != b.size()) {
+            throw MegaladonError(op, "Array operands must have the same length.");
+        }
+        return MegaladonValue(isComparison ? arrayCompare(comparison, a, b) : arrayArithmetic(arithmetic, a, b));
+    }
+
+    const MegaladonValue& scalar = left.isArray() ? right : left;
+    if (!scalar.isNumber()) {
+        throw MegaladonError(op, "Arrays can only be combined with arrays or numbers.");
+    }
+    bool scalarOnLeft = !left.isArray();
+    const NumericArray& array = scalarOnLeft ? *right.asArray() : *left.asArray();
+    return MegaladonValue(isComparison ? arrayCompare(comparison, array, scalar.asNumber(), scalarOnLeft)
+                                       : arrayArithmetic(arithmetic, array, scalar.asNumber(), scalarOnLeft));
+}
+
+namespace {
+// Calls with up to this many arguments keep them in the caller's frame
+constexpr size_t FAST_CALL_MAX_ARGUMENTS = 8;
+} // namespace
+
+MegaladonValue Interpreter::visit(std::shared_ptr<CallExpr> expr) {
+    MegaladonValue callee = evaluate(expr->callee);
     if (!callee.isFunction()) {
         throw MegaladonError(expr->paren, "Can only call functions.");
     }
+    const std::shared_ptr<MegaladonCallable>& function = callee.asCallable();
+    size_t count = expr->arguments.size();
+
+    // Linking: the arity check runs when a site first meets a callee. Natives
+    // never change, so the site remembers them and later calls skip the check.
+    if (function != expr->linked) {
+        if (function->arity() != static_cast<int>(count) && function->arity() != -1) { // -1 for variable arity
+            throw MegaladonError(expr->paren, "Expected " + std::to_string(function->arity()) +
+                                           " arguments but got " + std::to_string(count) + ".");
+        }
+        if (dynamic_cast<MegaladonBuiltin*>(function.get())) {
+            expr->linked = function;
+        }
+    }
 
-    std::shared_ptr<MegaladonCallable> function = callee.asCallable();
-
-    if (function->arity() != arguments.size() && function->arity() != -1) { // -1 for variable arity
-        throw MegaladonError(expr->paren, "Expected " + std::to_string(function->arity()) +
-                                       " arguments but got " + std::to_string(arguments.size()) + ".");
+    if (count <= FAST_CALL_MAX_ARGUMENTS) {
+        MegaladonValue arguments[FAST_CALL_MAX_ARGUMENTS];
+        for (size_t i = 0; i < count; ++i) {
+            arguments[i] = evaluate(expr->arguments[i]);
+        }
+        return function->fastCall(*this, ArgumentSpan(arguments, count));
     }
 
+    std::vector<MegaladonValue> arguments;
+    arguments.reserve(count);
+    for (const auto& arg : expr->arguments) {
+        arguments.push_back(evaluate(arg));
+    }
     return function->call(*this, arguments);
 }
 
@@ -206,7 +318,7 @@ MegaladonValue Interpreter::visit(std::shared_ptr<UnaryExpr> expr) {
 
 MegaladonValue Interpreter::visit(std::shared_ptr<VariableExpr> expr) {
     if (expr->distance != -1) {
-        return environment->getAt(expr->distance, expr->name.lexeme);
+        return environment->getAt(expr->distance, expr->name.symbol);
     } else {
         // Fallback to global if not resolved (e.g., built-ins)
         return globals->get(expr->name);
@@ -221,56 +333,409 @@ MegaladonValue Interpreter::visit(std::shared_ptr<ListExpr> expr) {
     return MegaladonValue(elements);
 }
 
-MegaladonValue Interpreter::visit(std::shared_ptr<GetExpr> expr) {
-    MegaladonValue object = evaluate(expr->object);
+MegaladonValue Interpreter::visit(std::shared_ptr<MapExpr> expr) {
+    auto map = newMap(*this);
+    for (size_t i = 0; i < expr->keys.size(); ++i) {
+        MegaladonValue key = evaluate(expr->keys[i]);
+        map->set(key, evaluate(expr->values[i])); // Later duplicates overwrite earlier ones
+    }
+    return MegaladonValue(map);
+}
 
-    if (object.isList()) {
-        // This is for list indexing, e.g., myList[0]
-        if (!expr->index || !expr->index->isLiteral()) { // Assuming index is a literal for now
-             throw MegaladonError(expr->name, "List index must be a literal number.");
+// --- Indexing ---
+
+namespace {
+// Resolves 'value' as an index into a sequence of 'length' items. Negative
+// indexes count from the end. The integer check is a cast round-trip rather
+// than std::fmod, and the range check is a single unsigned compare.
+size_t resolveIndex(const MegaladonValue& value, size_t length, const Token& where, const char* kind) {
+    double number = value.isNumber() ? value.asNumber() : 0.5;
+    // The range test also rejects NaN, and keeps the cast below defined
+    if (!(number > -9.0e18 && number < 9.0e18) || static_cast<double>(static_cast<int64_t>(number)) != number) {
+        throw MegaladonError(where, std::string(kind) + " index must be an integer.");
+    }
+    int64_t index = static_cast<int64_t>(number);
+    if (index < 0) index += static_cast<int64_t>(length);
+    if (static_cast<uint64_t>(index) >= length) {
+        throw MegaladonError(where, std::string(kind) + " index out of bounds.");
+    }
+    return static_cast<size_t>(index);
+}
+
+// Slice bound: omitted bounds default to the ends, negative ones count from
+// the end, and out-of-range ones are clamped like Python's
+size_t resolveSliceBound(const MegaladonValue& value, size_t length, size_t omitted, const Token& where) {
+    if (value.isVoid()) return omitted;
+    double number = value.isNumber() ? value.asNumber() : 0.5;
+    if (std::isnan(number) || std::fmod(number, 1.0) != 0.0) {
+        throw MegaladonError(where, "Slice bounds must be integers.");
+    }
+    if (number < 0) number += static_cast<double>(length);
+    if (number < 0) return 0;
+    return number > static_cast<double>(length) ? length : static_cast<size_t>(number);
+}
+
+MegaladonValue loadIndexed(const MegaladonValue& object, const MegaladonValue& index, const Token& where) {
+    switch (object.type) {
+        case LIST: {
+            const auto& list = object.asList();
+            return list[resolveIndex(index, list.size(), where, "List")];
+        }
+        case ARRAY: {
+            const NumericArray& array = *object.asArray();
+            return MegaladonValue(array.values[resolveIndex(index, array.size(), where, "Array")]);
+        }
+        case VECTOR: {
+            const PersistentVector& vector = *object.asVector();
+            return vector.get(resolveIndex(index, vector.size(), where, "Vector"));
+        }
+        case STRING: {
+            const MegaladonString& text = object.asString();
+            return MegaladonValue(text.substr(resolveIndex(index, text.size(), where, "String"), 1));
+        }
+        case BYTES: {
+            const MegaladonBytes& bytes = object.asBytes();
+            return MegaladonValue(static_cast<double>(bytes.data()[resolveIndex(index, bytes.size(), where, "Bytes")]));
         }
-        MegaladonValue index_value = evaluate(expr->index);
-        if (!index_value.isNumber() || std::fmod(index_value.asNumber(), 1.0) != 0.0) {
-            throw MegaladonError(expr->name, "List index must be an integer.");
+        case TENSOR: {
+            // Numbers from a 1-D tensor; otherwise a view of one row that shares the buffer
+            const Tensor& tensor = *object.asTensor();
+            size_t row = resolveIndex(index, tensor.shape()[0], where, "Tensor");
+            if (tensor.rank() == 1) return MegaladonValue(tensor.data()[row]);
+            return MegaladonValue(tensor.row(row));
+        }
+        case MAP: {
+            const MegaladonValue* value = static_cast<const MegaladonMap&>(*object.asMap()).get(index);
+            if (!value) {
+                throw MegaladonError(where, "Key not found in map.");
+            }
+            return *value;
+        }
+        default:
+            // Handle other object properties if Megaladon supports them (e.g., object.property)
+            throw MegaladonError(where, "Only lists, arrays, vectors, strings, bytes, tensors and maps support indexed access.");
+    }
+}
+} // namespace
+
+MegaladonValue* Interpreter::variableSlot(const VariableExpr& variable) {
+    MegaladonValue* slot = variable.distance != -1 ? environment->slotAt(variable.distance, variable.name.symbol)
+                                                   : globals->slot(variable.name);
+    if (!slot) {
+        throw MegaladonError(variable.name, "Undefined variable '" + variable.name.lexeme + "'.");
+    }
+    return slot;
+}
+
+// Where container[index] lives, for assignments that go through it (a[i][j] = ...)
+MegaladonValue* Interpreter::elementSlot(MegaladonValue& container, const MegaladonValue& index, const Token& where) {
+    if (container.isList()) {
+        auto& list = container.asListMutable(); // Copies the elements only if another value shares them
+        return &list[resolveIndex(index, list.size(), where, "List")];
+    }
+    if (container.isMap()) {
+        MegaladonValue* value = container.asMap()->get(index);
+        if (!value) {
+            throw MegaladonError(where, "Key not found in map.");
         }
+        return value;
+    }
+    throw MegaladonError(where, "Only lists and maps can hold values that are assigned through an index.");
+}
 
-        int index = static_cast<int>(index_value.asNumber());
-        const auto& list = object.asList();
+void Interpreter::storeIndexed(MegaladonValue& target, const MegaladonValue& index, const MegaladonValue& value, const Token& where) {
+    switch (target.type) {
+        case LIST:
+            *elementSlot(target, index, where) = value;
+            return;
+        case ARRAY: {
+            // Arrays are shared, so this updates every value holding the array
+            if (!value.isNumber()) {
+                throw MegaladonError(where, "Arrays can only hold numbers.");
+            }
+            NumericArray& array = *target.asArray();
+            array.values[resolveIndex(index, array.size(), where, "Array")] = value.asNumber();
+            return;
+        }
+        case BYTES: {
+            // Bytes share their buffer like arrays; b[i] = x writes one unsigned byte
+            const MegaladonBytes& bytes = target.asBytes();
+            if (!value.isNumber() || value.asNumber() < 0 || value.asNumber() > 255 || std::fmod(value.asNumber(), 1.0) != 0.0) {
+                throw MegaladonError(where, "Bytes can only hold integers from 0 to 255.");
+            }
+            bytes.data()[resolveIndex(index, bytes.size(), where, "Bytes")] = static_cast<uint8_t>(value.asNumber());
+            return;
+        }
+        case TENSOR: {
+            // t[i] = x sets one element of a 1-D tensor; for higher ranks it fills
+            // row i with a number or copies a tensor of the row's shape into it
+            const Tensor& tensor = *target.asTensor();
+            size_t row = resolveIndex(index, tensor.shape()[0], where, "Tensor");
+            double* destination = tensor.data() + row * tensor.rowSize();
+            if (value.isNumber()) {
+                std::fill(destination, destination + tensor.rowSize(), value.asNumber());
+                return;
+            }
+            if (tensor.rank() > 1 && value.isTensor() &&
+                std::equal(tensor.shape().begin() + 1, tensor.shape().end(), value.asTensor()->shape().begin(),
+                           value.asTensor()->shape().end())) {
+                const double* source = value.asTensor()->data();
+                std::copy(source, source + tensor.rowSize(), destination);
+                return;
+            }
+            throw MegaladonError(where, "Tensor rows can only be assigned a number or a tensor of the row's shape.");
+        }
+        case MAP:
+            target.asMap()->set(index, value);
+            return;
+        case VECTOR: {
+            // Vectors never change, but the variable can hold an updated copy that
+            // shares everything except the path to this element
+            const auto& vector = target.asVector();
+            target = MegaladonValue(vector->set(resolveIndex(index, vector->size(), where, "Vector"), value));
+            return;
+        }
+        default:
+            throw MegaladonError(where, "Only lists, arrays, vectors, bytes, tensors and maps support indexed assignment.");
+    }
+}
 
-        if (index < 0 || static_cast<size_t>(index) >= list.size()) {
-            throw MegaladonError(expr->name, "List index out of bounds.");
+MegaladonValue Interpreter::visit(std::shared_ptr<GetExpr> expr) {
+    // A variable's value is read where it lives instead of being copied out
+    // (which costs two refcount updates per access in a loop like 'xs[i]').
+    // The index goes first, as nothing may run between finding the slot and using it.
+    if (expr->variable) {
+        MegaladonValue index = evaluate(expr->index);
+        MegaladonValue* slot = variableSlot(*expr->variable);
+        if (expr->boundsCheck != GetExpr::CHECK_EACH) {
+            // Inside a loop over a range of integers; the index is one of its items
+            if (expr->boundsCheck == GetExpr::CHECK_ONCE) {
+                bool fits = slot->isList() && expr->rangeHigh < static_cast<double>(slot->asList().size());
+                expr->boundsCheck = fits ? GetExpr::CHECKED : GetExpr::CHECK_EACH;
+            }
+            if (expr->boundsCheck == GetExpr::CHECKED) {
+                return slot->asList()[static_cast<size_t>(index.asNumber())];
+            }
         }
-        return list[index];
+        return loadIndexed(*slot, index, expr->name);
     }
-    // Handle other object properties if Megaladon supports them (e.g., object.property)
-    throw MegaladonError(expr->name, "Only lists support indexed access.");
+    MegaladonValue object = evaluate(expr->object);
+    return loadIndexed(object, evaluate(expr->index), expr->name);
 }
 
 MegaladonValue Interpreter::visit(std::shared_ptr<SetExpr> expr) {
+    // For targets rooted at a variable (xs[i], grid[y][x], ...), the write goes
+    // into the variable's own value, so a list is updated in place rather than
+    // through a copy. All indexes and the value are evaluated first, left to
+    // right; no code runs once the slots are being looked up.
+    if (expr->root) {
+        std::vector<MegaladonValue> pathIndexes;
+        pathIndexes.reserve(expr->path.size());
+        for (auto it = expr->path.rbegin(); it != expr->path.rend(); ++it) {
+            pathIndexes.push_back(evaluate((*it)->index));
+        }
+        MegaladonValue index = evaluate(expr->index);
+        MegaladonValue value = evaluate(expr->value);
+
+        MegaladonValue* target = variableSlot(*expr->root);
+        MegaladonValue row; // Tensor rows are views rather than stored values
+        for (const auto& pathIndex : pathIndexes) {
+            if (target->isTensor()) {
+                row = loadIndexed(*target, pathIndex, expr->name);
+                target = &row;
+            } else {
+                target = elementSlot(*target, pathIndex, expr->name);
+            }
+        }
+        storeIndexed(*target, index, value, expr->name);
+        return value;
+    }
+
+    // Any other target (e.g. f()[0] = x) is a temporary, but maps and arrays
+    // are shared, so writes into them are still seen elsewhere
     MegaladonValue object = evaluate(expr->object);
-    MegaladonValue value_to_set = evaluate(expr->value);
+    MegaladonValue index = evaluate(expr->index);
+    MegaladonValue value = evaluate(expr->value);
+    if (object.isVector()) {
+        throw MegaladonError(expr->name, "Vectors are immutable; use assoc(vector, index, value) for an updated copy.");
+    }
+    storeIndexed(object, index, value, expr->name);
+    return value;
+}
 
-    if (object.isList()) {
-        if (!expr->index || !expr->index->isLiteral()) { // Assuming index is a literal for now
-            throw MegaladonError(expr->name, "List index must be a literal number for assignment.");
+// Slices have the type of what is sliced. Strings, bytes and tensors (sliced
+// along the first axis) share their buffers (O(1)), as does a list sliced
+// whole; other list slices, arrays and vectors get copies of the selected
+// elements. view(list, start, stop) gives a lazy slice of a list.
+MegaladonValue Interpreter::visit(std::shared_ptr<SliceExpr> expr) {
+    MegaladonValue object = evaluate(expr->object);
+    MegaladonValue startValue = expr->start ? evaluate(expr->start) : MegaladonValue();
+    MegaladonValue stopValue = expr->stop ? evaluate(expr->stop) : MegaladonValue();
+
+    size_t length;
+    switch (object.type) {
+        case LIST: length = object.asList().size(); break;
+        case STRING: length = object.asString().size(); break;
+        case ARRAY: length = object.asArray()->size(); break;
+        case VECTOR: length = object.asVector()->size(); break;
+        case BYTES: length = object.asBytes().size(); break;
+        case TENSOR: length = object.asTensor()->shape()[0]; break;
+        default:
+            throw MegaladonError(expr->bracket, "Only lists, strings, bytes, arrays, tensors and vectors can be sliced.");
+    }
+    size_t start = resolveSliceBound(startValue, length, 0, expr->bracket);
+    size_t stop = std::max(start, resolveSliceBound(stopValue, length, length, expr->bracket));
+
+    switch (object.type) {
+        case LIST: {
+            if (start == 0 && stop == length) return object; // Shares the copy-on-write storage
+            const auto& list = object.asList();
+            return MegaladonValue(std::vector<MegaladonValue>(list.begin() + start, list.begin() + stop));
         }
-        MegaladonValue index_value = evaluate(expr->index);
-        if (!index_value.isNumber() || std::fmod(index_value.asNumber(), 1.0) != 0.0) {
-            throw MegaladonError(expr->name, "List index for assignment must be an integer.");
+        case STRING:
+            return MegaladonValue(object.asString().substr(start, stop - start));
+        case BYTES:
+            return MegaladonValue(object.asBytes().slice(start, stop));
+        case TENSOR:
+            return MegaladonValue(object.asTensor()->rows(start, stop));
+        case ARRAY: {
+            const auto& values = object.asArray()->values;
+            return MegaladonValue(std::make_shared<NumericArray>(std::vector<double>(values.begin() + start, values.begin() + stop)));
         }
+        default: {
+            const PersistentVector& vector = *object.asVector();
+            std::vector<MegaladonValue> items;
+            items.reserve(stop - start);
+            for (size_t i = start; i < stop; ++i) {
+                items.push_back(vector.get(i));
+            }
+            return MegaladonValue(PersistentVector::fromValues(items));
+        }
+    }
+}
 
-        int index = static_cast<int>(index_value.asNumber());
-        auto& list = object.asListMutable(); // Need mutable access
 
-        if (index < 0 || static_cast<size_t>(index) >= list.size()) {
-            throw MegaladonError(expr->name, "List index out of bounds for assignment.");
+// --- Method Calls ---
+
+namespace {
+const char* typeLabel(ValueType type) {
+    switch (type) {
+        case VOID: return "void";
+        case NUMBER: return "numbers";
+        case BOOLEAN: return "booleans";
+        case STRING: return "strings";
+        case LIST: return "lists";
+        case ARRAY: return "arrays";
+        case MAP: return "maps";
+        case SET: return "sets";
+        case ITERABLE: return "iterables";
+        case VECTOR: return "vectors";
+        case BYTES: return "bytes";
+        case TENSOR: return "tensors";
+        case FUNCTION: return "functions";
+        default: return "this value";
+    }
+}
+
+// Puts a mutator's receiver back where it came from, even if the method throws
+struct ReceiverRestore {
+    MegaladonValue& slot;
+    MegaladonValue& receiver;
+    ~ReceiverRestore() { slot = std::move(receiver); }
+};
+} // namespace
+
+// The call site's cache is checked first; a miss looks the name up in the
+// receiver type's method table and replaces the cached entry. An empty cache
+// is always a miss, whatever the type (a site starts out with INVALID, which
+// is also the type of some values).
+const NativeMethod& Interpreter::findMethod(MethodCallExpr& expr, ValueType type) {
+    if (expr.cachedMethod == nullptr || expr.cachedType != type) {
+        const NativeMethod* method = methodsFor(type).find(expr.name.symbol);
+        if (!method) {
+            throw MegaladonError(expr.name, std::string("There is no method '") + expr.name.lexeme + "' on " +
+                                                typeLabel(type) + ".");
         }
-        list[index] = value_to_set;
-        return value_to_set;
+        expr.cachedType = type;
+        expr.cachedMethod = method;
     }
-    throw MegaladonError(expr->name, "Only lists support indexed assignment.");
+    return *expr.cachedMethod;
 }
 
+MegaladonValue Interpreter::visit(std::shared_ptr<MethodCallExpr> expr) {
+    std::vector<MegaladonValue> arguments;
+    arguments.reserve(expr->arguments.size() + 1);
+    arguments.emplace_back(); // The receiver, filled in below
+
+    // Receivers rooted at a variable (xs.add(1), rows[i].sort()) are found where
+    // they are stored, so mutators change the variable's own list. As for SetExpr,
+    // the indexes and arguments are evaluated first and no code runs between
+    // finding the receiver's slot and the call.
+    std::vector<GetExpr*> path; // Enclosing index expressions, outermost first
+    Expr* root = expr->object.get();
+    while (auto* get = dynamic_cast<GetExpr*>(root)) {
+        path.push_back(get);
+        root = get->object.get();
+    }
+    auto* variable = dynamic_cast<VariableExpr*>(root);
+    if (!variable) {
+        arguments[0] = evaluate(expr->object);
+        for (const auto& argument : expr->arguments) {
+            arguments.push_back(evaluate(argument));
+        }
+        return findMethod(*expr, arguments[0].type).call(*this, arguments);
+    }
+
+    std::vector<MegaladonValue> pathIndexes;
+    pathIndexes.reserve(path.size());
+    for (auto it = path.rbegin(); it != path.rend(); ++it) {
+        pathIndexes.push_back(evaluate((*it)->index));
+    }
+    for (const auto& argument : expr->arguments) {
+        arguments.push_back(evaluate(argument));
+    }
+
+    // Readers only need the receiver's value; elements are loaded without
+    // taking a mutable reference, which could copy a shared list
+    MegaladonValue* slot = variableSlot(*variable);
+    if (pathIndexes.empty()) {
+        arguments[0] = *slot;
+    } else {
+        arguments[0] = loadIndexed(*slot, pathIndexes[0], expr->name);
+        for (size_t i = 1; i < pathIndexes.size(); ++i) {
+            arguments[0] = loadIndexed(arguments[0], pathIndexes[i], expr->name);
+        }
+    }
+    const NativeMethod& method = findMethod(*expr, arguments[0].type);
+    if (!method.mutates()) {
+        return method.call(*this, arguments);
+    }
+
+    // Mutators that call back into the script work on the copy loaded above.
+    // The script can read the receiver while they run, and may change the
+    // variable or the lists on the path (which would move the slot), so the
+    // slot is found again to store the result.
+    if (method.callsScript()) {
+        MegaladonValue result = method.call(*this, arguments);
+        slot = variableSlot(*variable);
+        for (const auto& pathIndex : pathIndexes) {
+            slot = elementSlot(*slot, pathIndex, expr->name);
+        }
+        *slot = std::move(arguments[0]);
+        return result;
+    }
+
+    // Other mutators get the receiver moved out of its slot, so the list is
+    // not shared during the call and is changed without being copied. No
+    // script runs until it is put back.
+    arguments[0] = MegaladonValue();
+    for (const auto& pathIndex : pathIndexes) {
+        slot = elementSlot(*slot, pathIndex, expr->name);
+    }
+    arguments[0] = std::exchange(*slot, MegaladonValue());
+    ReceiverRestore restore{*slot, arguments[0]};
+    return method.call(*this, arguments);
+}
 
 // --- Statement Visitors ---
 
@@ -279,8 +744,7 @@ void Interpreter::visit(std::shared_ptr<ExpressionStmt> stmt) {
 }
 
 void Interpreter::visit(std::shared_ptr<PrintStmt> stmt) {
-    MegaladonValue value = evaluate(stmt->expression);
-    std::cout << value.toString() << "\n";
+    printLine(evaluate(stmt->expression));
 }
 
 void Interpreter::visit(std::shared_ptr<VarStmt> stmt) {
@@ -290,12 +754,12 @@ void Interpreter::visit(std::shared_ptr<VarStmt> stmt) {
     } else {
         value = MegaladonValue(); // Default to VOID
     }
-    environment->define(stmt->name.lexeme, value);
+    environment->define(stmt->name, value);
 }
 
 void Interpreter::visit(std::shared_ptr<BlockStmt> stmt) {
     // Create a new environment for the block
-    executeBlock(stmt->statements, std::make_shared<Environment>(this->environment));
+    executeBlock(stmt->statements, newEnvironment(this->environment));
 }
 
 void Interpreter::visit(std::shared_ptr<IfStmt> stmt) {
@@ -312,8 +776,166 @@ void Interpreter::visit(std::shared_ptr<WhileStmt> stmt) {
     }
 }
 
+namespace {
+// Finds the sites in a for-in loop's body that read list[i], where 'list' is a
+// variable and 'i' the loop variable, and whose bounds check can be done once
+// per run of the loop. That holds when the body cannot change the list's
+// length or what either name refers to: it calls no function or method and
+// neither assigns nor declares either name. Function declarations are not
+// looked into, as their bodies only run when called.
+class RangeIndexScan {
+public:
+    explicit RangeIndexScan(const Token& loopName) : loopName(loopName.lexeme) {}
+
+    std::vector<GetExpr*> sites() const {
+        std::vector<GetExpr*> result;
+        if (calls || isBound(loopName)) return result;
+        for (GetExpr* site : found) {
+            if (!isBound(site->variable->name.lexeme)) result.push_back(site);
+        }
+        return result;
+    }
+
+    void scan(const std::shared_ptr<Stmt>& stmt) {
+        Stmt* node = stmt.get();
+        if (!node) return;
+        if (auto* block = dynamic_cast<BlockStmt*>(node)) {
+            for (const auto& statement : block->statements) scan(statement);
+        } else if (auto* expression = dynamic_cast<ExpressionStmt*>(node)) {
+            scan(expression->expression);
+        } else if (auto* print = dynamic_cast<PrintStmt*>(node)) {
+            scan(print->expression);
+        } else if (auto* ret = dynamic_cast<ReturnStmt*>(node)) {
+            scan(ret->value);
+        } else if (auto* var = dynamic_cast<VarStmt*>(node)) {
+            bound.push_back(var->name.lexeme);
+            scan(var->initializer);
+        } else if (auto* branch = dynamic_cast<IfStmt*>(node)) {
+            scan(branch->condition);
+            scan(branch->thenBranch);
+            scan(branch->elseBranch);
+        } else if (auto* loop = dynamic_cast<WhileStmt*>(node)) {
+            scan(loop->condition);
+            scan(loop->body);
+        } else if (auto* forIn = dynamic_cast<ForInStmt*>(node)) {
+            bound.push_back(forIn->name.lexeme);
+            scan(forIn->iterable);
+            scan(forIn->body);
+        } else if (auto* function = dynamic_cast<FunctionStmt*>(node)) {
+            bound.push_back(function->name.lexeme);
+        } else {
+            calls = true; // A statement this scan does not know
+        }
+    }
+
+    void scan(const std::shared_ptr<Expr>& expr) {
+        Expr* node = expr.get();
+        if (!node) return;
+        if (auto* get = dynamic_cast<GetExpr*>(node)) {
+            auto* index = dynamic_cast<VariableExpr*>(get->index.get());
+            if (get->variable && index && index->name.lexeme == loopName) found.push_back(get);
+            scan(get->object);
+            scan(get->index);
+        } else if (auto* assign = dynamic_cast<AssignExpr*>(node)) {
+            bound.push_back(assign->name.lexeme);
+            scan(assign->value);
+        } else if (auto* binary = dynamic_cast<BinaryExpr*>(node)) {
+            scan(binary->left);
+            scan(binary->right);
+        } else if (auto* logical = dynamic_cast<LogicalExpr*>(node)) {
+            scan(logical->left);
+            scan(logical->right);
+        } else if (auto* unary = dynamic_cast<UnaryExpr*>(node)) {
+            scan(unary->right);
+        } else if (auto* grouping = dynamic_cast<GroupingExpr*>(node)) {
+            scan(grouping->expression);
+        } else if (auto* set = dynamic_cast<SetExpr*>(node)) {
+            // Writes through an index replace elements, never change a list's length
+            scan(set->object);
+            scan(set->index);
+            scan(set->value);
+        } else if (auto* slice = dynamic_cast<SliceExpr*>(node)) {
+            scan(slice->object);
+            scan(slice->start);
+            scan(slice->stop);
+        } else if (auto* list = dynamic_cast<ListExpr*>(node)) {
+            for (const auto& element : list->elements) scan(element);
+        } else if (auto* map = dynamic_cast<MapExpr*>(node)) {
+            for (const auto& key : map->keys) scan(key);
+            for (const auto& value : map->values) scan(value);
+        } else if (!dynamic_cast<LiteralExpr*>(node) && !dynamic_cast<VariableExpr*>(node)) {
+            calls = true; // Calls, method calls and anything this scan does not know
+        }
+    }
+
+private:
+    bool isBound(const std::string& name) const {
+        return std::find(bound.begin(), bound.end(), name) != bound.end();
+    }
+
+    std::string loopName;
+    std::vector<GetExpr*> found;
+    std::vector<std::string> bound; // Names the body assigns or declares
+    bool calls = false;
+};
+
+// Puts a loop's index sites back to checking every index however the loop ends
+struct RangeIndexRun {
+    const std::vector<GetExpr*>* sites = nullptr;
+    ~RangeIndexRun() {
+        if (!sites) return;
+        for (GetExpr* site : *sites) site->boundsCheck = GetExpr::CHECK_EACH;
+    }
+};
+} // namespace
+
+void Interpreter::visit(std::shared_ptr<ForInStmt> stmt) {
+    MegaladonValue iterable = evaluate(stmt->iterable);
+    std::unique_ptr<MegaladonIterator> iterator = iterateValue(iterable);
+    if (!iterator) {
+        throw MegaladonError(stmt->name, "Can only iterate over lists, strings, arrays, maps, sets and iterables.");
+    }
+
+    // For a range of non-negative integers, list[i] in the body only has to
+    // check the range's largest item against the list once (see GetExpr)
+    if (!stmt->indexSitesFound) {
+        RangeIndexScan scan(stmt->name);
+        scan.scan(stmt->body);
+        stmt->rangeIndexSites = scan.sites();
+        stmt->indexSitesFound = true;
+    }
+    RangeIndexRun checkedSites;
+    if (!stmt->rangeIndexSites.empty() && iterable.isIterable()) {
+        double low, high;
+        auto* range = dynamic_cast<const RangeIterable*>(iterable.asIterable().get());
+        if (range && range->integerBounds(low, high) && low >= 0) {
+            for (GetExpr* site : stmt->rangeIndexSites) {
+                site->boundsCheck = GetExpr::CHECK_ONCE;
+                site->rangeHigh = high;
+            }
+            checkedSites.sites = &stmt->rangeIndexSites;
+        }
+    }
+
+    // One scope for the whole loop; the variable is rebound on every pass
+    std::shared_ptr<Environment> loop_environment = newEnvironment(this->environment);
+    std::shared_ptr<Environment> previous = this->environment;
+    MegaladonValue item;
+    try {
+        this->environment = loop_environment;
+        while (iterator->next(item)) {
+            loop_environment->define(stmt->name, item);
+            execute(stmt->body);
+        }
+    } catch (const ReturnValue& r) {
+        this->environment = previous; // Restore previous environment on return
+        throw; // Re-throw the return value
+    }
+    this->environment = previous;
+}
+
 // Represents a user-defined function as a MegaladonCallable
-class MegaladonFunction : public MegaladonCallable {
+class MegaladonFunction : public MegaladonCallable, public HeapObject {
 public:
     MegaladonFunction(std::shared_ptr<FunctionStmt> declaration, std::shared_ptr<Environment> closure)
         : declaration(std::move(declaration)), closure(std::move(closure)) {}
@@ -322,12 +944,16 @@ public:
     std::string toString() const override { return "<fn " + declaration->name.lexeme + ">"; }
 
     MegaladonValue call(Interpreter& interpreter, const std::vector<MegaladonValue>& arguments) override {
+        return fastCall(interpreter, ArgumentSpan(arguments.data(), arguments.size()));
+    }
+
+    MegaladonValue fastCall(Interpreter& interpreter, ArgumentSpan arguments) override {
         // Create a new environment for the function's body
-        std::shared_ptr<Environment> function_environment = std::make_shared<Environment>(closure);
+        std::shared_ptr<Environment> function_environment = interpreter.newEnvironment(closure);
 
         // Bind arguments to parameters in the new environment
         for (size_t i = 0; i < declaration->params.size(); ++i) {
-            function_environment->define(declaration->params[i].lexeme, arguments[i]);
+            function_environment->define(declaration->params[i], arguments[i]);
         }
 
         try {
@@ -339,6 +965,13 @@ public:
         return MegaladonValue(); // Implicit return VOID
     }
 
+    // HeapObject: a function keeps the environment it closes over alive
+    void traceReferences(const std::function<void(HeapObject*)>& visit) override {
+        if (closure) visit(closure.get());
+    }
+    void clearReferences() override { closure.reset(); }
+    size_t approximateSize() const override { return sizeof(MegaladonFunction); }
+
 private:
     std::shared_ptr<FunctionStmt> declaration;
     std::shared_ptr<Environment> closure; // Environment where the function was defined
@@ -348,8 +981,10 @@ private:
 void Interpreter::visit(std::shared_ptr<FunctionStmt> stmt) {
     // When a function declaration is evaluated, it becomes a Callable object.
     // The current environment becomes the function's closure.
-    std::shared_ptr<MegaladonFunction> function = std::make_shared<MegaladonFunction>(stmt, environment);
-    environment->define(stmt->name.lexeme, MegaladonValue(function));
+    std::shared_ptr<MegaladonFunction> function =
+        std::allocate_shared<MegaladonFunction>(PoolAllocator<MegaladonFunction>(pool), stmt, environment);
+    heap.track(function);
+    environment->define(stmt->name, MegaladonValue(function));
 }
 
 void Interpreter::visit(std::shared_ptr<ReturnStmt> stmt) {
@@ -7,6 +7,8 @@
 #include "../ast/ast.h"         // Contains all Expr and Stmt declarations
 #include "../environment/environment.h" // For Environment
 #include "../types/value.h"      // For MegaladonValue
+#include "../memory/heap.h"      // For MegaladonHeap
+#include "../memory/pool_allocator.h" // For MemoryPool
 
 // A custom exception to unwind the stack for 'return' statements
 class ReturnValue : public std::runtime_error {
@@ -18,6 +20,7 @@ public:
 class Interpreter : public ExprVisitor<MegaladonValue>, public StmtVisitor<void> {
 public:
     Interpreter();
+    ~Interpreter();
 
     void interpret(const std::vector<std::shared_ptr<Stmt>>& statements);
 
@@ -28,6 +31,7 @@ public:
     void visit(std::shared_ptr<BlockStmt> stmt) override;
     void visit(std::shared_ptr<IfStmt> stmt) override;
     void visit(std::shared_ptr<WhileStmt> stmt) override;
+    void visit(std::shared_ptr<ForInStmt> stmt) override;
     void visit(std::shared_ptr<FunctionStmt> stmt) override;
     void visit(std::shared_ptr<ReturnStmt> stmt) override;
 
@@ -44,6 +48,9 @@ public:
     MegaladonValue visit(std::shared_ptr<UnaryExpr> expr) override;
     MegaladonValue visit(std::shared_ptr<VariableExpr> expr) override;
     MegaladonValue visit(std::shared_ptr<ListExpr> expr) override;
+    MegaladonValue visit(std::shared_ptr<MapExpr> expr) override;
+    MegaladonValue visit(std::shared_ptr<SliceExpr> expr) override;
+    MegaladonValue visit(std::shared_ptr<MethodCallExpr> expr) override;
 
 
     // Public access for evaluating expressions (used by statements)
@@ -54,6 +61,11 @@ public:
     void executeBlock(const std::vector<std::shared_ptr<Stmt>>& statements, std::shared_ptr<Environment> new_environment);
 
 
+    // Creates a scope nested in 'enclosing' and registers it with the heap
+    std::shared_ptr<Environment> newEnvironment(std::shared_ptr<Environment> enclosing);
+
+    std::shared_ptr<MemoryPool> pool; // Small-object pool for environments, closures and maps
+    MegaladonHeap heap; // Declared before the environments so it outlives them
     std::shared_ptr<Environment> globals; // Global environment
     std::shared_ptr<Environment> environment; // Current active environment
 
@@ -63,4 +75,13 @@ private:
     void checkNumberOperands(const Token& op, const MegaladonValue& left, const MegaladonValue& right);
     bool isTruthy(const MegaladonValue& value);
     bool isEqual(const MegaladonValue& a, const MegaladonValue& b);
+    MegaladonValue arrayBinary(const Token& op, const MegaladonValue& left, const MegaladonValue& right);
+
+    // Indexed assignment: where a variable or an element is stored, so it can be updated in place
+    MegaladonValue* variableSlot(const VariableExpr& variable);
+    MegaladonValue* elementSlot(MegaladonValue& container, const MegaladonValue& index, const Token& where);
+    void storeIndexed(MegaladonValue& target, const MegaladonValue& index, const MegaladonValue& value, const Token& where);
+
+    // Method for a receiver of 'type' at this call site, through its inline cache
+    const NativeMethod& findMethod(MethodCallExpr& expr, ValueType type);
 };
\ No newline at end of file
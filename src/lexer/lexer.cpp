@@ -11,6 +11,7 @@ static const std::map<std::string, TokenType> keywords = {
     {"for", TokenType::FOR},
     {"fun", TokenType::FUN},
     {"if", TokenType::IF},
+    {"in", TokenType::IN}, // for (x in iterable)
     {"nil", TokenType::NIL}, // You might use VOID instead of NIL
     {"or", TokenType::OR},
     {"print", TokenType::PRINT},
@@ -52,6 +53,7 @@ void Lexer::scanToken() {
         case '-': addToken(TokenType::MINUS); break;
         case '+': addToken(TokenType::PLUS); break;
         case ';': addToken(TokenType::SEMICOLON); break;
+        case ':': addToken(TokenType::COLON); break; // For map literals
         case '*': addToken(TokenType::STAR); break;
         case '%': addToken(TokenType::MODULO); break; // Assuming you'll add modulo
 
@@ -176,6 +178,11 @@ void Lexer::identifier() {
         type = keywords.at(text);
     }
     addToken(type);
+
+    // Intern identifiers once here so later lookups compare integer ids
+    if (type == TokenType::IDENTIFIER) {
+        tokens.back().symbol = SymbolTable::intern(text);
+    }
 }
 
 bool Lexer::isDigit(char c) {
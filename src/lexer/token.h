@@ -2,12 +2,14 @@
 
 #include <string>
 #include "../types/value.h" // For MegaladonValue
+#include "../util/symbol_table.h" // For SymbolId
 
 enum class TokenType {
     // Single-character tokens.
     LEFT_PAREN, RIGHT_PAREN, LEFT_BRACE, RIGHT_BRACE,
     LEFT_BRACKET, RIGHT_BRACKET, // Added for lists
     COMMA, DOT, MINUS, PLUS, SEMICOLON, SLASH, STAR, MODULO, // Added MODULO
+    COLON, // Separates keys and values in map literals
 
     // One or two character tokens.
     BANG, BANG_EQUAL,
@@ -19,7 +21,7 @@ enum class TokenType {
     IDENTIFIER, TOKEN_STRING, TOKEN_NUMBER, TOKEN_BOOLEAN, // Renamed STRING, NUMBER, BOOLEAN
     
     // Keywords.
-    AND, CLASS, ELSE, FALSE, FUN, FOR, IF, NIL, OR,
+    AND, CLASS, ELSE, FALSE, FUN, FOR, IF, IN, NIL, OR,
     PRINT, RETURN, SUPER, THIS, TRUE, VAR, WHILE,
 
     EOF_TOKEN,
@@ -32,12 +34,13 @@ struct Token {
     std::string lexeme;
     MegaladonValue literal; // Changed from 'void*' to MegaladonValue
     int line;
+    SymbolId symbol; // Interned id for IDENTIFIER tokens, NO_SYMBOL otherwise
 
     Token(TokenType type, std::string lexeme, MegaladonValue literal, int line)
-        : type(type), lexeme(std::move(lexeme)), literal(std::move(literal)), line(line) {}
+        : type(type), lexeme(std::move(lexeme)), literal(std::move(literal)), line(line), symbol(NO_SYMBOL) {}
 
     Token(TokenType type, std::string lexeme, int line) // Constructor for tokens without a literal value
-        : type(type), lexeme(std::move(lexeme)), line(line) {}
+        : type(type), lexeme(std::move(lexeme)), line(line), symbol(NO_SYMBOL) {}
 
     std::string toString() const; // Implemented in token.cpp (if you have one) or directly here if small
 };
\ No newline at end of file
@@ -7,6 +7,7 @@ enum class TokenType {
     LEFT_PAREN, RIGHT_PAREN, LEFT_BRACE, RIGHT_BRACE,
     LEFT_BRACKET, RIGHT_BRACKET, // Added for list literals and indexing
     COMMA, DOT, MINUS, PLUS, SEMICOLON, SLASH, STAR, MODULO, // Added MODULO
+    COLON, // Separates keys and values in map literals
 
     // One or two character tokens.
     BANG, BANG_EQUAL,
@@ -18,7 +19,7 @@ enum class TokenType {
     IDENTIFIER, STRING, NUMBER, BOOLEAN, // BOOLEAN for true/false
 
     // Keywords.
-    AND, CLASS, ELSE, FUN, FOR, IF, NIL, OR,
+    AND, CLASS, ELSE, FUN, FOR, IF, IN, NIL, OR,
     PRINT, RETURN, SUPER, THIS, VAR, WHILE, TRUE, FALSE, // Added TRUE/FALSE as separate keywords
 
     EOF_TOKEN // End of File
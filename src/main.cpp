@@ -8,6 +8,7 @@
 #include "parser/parser.h"
 #include "interpreter/interpreter.h"
 #include "util/error.h"
+#include "util/output_buffer.h"
 
 // Function to run Megaladon code from a string
 void run(const std::string& source) {
@@ -55,6 +56,7 @@ void runPrompt() {
     std::cout << "Type 'exit()' to quit.\n";
     std::string line;
     for (;;) {
+        OutputBuffer::standardOutput().flush(); // Output of the last line comes before the prompt
         std::cout << ">>> "; // Megaladon prompt
         if (!std::getline(std::cin, line)) break;
         if (line == "exit()") break;
@@ -0,0 +1,182 @@
+#include "heap.h"
+#include "../types/value.h"
+#include "../types/map_value.h" // MegaladonMap is a HeapObject
+#include <algorithm> // For std::max
+#include <chrono>
+#include <cstdio>    // For std::snprintf
+
+namespace {
+enum GcState : unsigned char {
+    NOT_CANDIDATE = 0,
+    CANDIDATE = 1, // In the set being collected, reachability unknown
+    REACHABLE = 2  // Referenced from outside the set, directly or transitively
+};
+} // namespace
+
+void traceValue(const MegaladonValue& value, const std::function<void(HeapObject*)>& visit) {
+    switch (value.type) {
+        case FUNCTION: {
+            // Builtins are not heap objects; user functions (closures) are
+            if (auto* object = dynamic_cast<HeapObject*>(std::get<std::shared_ptr<MegaladonCallable>>(value.data).get())) {
+                visit(object);
+            }
+            break;
+        }
+        case LIST:
+            // Copy-on-write storage may also be held by values the collector
+            // cannot see (a C++ local); tracing through every holder would count
+            // its references once per holder, so only a list's sole owner traces
+            // its elements
+            if (value.listStorage().use_count() == 1) {
+                for (const auto& element : value.asList()) {
+                    traceValue(element, visit);
+                }
+            }
+            break;
+        case MAP:
+            // Maps are shared objects of their own rather than plain containers
+            visit(std::get<std::shared_ptr<MegaladonMap>>(value.data).get());
+            break;
+        default:
+            // Scalars and strings never reference heap objects. Lazy iterables and
+            // vectors (whose nodes are shared between versions) are not traced, so
+            // whatever they hold counts as externally owned.
+            break;
+    }
+}
+
+std::string HeapStats::toString() const {
+    char buffer[256];
+    std::snprintf(buffer, sizeof(buffer),
+                  "heap: %zu objects (%zu young, ~%zu KB), collections: %zu minor / %zu major, "
+                  "freed: %zu, pause: last %.3f ms / max %.3f ms / total %.3f ms",
+                  trackedObjects, nurseryObjects, approximateBytes / 1024, minorCollections, majorCollections,
+                  freedObjects, lastPauseMs, maxPauseMs, totalPauseMs);
+    return buffer;
+}
+
+void MegaladonHeap::track(const std::shared_ptr<HeapObject>& object) {
+    nursery.push_back(object);
+    stats_.nurseryObjects = nursery.size();
+    stats_.trackedObjects = nursery.size() + tenured.size();
+
+    if (nursery.size() >= NURSERY_LIMIT) {
+        collectMinor();
+        if (tenured.size() >= nextMajorAt) {
+            collectMajor();
+        }
+    }
+}
+
+size_t MegaladonHeap::collectMinor() {
+    // Young objects referenced from tenured ones count as externally held, so they survive
+    size_t freed = collect(nursery, tenured, false);
+    nursery.clear();
+    stats_.minorCollections++;
+    stats_.nurseryObjects = 0;
+    stats_.trackedObjects = tenured.size();
+    return freed;
+}
+
+size_t MegaladonHeap::collectMajor() {
+    std::vector<std::weak_ptr<HeapObject>> candidates;
+    candidates.reserve(nursery.size() + tenured.size());
+    candidates.insert(candidates.end(), tenured.begin(), tenured.end());
+    candidates.insert(candidates.end(), nursery.begin(), nursery.end());
+    nursery.clear();
+    tenured.clear();
+
+    size_t freed = collect(candidates, tenured, true);
+    nextMajorAt = std::max(MIN_MAJOR_THRESHOLD, tenured.size() * 2);
+    stats_.majorCollections++;
+    stats_.nurseryObjects = 0;
+    stats_.trackedObjects = tenured.size();
+    return freed;
+}
+
+size_t MegaladonHeap::collect(std::vector<std::weak_ptr<HeapObject>>& candidates,
+                              std::vector<std::weak_ptr<HeapObject>>& survivors, bool measure) {
+    auto started = std::chrono::steady_clock::now();
+
+    // Pin every live candidate; each now has exactly one extra owner (this vector)
+    std::vector<std::shared_ptr<HeapObject>> objects;
+    objects.reserve(candidates.size());
+    for (const auto& weak : candidates) {
+        if (auto object = weak.lock()) {
+            object->gcState = CANDIDATE;
+            objects.push_back(std::move(object));
+        }
+    }
+    for (const auto& object : objects) {
+        object->gcRefs = object.use_count() - 1;
+    }
+
+    // Subtract references that come from other candidates
+    auto subtractInternal = [](HeapObject* child) {
+        if (child->gcState == CANDIDATE) child->gcRefs--;
+    };
+    for (const auto& object : objects) {
+        object->traceReferences(subtractInternal);
+    }
+
+    // Whatever still has references is held from outside; everything it reaches is live too
+    std::vector<HeapObject*> worklist;
+    for (const auto& object : objects) {
+        if (object->gcRefs > 0) {
+            object->gcState = REACHABLE;
+            worklist.push_back(object.get());
+        }
+    }
+    auto markReachable = [&worklist](HeapObject* child) {
+        if (child->gcState == CANDIDATE) {
+            child->gcState = REACHABLE;
+            worklist.push_back(child);
+        }
+    };
+    while (!worklist.empty()) {
+        HeapObject* object = worklist.back();
+        worklist.pop_back();
+        object->traceReferences(markReachable);
+    }
+
+    // Remaining candidates are only kept alive by cycles among themselves
+    size_t freed = 0;
+    size_t bytes = 0;
+    for (const auto& object : objects) {
+        if (object->gcState == CANDIDATE) {
+            object->clearReferences();
+            freed++;
+        } else {
+            survivors.push_back(object);
+            if (measure) bytes += object->approximateSize();
+        }
+    }
+    for (const auto& object : objects) {
+        object->gcState = NOT_CANDIDATE;
+    }
+    objects.clear(); // Drops the last owners of the garbage
+
+    double pauseMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    stats_.lastPauseMs = pauseMs;
+    stats_.maxPauseMs = std::max(stats_.maxPauseMs, pauseMs);
+    stats_.totalPauseMs += pauseMs;
+    stats_.freedObjects += freed;
+    if (measure) stats_.approximateBytes = bytes;
+    return freed;
+}
+
+void MegaladonHeap::releaseAll() {
+    std::vector<std::shared_ptr<HeapObject>> objects;
+    for (auto* generation : {&nursery, &tenured}) {
+        for (const auto& weak : *generation) {
+            if (auto object = weak.lock()) objects.push_back(std::move(object));
+        }
+        generation->clear();
+    }
+    for (const auto& object : objects) {
+        object->clearReferences();
+    }
+    stats_.freedObjects += objects.size();
+    stats_.trackedObjects = 0;
+    stats_.nurseryObjects = 0;
+}
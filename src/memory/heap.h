@@ -0,0 +1,87 @@
+#pragma once
+
+#include <vector>
+#include <memory>     // For std::shared_ptr, std::weak_ptr
+#include <functional> // For std::function
+#include <cstdint>    // For int64_t
+#include <string>
+
+class MegaladonValue;
+
+// Base class for heap objects that can take part in reference cycles
+// (environments, closures and maps). Ownership stays with std::shared_ptr; the heap
+// only finds groups of objects that are kept alive exclusively by each other
+// and breaks them up.
+class HeapObject {
+public:
+    virtual ~HeapObject() = default;
+
+    // Calls 'visit' once for every HeapObject this object holds a reference to
+    virtual void traceReferences(const std::function<void(HeapObject*)>& visit) = 0;
+    // Drops every outgoing reference; only called on unreachable objects
+    virtual void clearReferences() = 0;
+    // Rough number of bytes owned by this object, for heap statistics
+    virtual size_t approximateSize() const = 0;
+
+private:
+    friend class MegaladonHeap;
+    int64_t gcRefs = 0;
+    unsigned char gcState = 0;
+};
+
+// Calls 'visit' for every HeapObject referenced from 'value' (closures inside lists, ...)
+void traceValue(const MegaladonValue& value, const std::function<void(HeapObject*)>& visit);
+
+struct HeapStats {
+    size_t trackedObjects = 0;
+    size_t nurseryObjects = 0;
+    size_t approximateBytes = 0; // Measured during the last major collection
+    size_t minorCollections = 0;
+    size_t majorCollections = 0;
+    size_t freedObjects = 0;
+    double lastPauseMs = 0.0;
+    double maxPauseMs = 0.0;
+    double totalPauseMs = 0.0;
+
+    std::string toString() const;
+};
+
+// Per-interpreter cycle collector.
+// New objects start in a nursery; when it fills up, a minor collection looks for
+// garbage cycles among young objects only and promotes the survivors. A major
+// collection over everything runs once the tenured set has doubled since the
+// last one, which keeps steady-state memory bounded for long-running scripts.
+//
+// Collection uses trial deletion: an object whose shared_ptr count is higher than
+// the number of references from other candidates is held from outside (a variable
+// on the C++ stack, a root environment, an older generation), so no explicit root
+// set is needed and collecting is safe at any point in the interpreter.
+class MegaladonHeap {
+public:
+    static constexpr size_t NURSERY_LIMIT = 4096;
+    static constexpr size_t MIN_MAJOR_THRESHOLD = 16384;
+
+    MegaladonHeap() = default;
+    MegaladonHeap(const MegaladonHeap&) = delete;
+    MegaladonHeap& operator=(const MegaladonHeap&) = delete;
+
+    // Starts tracking 'object' and collects if the nursery is full
+    void track(const std::shared_ptr<HeapObject>& object);
+
+    size_t collectMinor();
+    size_t collectMajor(); // Returns the number of objects freed
+
+    // Breaks every reference between tracked objects; used when the interpreter shuts down
+    void releaseAll();
+
+    const HeapStats& stats() const { return stats_; }
+
+private:
+    size_t collect(std::vector<std::weak_ptr<HeapObject>>& candidates,
+                   std::vector<std::weak_ptr<HeapObject>>& survivors, bool measure);
+
+    std::vector<std::weak_ptr<HeapObject>> nursery;
+    std::vector<std::weak_ptr<HeapObject>> tenured;
+    size_t nextMajorAt = MIN_MAJOR_THRESHOLD;
+    HeapStats stats_;
+};
@@ -0,0 +1,70 @@
+#include "pool_allocator.h"
+#include <cstdio> // For std::snprintf
+
+MemoryPool::~MemoryPool() {
+    for (char* arena : arenas) {
+        ::operator delete(arena);
+    }
+}
+
+void* MemoryPool::allocate(size_t bytes) {
+    if (bytes == 0) bytes = 1;
+    SizeClass& sizeClass = classes[classIndex(bytes)];
+    sizeClass.stats.allocations++;
+    sizeClass.stats.blocksInUse++;
+
+    if (FreeBlock* block = sizeClass.freeList) {
+        sizeClass.freeList = block->next;
+        sizeClass.stats.blocksFree--;
+        return block;
+    }
+    return allocateFromArena((classIndex(bytes) + 1) * GRANULE);
+}
+
+void MemoryPool::deallocate(void* pointer, size_t bytes) {
+    if (pointer == nullptr) return;
+    if (bytes == 0) bytes = 1;
+    SizeClass& sizeClass = classes[classIndex(bytes)];
+    FreeBlock* block = static_cast<FreeBlock*>(pointer);
+    block->next = sizeClass.freeList;
+    sizeClass.freeList = block;
+    sizeClass.stats.blocksInUse--;
+    sizeClass.stats.blocksFree++;
+}
+
+void* MemoryPool::allocateFromArena(size_t blockSize) {
+    if (bumpCursor == nullptr || static_cast<size_t>(bumpEnd - bumpCursor) < blockSize) {
+        // The unused tail of the previous arena is simply abandoned
+        char* arena = static_cast<char*>(::operator new(ARENA_SIZE));
+        arenas.push_back(arena);
+        bumpCursor = arena;
+        bumpEnd = arena + ARENA_SIZE;
+    }
+    void* block = bumpCursor;
+    bumpCursor += blockSize;
+    return block;
+}
+
+size_t MemoryPool::bytesInUse() const {
+    size_t total = 0;
+    for (size_t i = 0; i < SIZE_CLASSES; ++i) {
+        total += classes[i].stats.blocksInUse * (i + 1) * GRANULE;
+    }
+    return total;
+}
+
+std::string MemoryPool::statsString() const {
+    char line[128];
+    std::snprintf(line, sizeof(line), "pool: %zu bytes in use, %zu bytes reserved in %zu arenas",
+                  bytesInUse(), bytesReserved(), arenas.size());
+    std::string result = line;
+    for (size_t i = 0; i < SIZE_CLASSES; ++i) {
+        const ClassStats& stats = classes[i].stats;
+        if (stats.allocations == 0) continue;
+        std::snprintf(line, sizeof(line), "\n  %4zu B: %zu in use (%zu bytes), %zu free, %zu allocations",
+                      (i + 1) * GRANULE, stats.blocksInUse, stats.blocksInUse * (i + 1) * GRANULE,
+                      stats.blocksFree, stats.allocations);
+        result += line;
+    }
+    return result;
+}
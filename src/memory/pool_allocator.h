@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef> // For size_t
+#include <memory>  // For std::shared_ptr
+#include <new>     // For ::operator new
+#include <string>
+#include <vector>
+
+// Per-interpreter small-object allocator.
+// Requests up to MAX_SMALL_SIZE bytes are rounded up to a 16-byte size class and
+// served from that class's free list, which is refilled by bump-allocating from
+// 64 KB arenas. Arenas are only returned to the system when the pool is destroyed.
+// A pool is not thread-safe: it belongs to one interpreter, and every allocation
+// from it must be freed on that interpreter's thread. Objects that can end up on
+// ThreadPool workers (maps, lists handed to pure natives) must not come from it.
+class MemoryPool {
+public:
+    static constexpr size_t GRANULE = 16;
+    static constexpr size_t MAX_SMALL_SIZE = 512;
+    static constexpr size_t SIZE_CLASSES = MAX_SMALL_SIZE / GRANULE;
+    static constexpr size_t ARENA_SIZE = 64 * 1024;
+
+    struct ClassStats {
+        size_t blocksInUse = 0;
+        size_t blocksFree = 0;   // On the free list, ready for reuse
+        size_t allocations = 0;  // Total served since the pool was created
+    };
+
+    MemoryPool() = default;
+    MemoryPool(const MemoryPool&) = delete;
+    MemoryPool& operator=(const MemoryPool&) = delete;
+    ~MemoryPool();
+
+    void* allocate(size_t bytes);
+    void deallocate(void* pointer, size_t bytes);
+
+    size_t bytesInUse() const;
+    size_t bytesReserved() const { return arenas.size() * ARENA_SIZE; }
+    const ClassStats& classStats(size_t sizeClass) const { return classes[sizeClass].stats; }
+    std::string statsString() const;
+
+private:
+    struct FreeBlock { FreeBlock* next; };
+    struct SizeClass {
+        FreeBlock* freeList = nullptr;
+        ClassStats stats;
+    };
+
+    static size_t classIndex(size_t bytes) { return (bytes + GRANULE - 1) / GRANULE - 1; }
+    void* allocateFromArena(size_t blockSize);
+
+    SizeClass classes[SIZE_CLASSES];
+    std::vector<char*> arenas;
+    char* bumpCursor = nullptr;
+    char* bumpEnd = nullptr;
+};
+
+// std-compatible allocator over a shared MemoryPool. Every container or
+// allocate_shared control block holds a reference, so the pool outlives all of
+// its allocations. A null pool falls back to the global operator new.
+template <typename T>
+class PoolAllocator {
+public:
+    using value_type = T;
+
+    PoolAllocator() noexcept = default;
+    explicit PoolAllocator(std::shared_ptr<MemoryPool> pool) noexcept : pool(std::move(pool)) {}
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>& other) noexcept : pool(other.pool) {}
+
+    T* allocate(size_t n) {
+        size_t bytes = n * sizeof(T);
+        if (pool && bytes <= MemoryPool::MAX_SMALL_SIZE) {
+            return static_cast<T*>(pool->allocate(bytes));
+        }
+        return static_cast<T*>(::operator new(bytes));
+    }
+
+    void deallocate(T* pointer, size_t n) noexcept {
+        size_t bytes = n * sizeof(T);
+        if (pool && bytes <= MemoryPool::MAX_SMALL_SIZE) {
+            pool->deallocate(pointer, bytes);
+        } else {
+            ::operator delete(pointer);
+        }
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>& other) const noexcept { return pool == other.pool; }
+    template <typename U>
+    bool operator!=(const PoolAllocator<U>& other) const noexcept { return pool != other.pool; }
+
+    std::shared_ptr<MemoryPool> pool;
+};
@@ -29,6 +29,11 @@ bool Parser::check(TokenType type) const {
     return peek().type == type;
 }
 
+bool Parser::checkAhead(int distance, TokenType type) const {
+    size_t index = static_cast<size_t>(current + distance);
+    return index < tokens.size() && tokens[index].type == type;
+}
+
 // Helper to check if current token matches any of the types and consume it
 bool Parser::match(const std::vector<TokenType>& types) {
     for (TokenType type : types) {
@@ -173,6 +178,12 @@ std::shared_ptr<Stmt> Parser::whileStatement() {
 std::shared_ptr<Stmt> Parser::forStatement() {
     consume(TokenType::LEFT_PAREN, "Expect '(' after 'for'.");
 
+    // for (x in iterable) / for (var x in iterable)
+    if ((check(TokenType::IDENTIFIER) && checkAhead(1, TokenType::IN)) ||
+        (check(TokenType::VAR) && checkAhead(1, TokenType::IDENTIFIER) && checkAhead(2, TokenType::IN))) {
+        return forInStatement();
+    }
+
     std::shared_ptr<Stmt> initializer;
     if (match({TokenType::SEMICOLON})) {
         initializer = nullptr;
@@ -219,6 +230,17 @@ std::shared_ptr<Stmt> Parser::forStatement() {
     return body;
 }
 
+std::shared_ptr<Stmt> Parser::forInStatement() {
+    match({TokenType::VAR}); // Optional: the loop variable is always local to the loop
+    Token name = consume(TokenType::IDENTIFIER, "Expect loop variable name.");
+    consume(TokenType::IN, "Expect 'in' after loop variable.");
+    std::shared_ptr<Expr> iterable = expression();
+    consume(TokenType::RIGHT_PAREN, "Expect ')' after for-in clause.");
+
+    std::shared_ptr<Stmt> body = statement();
+    return std::make_shared<ForInStmt>(name, iterable, body);
+}
+
 std::shared_ptr<Stmt> Parser::returnStatement() {
     Token keyword = previous();
     std::shared_ptr<Expr> value = nullptr;
@@ -256,7 +278,14 @@ std::shared_ptr<Expr> Parser::assignment() {
         if (std::shared_ptr<GetExpr> get_expr = std::dynamic_pointer_cast<GetExpr>(expr)) {
             // Check if it's property access (using name) or indexed access (using index)
             if (get_expr->index != nullptr) { // Indexed access (e.g., list[0] = value)
-                 return std::make_shared<SetExpr>(get_expr->object, get_expr->index, value);
+                 auto set_expr = std::make_shared<SetExpr>(get_expr->object, get_expr->index, value);
+                 Expr* root = set_expr->object.get();
+                 while (auto* get = dynamic_cast<GetExpr*>(root)) {
+                     set_expr->path.push_back(get);
+                     root = get->object.get();
+                 }
+                 set_expr->root = dynamic_cast<VariableExpr*>(root);
+                 return set_expr;
             } else { // Property access (e.g., obj.prop = value)
                 // This assumes GetExpr can represent property access via 'name'
                 // If GetExpr is solely for indexed access, you'll need another Expr type for property access
@@ -347,25 +376,32 @@ std::shared_ptr<Expr> Parser::unary() {
     return call();
 }
 
-// Call expression parsing for function calls and property access
+// Call expression parsing for function calls, method calls, indexing and slicing
 std::shared_ptr<Expr> Parser::call() {
     std::shared_ptr<Expr> expr = primary();
 
     while (true) {
         if (match({TokenType::LEFT_PAREN})) {
             expr = finishCall(expr);
-        } else if (match({TokenType::DOT})) {
-            Token name = consume(TokenType::IDENTIFIER, "Expect property name after '.'.");
-            // This is where GetExpr (for property access) or other structures would be used.
-            // For now, assuming GetExpr is only for indexed access as per constructor.
-            // If you want property access, you might need a different AST node or an overloaded GetExpr constructor.
-            // The current GetExpr(object, index) implies indexed access.
-            // If .name is for properties, this part needs a specific GetExpr for properties.
-            throw ParseError(name, "Property access via '.' is not fully implemented with current GetExpr structure. Only indexed access (list[idx]) is.");
-        } else if (match({TokenType::LEFT_BRACKET})) { // For list indexing
-            std::shared_ptr<Expr> index = expression();
-            consume(TokenType::RIGHT_BRACKET, "Expect ']' after index.");
-            expr = std::make_shared<GetExpr>(expr, index);
+        } else if (match({TokenType::DOT})) { // Method calls, e.g. s.split(",")
+            Token name = consume(TokenType::IDENTIFIER, "Expect method name after '.'.");
+            consume(TokenType::LEFT_PAREN, "Expect '(' after method name.");
+            std::vector<std::shared_ptr<Expr>> arguments = argumentList();
+            Token paren = consume(TokenType::RIGHT_PAREN, "Expect ')' after arguments.");
+            expr = std::make_shared<MethodCallExpr>(expr, name, paren, arguments);
+        } else if (match({TokenType::LEFT_BRACKET})) { // For list indexing, or slicing with [start:stop]
+            Token bracket = previous();
+            std::shared_ptr<Expr> index = check(TokenType::COLON) ? nullptr : expression();
+            if (match({TokenType::COLON})) {
+                std::shared_ptr<Expr> stop = check(TokenType::RIGHT_BRACKET) ? nullptr : expression();
+                consume(TokenType::RIGHT_BRACKET, "Expect ']' after slice.");
+                expr = std::make_shared<SliceExpr>(expr, bracket, index, stop);
+            } else {
+                consume(TokenType::RIGHT_BRACKET, "Expect ']' after index.");
+                auto get = std::make_shared<GetExpr>(expr, index);
+                get->variable = dynamic_cast<VariableExpr*>(expr.get());
+                expr = get;
+            }
         }
         else {
             break;
@@ -375,6 +411,13 @@ std::shared_ptr<Expr> Parser::call() {
 }
 
 std::shared_ptr<Expr> Parser::finishCall(std::shared_ptr<Expr> callee) {
+    std::vector<std::shared_ptr<Expr>> arguments = argumentList();
+    Token paren = consume(TokenType::RIGHT_PAREN, "Expect ')' after arguments.");
+    return std::make_shared<CallExpr>(callee, paren, arguments);
+}
+
+// Comma-separated arguments up to (not including) the closing ')'
+std::vector<std::shared_ptr<Expr>> Parser::argumentList() {
     std::vector<std::shared_ptr<Expr>> arguments;
     if (!check(TokenType::RIGHT_PAREN)) {
         do {
@@ -384,8 +427,7 @@ std::shared_ptr<Expr> Parser::finishCall(std::shared_ptr<Expr> callee) {
             arguments.push_back(expression());
         } while (match({TokenType::COMMA}));
     }
-    Token paren = consume(TokenType::RIGHT_PAREN, "Expect ')' after arguments.");
-    return std::make_shared<CallExpr>(callee, paren, arguments);
+    return arguments;
 }
 
 
@@ -407,6 +449,20 @@ std::shared_ptr<Expr> Parser::primary() {
         return std::make_shared<ListExpr>(elements);
     }
 
+    if (match({TokenType::LEFT_BRACE})) { // For map literals e.g., {"name": "shark", 1: true}
+        std::vector<std::shared_ptr<Expr>> keys;
+        std::vector<std::shared_ptr<Expr>> values;
+        if (!check(TokenType::RIGHT_BRACE)) {
+            do {
+                keys.push_back(expression());
+                consume(TokenType::COLON, "Expect ':' after map key.");
+                values.push_back(expression());
+            } while (match({TokenType::COMMA}));
+        }
+        consume(TokenType::RIGHT_BRACE, "Expect '}' after map literal.");
+        return std::make_shared<MapExpr>(keys, values);
+    }
+
     if (match({TokenType::IDENTIFIER})) {
         return std::make_shared<VariableExpr>(previous());
     }
@@ -22,6 +22,7 @@ private:
     Token peek() const;
     Token previous() const;
     bool check(TokenType type) const;
+    bool checkAhead(int distance, TokenType type) const; // Looks past the current token
     bool match(const std::vector<TokenType>& types);
     Token consume(TokenType type, const std::string& message);
     void synchronize();
@@ -38,6 +39,7 @@ private:
     std::shared_ptr<IfStmt> ifStatement();
     std::shared_ptr<WhileStmt> whileStatement();
     std::shared_ptr<Stmt> forStatement();
+    std::shared_ptr<Stmt> forInStatement();
     std::shared_ptr<ReturnStmt> returnStatement();
     std::shared_ptr<ExpressionStmt> expressionStatement();
 
@@ -53,5 +55,6 @@ private:
     std::shared_ptr<Expr> unary();
     std::shared_ptr<Expr> call();
     std::shared_ptr<Expr> finishCall(std::shared_ptr<Expr> callee);
+    std::vector<std::shared_ptr<Expr>> argumentList();
     std::shared_ptr<Expr> primary();
 };
\ No newline at end of file
@@ -0,0 +1,199 @@
+#include "bytes_value.h"
+#include "../util/error.h"
+#include <cmath>   // For std::trunc
+#include <cstring> // For std::memcpy
+#include <fstream>
+#include <limits>
+#include <new>     // For std::bad_alloc
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>    // For open
+#include <sys/mman.h> // For mmap, munmap
+#include <sys/stat.h> // For fstat
+#include <unistd.h>   // For close
+#define MEGALADON_HAS_MMAP 1
+#else
+#define MEGALADON_HAS_MMAP 0
+#endif
+
+namespace {
+// A length the allocator refuses is a script error, not a crash
+std::shared_ptr<uint8_t> allocateBytes(size_t length) {
+    try {
+        return std::shared_ptr<uint8_t>(new uint8_t[length > 0 ? length : 1](), std::default_delete<uint8_t[]>());
+    } catch (const std::bad_alloc&) {
+        throw MegaladonError("bytes() length is too large.");
+    }
+}
+
+constexpr bool hostIsBigEndian() {
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__)
+    return __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__;
+#else
+    return false;
+#endif
+}
+
+// Copies 'width' bytes, reversing them when the byte order differs from the host's
+void copyOrdered(void* to, const void* from, size_t width, bool bigEndian) {
+    if (bigEndian == hostIsBigEndian()) {
+        std::memcpy(to, from, width);
+        return;
+    }
+    auto* out = static_cast<uint8_t*>(to);
+    const auto* in = static_cast<const uint8_t*>(from);
+    for (size_t i = 0; i < width; ++i) {
+        out[i] = in[width - 1 - i];
+    }
+}
+
+template <typename T>
+T loadAs(const uint8_t* at, bool bigEndian) {
+    T value;
+    copyOrdered(&value, at, sizeof(T), bigEndian);
+    return value;
+}
+
+template <typename T>
+void storeAs(uint8_t* at, bool bigEndian, double value) {
+    if (std::trunc(value) != value || value < static_cast<double>(std::numeric_limits<T>::min()) ||
+        value > static_cast<double>(std::numeric_limits<T>::max())) {
+        throw MegaladonError("Value does not fit the packed integer type.");
+    }
+    T converted = static_cast<T>(value);
+    copyOrdered(at, &converted, sizeof(T), bigEndian);
+}
+} // namespace
+
+MegaladonBytes::MegaladonBytes(size_t length) : data_(allocateBytes(length)), length_(length) {}
+
+MegaladonBytes MegaladonBytes::copyOf(std::string_view bytes) {
+    MegaladonBytes result(bytes.size());
+    if (!bytes.empty()) std::memcpy(result.data(), bytes.data(), bytes.size());
+    return result;
+}
+
+MegaladonBytes MegaladonBytes::mapFile(const std::string& path) {
+#if MEGALADON_HAS_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw MegaladonError("Could not open file '" + path + "'.");
+    }
+    struct stat info;
+    if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+        size_t length = static_cast<size_t>(info.st_size);
+        // Private writable pages: reads come straight from the page cache, and
+        // writes through the bytes value copy the touched page instead of the file
+        void* mapped = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapped != MAP_FAILED) {
+            std::shared_ptr<uint8_t> data(static_cast<uint8_t*>(mapped), [length](uint8_t* address) {
+                ::munmap(address, length);
+            });
+            return MegaladonBytes(std::move(data), length);
+        }
+    } else {
+        ::close(fd);
+    }
+#endif
+    // Empty files, pipes and platforms without mmap
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw MegaladonError("Could not open file '" + path + "'.");
+    }
+    std::vector<char> contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return copyOf(std::string_view(contents.data(), contents.size()));
+}
+
+MegaladonBytes MegaladonBytes::slice(size_t start, size_t stop) const {
+    // Aliasing constructor: shares ownership of the whole buffer, points at 'start'
+    return MegaladonBytes(std::shared_ptr<uint8_t>(data_, data_.get() + start), stop - start);
+}
+
+bool MegaladonBytes::parseFormat(std::string_view text, NumberFormat& format) {
+    format.bigEndian = false;
+    if (text.size() > 2 && (text.substr(text.size() - 2) == "be" || text.substr(text.size() - 2) == "le")) {
+        format.bigEndian = text.substr(text.size() - 2) == "be";
+        text.remove_suffix(2);
+    }
+    static const struct { const char* name; NumberKind kind; size_t width; } formats[] = {
+        {"u8", NumberKind::U8, 1},   {"i8", NumberKind::I8, 1},   {"u16", NumberKind::U16, 2},
+        {"i16", NumberKind::I16, 2}, {"u32", NumberKind::U32, 4}, {"i32", NumberKind::I32, 4},
+        {"u64", NumberKind::U64, 8}, {"i64", NumberKind::I64, 8}, {"f32", NumberKind::F32, 4},
+        {"f64", NumberKind::F64, 8},
+    };
+    for (const auto& candidate : formats) {
+        if (text == candidate.name) {
+            format.kind = candidate.kind;
+            format.width = candidate.width;
+            return true;
+        }
+    }
+    return false;
+}
+
+double MegaladonBytes::read(size_t offset, const NumberFormat& format) const {
+    const uint8_t* at = data() + offset;
+    bool big = format.bigEndian;
+    switch (format.kind) {
+        case NumberKind::U8: return at[0];
+        case NumberKind::I8: return static_cast<int8_t>(at[0]);
+        case NumberKind::U16: return loadAs<uint16_t>(at, big);
+        case NumberKind::I16: return loadAs<int16_t>(at, big);
+        case NumberKind::U32: return loadAs<uint32_t>(at, big);
+        case NumberKind::I32: return loadAs<int32_t>(at, big);
+        case NumberKind::U64: return static_cast<double>(loadAs<uint64_t>(at, big));
+        case NumberKind::I64: return static_cast<double>(loadAs<int64_t>(at, big));
+        case NumberKind::F32: return loadAs<float>(at, big);
+        case NumberKind::F64: return loadAs<double>(at, big);
+    }
+    return 0.0;
+}
+
+void MegaladonBytes::write(size_t offset, const NumberFormat& format, double value) const {
+    uint8_t* at = data() + offset;
+    bool big = format.bigEndian;
+    switch (format.kind) {
+        case NumberKind::U8: storeAs<uint8_t>(at, big, value); return;
+        case NumberKind::I8: storeAs<int8_t>(at, big, value); return;
+        case NumberKind::U16: storeAs<uint16_t>(at, big, value); return;
+        case NumberKind::I16: storeAs<int16_t>(at, big, value); return;
+        case NumberKind::U32: storeAs<uint32_t>(at, big, value); return;
+        case NumberKind::I32: storeAs<int32_t>(at, big, value); return;
+        // 2^64 - 1 and 2^63 - 1 round up to the next power of two as doubles, so
+        // those bounds are exclusive
+        case NumberKind::U64: {
+            if (!(value >= 0.0 && value < 18446744073709551616.0) || std::trunc(value) != value) {
+                throw MegaladonError("Value does not fit the packed integer type.");
+            }
+            uint64_t converted = static_cast<uint64_t>(value);
+            copyOrdered(at, &converted, 8, big);
+            return;
+        }
+        case NumberKind::I64: {
+            if (!(value >= -9223372036854775808.0 && value < 9223372036854775808.0) || std::trunc(value) != value) {
+                throw MegaladonError("Value does not fit the packed integer type.");
+            }
+            int64_t converted = static_cast<int64_t>(value);
+            copyOrdered(at, &converted, 8, big);
+            return;
+        }
+        case NumberKind::F32: {
+            float converted = static_cast<float>(value);
+            copyOrdered(at, &converted, 4, big);
+            return;
+        }
+        case NumberKind::F64:
+            copyOrdered(at, &value, 8, big);
+            return;
+    }
+}
+
+size_t MegaladonBytes::find(std::string_view needle, size_t from) const {
+    if (from > length_) return npos;
+    return view().find(needle, from); // memchr for the first byte, then memcmp
+}
+
+bool operator==(const MegaladonBytes& lhs, const MegaladonBytes& rhs) {
+    return lhs.size() == rhs.size() && (lhs.data() == rhs.data() || lhs.view() == rhs.view());
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <memory>  // For std::shared_ptr
+#include <cstddef> // For size_t
+#include <cstdint> // For uint8_t
+
+// --- MegaladonBytes Definition ---
+// Mutable byte buffer for binary data. A bytes value is a window onto a
+// refcounted buffer: copying the value or slicing it is O(1) and shares the
+// bytes, so writes through a slice are seen by every value sharing them
+// (like a memoryview). The buffer can be a plain allocation or a mapped file.
+class MegaladonBytes {
+public:
+    // Fixed-width numbers for pack()/unpack()
+    enum class NumberKind : unsigned char { U8, I8, U16, I16, U32, I32, U64, I64, F32, F64 };
+    struct NumberFormat {
+        NumberKind kind;
+        size_t width;   // In bytes
+        bool bigEndian; // Little-endian unless the format ends in "be"
+    };
+
+    MegaladonBytes() : length_(0) {}
+    explicit MegaladonBytes(size_t length); // Zero-filled
+    static MegaladonBytes copyOf(std::string_view bytes);
+    // Maps the file into memory as private copy-on-write pages: the bytes can be
+    // written (b[i] = x, pack()), but a write only changes this process's copy
+    // of the page, never the file. Falls back to reading it when it cannot be
+    // mapped.
+    static MegaladonBytes mapFile(const std::string& path);
+
+    size_t size() const { return length_; }
+    uint8_t* data() const { return data_.get(); }
+    std::string_view view() const { return std::string_view(reinterpret_cast<const char*>(data_.get()), length_); }
+
+    // Bytes [start, stop) sharing this buffer; the caller checks the bounds
+    MegaladonBytes slice(size_t start, size_t stop) const;
+
+    // Parses "u8", "i16", "u32be", "f64le", ...; returns false for anything else
+    static bool parseFormat(std::string_view text, NumberFormat& format);
+    // The caller checks that [offset, offset + format.width) is in bounds.
+    // 64-bit integers go through a double, so they are exact up to 2^53.
+    double read(size_t offset, const NumberFormat& format) const;
+    void write(size_t offset, const NumberFormat& format, double value) const; // Throws if 'value' does not fit
+
+    // Position of the first occurrence of 'needle' at or after 'from', or npos
+    size_t find(std::string_view needle, size_t from = 0) const;
+
+    static constexpr size_t npos = std::string_view::npos;
+
+private:
+    MegaladonBytes(std::shared_ptr<uint8_t> data, size_t length) : data_(std::move(data)), length_(length) {}
+
+    std::shared_ptr<uint8_t> data_; // Points at this window's first byte; owns the whole buffer
+    size_t length_;
+};
+
+// Equal when the contents are equal
+bool operator==(const MegaladonBytes& lhs, const MegaladonBytes& rhs);
+// --- End MegaladonBytes Definition ---
@@ -0,0 +1,369 @@
+#include "file_records.h"
+#include "../util/error.h"
+#include "../util/string_kernels.h"
+#include <algorithm> // For std::min, std::max
+#include <cstdio>    // For std::fopen, std::fread (without mmap)
+#include <cstring>   // For std::memcpy
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>     // For errno, EINTR
+#include <fcntl.h>    // For open
+#include <sys/mman.h> // For mmap, munmap, madvise
+#include <sys/stat.h> // For fstat
+#include <unistd.h>   // For read, close
+#define MEGALADON_HAS_MMAP 1
+#else
+#define MEGALADON_HAS_MMAP 0
+#endif
+
+namespace {
+// Mapped files are paged in this far ahead of the record being read
+constexpr size_t PREFETCH_WINDOW = size_t(4) << 20;
+// Streams are read in chunks of at least this size
+constexpr size_t STREAM_CHUNK = size_t(1) << 20;
+
+constexpr size_t npos = std::string_view::npos;
+
+// The record 'text[0, end)', as a string sharing 'owner's bytes. Short records
+// are copied inline, which is cheaper than sharing.
+template <typename Owner>
+MegaladonString record(const std::shared_ptr<Owner>& owner, std::string_view text, size_t end, bool lines) {
+    if (lines && end > 0 && text[end - 1] == '\r') --end;
+    if (end <= MegaladonString::INLINE_CAPACITY) return MegaladonString(text.substr(0, end));
+    return MegaladonString::fromBuffer(std::shared_ptr<const char>(owner, text.data()), end);
+}
+
+#if MEGALADON_HAS_MMAP
+using InputFile = int;
+#else
+using InputFile = std::FILE*;
+#endif
+
+// Opens 'path' for reading; "-" is standard input, which 'owned' marks as not ours to close
+InputFile openInput(const std::string& path, bool& owned) {
+    owned = path != "-";
+#if MEGALADON_HAS_MMAP
+    if (!owned) return 0;
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw MegaladonError("Could not open file '" + path + "'.");
+    }
+    return fd;
+#else
+    if (!owned) return stdin;
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        throw MegaladonError("Could not open file '" + path + "'.");
+    }
+    return file;
+#endif
+}
+
+void closeInput(InputFile input) {
+#if MEGALADON_HAS_MMAP
+    ::close(input);
+#else
+    std::fclose(input);
+#endif
+}
+
+// Reads what is available, up to 'count' bytes; 0 at the end of the input
+size_t readInput(InputFile input, char* into, size_t count, const std::string& path) {
+#if MEGALADON_HAS_MMAP
+    while (true) {
+        ssize_t got = ::read(input, into, count);
+        if (got >= 0) return static_cast<size_t>(got);
+        if (errno != EINTR) throw MegaladonError("Could not read file '" + path + "'.");
+    }
+#else
+    size_t got = std::fread(into, 1, count, input);
+    if (got == 0 && std::ferror(input)) throw MegaladonError("Could not read file '" + path + "'.");
+    return got;
+#endif
+}
+
+#if MEGALADON_HAS_MMAP
+// Maps the file open on 'fd' read-only and closes it. Returns null, leaving
+// 'fd' open, for empty files (which cannot be mapped), pipes and devices.
+std::shared_ptr<const char> mapInput(int fd, size_t& length) {
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || info.st_size <= 0) return nullptr;
+    length = static_cast<size_t>(info.st_size);
+    void* mapped = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapped == MAP_FAILED) return nullptr;
+    ::close(fd);
+    size_t size = length;
+    return std::shared_ptr<const char>(static_cast<const char*>(mapped), [size](const char* address) {
+        ::munmap(const_cast<char*>(address), size);
+    });
+}
+#endif
+
+#if MEGALADON_HAS_MMAP
+// Records of a mapped file. The records keep the mapping alive.
+class MappedRecordIterator : public MegaladonIterator {
+public:
+    MappedRecordIterator(std::shared_ptr<const char> base, size_t length, std::string delimiter)
+        : base(std::move(base)), length(length), delimiter(std::move(delimiter)), lines(this->delimiter == "\n") {}
+
+    bool next(MegaladonValue& item) override {
+        if (position >= length) return false;
+        // Keep a window's worth of pages on their way in ahead of the reader
+        while (prefetched < length && position + PREFETCH_WINDOW >= prefetched) {
+            size_t window = std::min(PREFETCH_WINDOW, length - prefetched);
+            ::madvise(const_cast<char*>(base.get()) + prefetched, window, MADV_WILLNEED);
+            prefetched += window;
+        }
+        std::string_view rest(base.get() + position, length - position);
+        size_t end = kernelFind(rest, delimiter);
+        if (end == npos) {
+            item = MegaladonValue(record(base, rest, rest.size(), lines));
+            position = length;
+        } else {
+            item = MegaladonValue(record(base, rest, end, lines));
+            position += end + delimiter.size();
+        }
+        return true;
+    }
+
+private:
+    std::shared_ptr<const char> base;
+    size_t length;
+    std::string delimiter;
+    bool lines;
+    size_t position = 0;
+    size_t prefetched = 0; // Pages before this offset have been asked for
+};
+#endif
+
+// Records of a pipe, terminal or anything else that cannot be mapped, read a
+// chunk at a time. Records handed out keep their chunk alive, so a chunk is
+// never reused: a record left unfinished at the end of one is copied to the
+// start of the next.
+class StreamRecordIterator : public MegaladonIterator {
+public:
+    StreamRecordIterator(InputFile input, bool ownsFile, std::string path, std::string delimiter)
+        : input(input), ownsFile(ownsFile), path(std::move(path)), delimiter(std::move(delimiter)), lines(this->delimiter == "\n") {}
+    ~StreamRecordIterator() override {
+        if (ownsFile) closeInput(input);
+    }
+
+    bool next(MegaladonValue& item) override {
+        while (true) {
+            std::string_view rest(chunk.get() + position, filled - position);
+            size_t end = kernelFind(rest, delimiter, scanned);
+            if (end != npos) {
+                item = MegaladonValue(record(chunk, rest, end, lines));
+                position += end + delimiter.size();
+                scanned = 0;
+                return true;
+            }
+            if (finished) {
+                if (rest.empty()) return false;
+                item = MegaladonValue(record(chunk, rest, rest.size(), lines));
+                position = filled;
+                return true;
+            }
+            // Only the new bytes need searching, plus a delimiter straddling the old end
+            scanned = rest.size() >= delimiter.size() ? rest.size() - delimiter.size() + 1 : 0;
+            refill();
+        }
+    }
+
+private:
+    void refill() {
+        if (filled == capacity) {
+            size_t pending = filled - position;
+            size_t grown = std::max(STREAM_CHUNK, pending * 2);
+            std::shared_ptr<char> next(new char[grown], std::default_delete<char[]>());
+            if (pending > 0) std::memcpy(next.get(), chunk.get() + position, pending);
+            chunk = std::move(next);
+            capacity = grown;
+            filled = pending;
+            position = 0;
+        }
+        size_t got = readInput(input, chunk.get() + filled, capacity - filled, path);
+        filled += got;
+        finished = got == 0;
+    }
+
+    InputFile input;
+    bool ownsFile;
+    std::string path;
+    std::string delimiter;
+    bool lines;
+    std::shared_ptr<char> chunk;
+    size_t capacity = 0;
+    size_t filled = 0;   // Bytes of 'chunk' read so far
+    size_t position = 0; // Start of the next record in 'chunk'
+    size_t scanned = 0;  // Bytes after 'position' known not to start a delimiter
+    bool finished = false;
+};
+
+// True if a proper prefix of 'delimiter' is also a suffix ("aa", "abab"), so
+// that two occurrences can overlap
+bool overlapsItself(const std::string& delimiter) {
+    for (size_t k = 1; k < delimiter.size(); ++k) {
+        if (delimiter.compare(0, k, delimiter, delimiter.size() - k, k) == 0) return true;
+    }
+    return false;
+}
+
+// The boundary rule of both chunk readers: a chunk starting at text[0] ends
+// just after the first delimiter that ends at or after 'target' bytes, where
+// only the delimiters read_records matches count (left to right from the
+// chunk's start, each search starting after the previous match). npos if
+// there is none in 'text'.
+// Occurrences of a delimiter that cannot overlap itself are all matches, so
+// the search starts near the target; otherwise it has to walk the matches
+// from the start ("aaa" with "aa" ends a record after the second byte, not
+// the third).
+size_t chunkEnd(std::string_view text, const std::string& delimiter, bool overlapping, size_t target) {
+    size_t from = overlapping ? 0 : target - std::min(target, delimiter.size() - 1);
+    for (size_t found = kernelFind(text, delimiter, from); found != npos;
+         found = kernelFind(text, delimiter, found + delimiter.size())) {
+        if (found + delimiter.size() >= target) return found + delimiter.size();
+    }
+    return npos;
+}
+
+#if MEGALADON_HAS_MMAP
+// Chunks of a mapped file, cut in place
+class MappedChunkReader : public FileChunkReader {
+public:
+    MappedChunkReader(std::shared_ptr<const char> base, size_t length, std::string delimiter, size_t target)
+        : base(std::move(base)), length(length), delimiter(std::move(delimiter)), target(target),
+          overlapping(overlapsItself(this->delimiter)) {}
+
+    bool next(std::shared_ptr<const char>& owner, std::string_view& chunk) override {
+        if (position >= length) return false;
+        size_t end = length;
+        if (length - position > target) {
+            size_t found = chunkEnd(std::string_view(base.get() + position, length - position), delimiter, overlapping, target);
+            if (found != npos) end = position + found;
+        }
+        // Chunks may be read out of order by several threads, so ask for each one's pages up front
+        static const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        size_t first = position / page * page;
+        ::madvise(const_cast<char*>(base.get()) + first, end - first, MADV_WILLNEED);
+
+        owner = base;
+        chunk = std::string_view(base.get() + position, end - position);
+        position = end;
+        return true;
+    }
+
+    size_t totalBytes() const override { return length; }
+
+private:
+    std::shared_ptr<const char> base;
+    size_t length;
+    std::string delimiter;
+    size_t target;
+    bool overlapping;
+    size_t position = 0;
+};
+#endif
+
+// Chunks of a stream, each read into a buffer of its own, cut by the same rule
+// as mapped files so both give the same chunks. A buffer holds a quarter more
+// than the target, so the cut is usually in it; the bytes after the cut start
+// the next buffer.
+class StreamChunkReader : public FileChunkReader {
+public:
+    StreamChunkReader(InputFile input, bool ownsFile, std::string path, std::string delimiter, size_t target)
+        : input(input), ownsFile(ownsFile), path(std::move(path)), delimiter(std::move(delimiter)), target(target),
+          overlapping(overlapsItself(this->delimiter)) {}
+    ~StreamChunkReader() override {
+        if (ownsFile) closeInput(input);
+    }
+
+    bool next(std::shared_ptr<const char>& owner, std::string_view& chunk) override {
+        if (finished && carried.empty()) return false;
+        size_t capacity = std::max(target + target / 4 + delimiter.size(), carried.size() * 2);
+        std::shared_ptr<char> buffer(new char[capacity], std::default_delete<char[]>());
+        std::memcpy(buffer.get(), carried.data(), carried.size());
+        size_t filled = carried.size();
+        carried.clear();
+        while (true) {
+            while (!finished && filled < capacity) {
+                size_t got = readInput(input, buffer.get() + filled, capacity - filled, path);
+                finished = got == 0;
+                filled += got;
+            }
+            std::string_view text(buffer.get(), filled);
+            size_t end = filled > target ? chunkEnd(text, delimiter, overlapping, target) : npos;
+            if (end == npos && finished) end = filled;
+            if (end != npos) {
+                if (end == 0) return false; // Nothing was left to read
+                carried.assign(text.substr(end));
+                owner = std::move(buffer);
+                chunk = text.substr(0, end);
+                return true;
+            }
+            // No cut in the buffer: a record runs past it
+            std::shared_ptr<char> grown(new char[capacity * 2], std::default_delete<char[]>());
+            std::memcpy(grown.get(), buffer.get(), filled);
+            buffer = std::move(grown);
+            capacity *= 2;
+        }
+    }
+
+private:
+    InputFile input;
+    bool ownsFile;
+    std::string path;
+    std::string delimiter;
+    size_t target;
+    bool overlapping;
+    std::string carried; // Bytes after the last cut
+    bool finished = false;
+};
+} // namespace
+
+std::unique_ptr<MegaladonIterator> FileRecordsIterable::iterate() const {
+    bool owned;
+    InputFile input = openInput(path, owned);
+#if MEGALADON_HAS_MMAP
+    size_t length = 0;
+    if (owned) {
+        if (auto base = mapInput(input, length)) {
+            ::madvise(const_cast<char*>(base.get()), length, MADV_SEQUENTIAL); // More read-ahead; pages behind the reader go first
+            return std::make_unique<MappedRecordIterator>(std::move(base), length, delimiter);
+        }
+    }
+#endif
+    return std::make_unique<StreamRecordIterator>(input, owned, path, delimiter);
+}
+
+std::string FileRecordsIterable::toString() const {
+    if (delimiter == "\n") return "read_lines(" + path + ")";
+    return "read_records(" + path + ")";
+}
+
+std::unique_ptr<FileChunkReader> FileChunkReader::open(const std::string& path, const std::string& delimiter, size_t target) {
+    bool owned;
+    InputFile input = openInput(path, owned);
+#if MEGALADON_HAS_MMAP
+    size_t length = 0;
+    if (owned) {
+        if (auto base = mapInput(input, length)) {
+            return std::make_unique<MappedChunkReader>(std::move(base), length, delimiter, target);
+        }
+    }
+#endif
+    return std::make_unique<StreamChunkReader>(input, owned, path, delimiter, target);
+}
+
+void appendRecords(const std::shared_ptr<const char>& owner, std::string_view chunk, const std::string& delimiter,
+                   std::vector<MegaladonValue>& records) {
+    bool lines = delimiter == "\n";
+    while (!chunk.empty()) {
+        size_t end = kernelFind(chunk, delimiter);
+        if (end == npos) {
+            records.push_back(MegaladonValue(record(owner, chunk, chunk.size(), lines)));
+            return;
+        }
+        records.push_back(MegaladonValue(record(owner, chunk, end, lines)));
+        chunk.remove_prefix(end + delimiter.size());
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <string>
+#include <memory>  // For std::unique_ptr
+#include <string_view>
+#include <vector>
+#include "iterable.h"
+
+// --- FileRecordsIterable Definition ---
+// read_lines(path) / read_records(path, delimiter): the records of a file,
+// read lazily. Each record is a string that shares the bytes it was read into
+// instead of copying them, and the delimiter is not part of it. With the
+// newline delimiter a '\r' before it is dropped too, like lines().
+//
+// Regular files are mapped into memory with sequential-access and read-ahead
+// hints, so the records are slices of the page cache. Pipes, terminals and
+// "-" (standard input) are read in large chunks instead; a record is then a
+// slice of its chunk unless it spans two of them.
+class FileRecordsIterable : public MegaladonIterable {
+public:
+    FileRecordsIterable(std::string path, std::string delimiter)
+        : path(std::move(path)), delimiter(std::move(delimiter)) {}
+    // Opens the file again for every iteration; throws if it cannot be opened
+    std::unique_ptr<MegaladonIterator> iterate() const override;
+    std::string toString() const override;
+
+private:
+    std::string path;
+    std::string delimiter; // Never empty
+};
+// --- End FileRecordsIterable Definition ---
+
+// --- FileChunkReader Definition ---
+// map_file(): a file read as chunks of about 'target' bytes, so no record is
+// split between two chunks. A chunk ends just after the first delimiter that
+// ends at or after 'target' bytes, counting only the delimiters read_records
+// matches, or at the end of the file. Mapped files and streams are cut at the
+// same places: mapped files in place, streams into a new buffer per chunk,
+// with the bytes after the cut moved to the next.
+class FileChunkReader {
+public:
+    virtual ~FileChunkReader() = default;
+    // The next chunk and the buffer that keeps its bytes alive; false at the end
+    virtual bool next(std::shared_ptr<const char>& owner, std::string_view& chunk) = 0;
+    // Size of the whole file when known before reading it (mapped files), otherwise 0
+    virtual size_t totalBytes() const { return 0; }
+
+    // Opens the file like FileRecordsIterable; throws if it cannot be opened
+    static std::unique_ptr<FileChunkReader> open(const std::string& path, const std::string& delimiter, size_t target);
+};
+// --- End FileChunkReader Definition ---
+
+// Appends the records of 'chunk' to 'records', as strings sharing 'owner' the
+// way FileRecordsIterable's do
+void appendRecords(const std::shared_ptr<const char>& owner, std::string_view chunk, const std::string& delimiter,
+                   std::vector<MegaladonValue>& records);
@@ -0,0 +1,272 @@
+#include "iterable.h"
+#include "numeric_array.h"
+#include "map_value.h"
+#include "set_value.h"
+#include "persistent_vector.h"
+#include "tensor_value.h"
+#include "../util/number_format.h"
+#include <algorithm> // For std::min, std::max
+#include <cmath> // For std::ceil, std::floor
+
+namespace {
+// Item count of a range, computed once so items are start + i * step
+// instead of a running sum that accumulates rounding error
+size_t rangeLength(double start, double stop, double step) {
+    double count = std::ceil((stop - start) / step);
+    return count > 0 ? static_cast<size_t>(count) : 0;
+}
+
+class RangeIterator : public MegaladonIterator {
+public:
+    RangeIterator(double start, double step, size_t count) : start(start), step(step), count(count) {}
+    bool next(MegaladonValue& item) override {
+        if (index >= count) return false;
+        item = MegaladonValue(start + static_cast<double>(index++) * step);
+        return true;
+    }
+
+private:
+    double start;
+    double step;
+    size_t count;
+    size_t index = 0;
+};
+
+class CharsIterator : public MegaladonIterator {
+public:
+    explicit CharsIterator(MegaladonString text) : text(std::move(text)) {}
+    bool next(MegaladonValue& item) override {
+        if (position >= text.size()) return false;
+        item = MegaladonValue(text.substr(position++, 1)); // Single characters are stored inline
+        return true;
+    }
+
+private:
+    MegaladonString text;
+    size_t position = 0;
+};
+
+class LinesIterator : public MegaladonIterator {
+public:
+    explicit LinesIterator(MegaladonString text) : text(std::move(text)) {}
+    bool next(MegaladonValue& item) override {
+        if (position >= text.size()) return false;
+        std::string_view rest = text.view().substr(position);
+        size_t end = rest.find('\n');
+        size_t length = (end == std::string_view::npos) ? rest.size() : end;
+        size_t lineLength = (length > 0 && rest[length - 1] == '\r') ? length - 1 : length;
+        item = MegaladonValue(text.substr(position, lineLength));
+        position += (end == std::string_view::npos) ? length : length + 1;
+        return true;
+    }
+
+private:
+    MegaladonString text;
+    size_t position = 0;
+};
+
+// Walks elements [index, stop) of a storage it keeps alive
+class ListIterator : public MegaladonIterator {
+public:
+    ListIterator(std::shared_ptr<ListStorage> storage, size_t start, size_t stop)
+        : storage(std::move(storage)), index(start), stop(stop) {}
+    bool next(MegaladonValue& item) override {
+        if (index >= stop) return false;
+        item = storage->elements[index++];
+        return true;
+    }
+
+private:
+    std::shared_ptr<ListStorage> storage;
+    size_t index;
+    size_t stop;
+};
+
+// Arrays are shared and mutable, so the length is rechecked on every step
+class ArrayIterator : public MegaladonIterator {
+public:
+    explicit ArrayIterator(std::shared_ptr<NumericArray> array) : array(std::move(array)) {}
+    bool next(MegaladonValue& item) override {
+        if (index >= array->size()) return false;
+        item = MegaladonValue(array->values[index++]);
+        return true;
+    }
+
+private:
+    std::shared_ptr<NumericArray> array;
+    size_t index = 0;
+};
+
+// Keys in insertion order. Keys added during the loop are visited too, and
+// keys removed during the loop are skipped (the map does not compact meanwhile).
+class MapKeyIterator : public MegaladonIterator {
+public:
+    explicit MapKeyIterator(std::shared_ptr<MegaladonMap> map) : map(std::move(map)) { this->map->beginIteration(); }
+    ~MapKeyIterator() override { map->endIteration(); }
+    MapKeyIterator(const MapKeyIterator&) = delete;
+    MapKeyIterator& operator=(const MapKeyIterator&) = delete;
+    bool next(MegaladonValue& item) override {
+        const auto& entries = map->entries();
+        while (position < entries.size()) {
+            const auto& entry = entries[position++];
+            if (!entry.removed()) {
+                item = entry.key;
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    std::shared_ptr<MegaladonMap> map;
+    size_t position = 0;
+};
+
+class SetIterator : public MegaladonIterator {
+public:
+    explicit SetIterator(std::shared_ptr<MegaladonSet> set) : set(std::move(set)) { this->set->beginIteration(); }
+    ~SetIterator() override { set->endIteration(); }
+    SetIterator(const SetIterator&) = delete;
+    SetIterator& operator=(const SetIterator&) = delete;
+    bool next(MegaladonValue& item) override {
+        while (position < set->positionCount()) {
+            if (const MegaladonValue* element = set->elementAt(position++)) {
+                item = *element;
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    std::shared_ptr<MegaladonSet> set;
+    size_t position = 0;
+};
+
+// Looks up one leaf per 32 elements instead of walking the trie for each
+class VectorIterator : public MegaladonIterator {
+public:
+    explicit VectorIterator(std::shared_ptr<const PersistentVector> vector) : vector(std::move(vector)) {}
+    bool next(MegaladonValue& item) override {
+        if (index >= vector->size()) return false;
+        if ((index & PersistentVector::MASK) == 0) {
+            leaf = vector->leafFor(index);
+        }
+        item = leaf[index++ & PersistentVector::MASK];
+        return true;
+    }
+
+private:
+    std::shared_ptr<const PersistentVector> vector;
+    const MegaladonValue* leaf = nullptr;
+    size_t index = 0;
+};
+
+// Bytes share their buffer, which the iterator keeps alive; each byte is a number
+class BytesIterator : public MegaladonIterator {
+public:
+    explicit BytesIterator(MegaladonBytes bytes) : bytes(std::move(bytes)) {}
+    bool next(MegaladonValue& item) override {
+        if (index >= bytes.size()) return false;
+        item = MegaladonValue(static_cast<double>(bytes.data()[index++]));
+        return true;
+    }
+
+private:
+    MegaladonBytes bytes;
+    size_t index = 0;
+};
+
+// Iterates over the first axis: numbers for a 1-D tensor, row views otherwise
+class TensorIterator : public MegaladonIterator {
+public:
+    explicit TensorIterator(std::shared_ptr<Tensor> tensor) : tensor(std::move(tensor)) {}
+    bool next(MegaladonValue& item) override {
+        if (tensor->rank() == 0 || index >= tensor->shape()[0]) return false;
+        if (tensor->rank() == 1) {
+            item = MegaladonValue(tensor->data()[index++]);
+        } else {
+            item = MegaladonValue(tensor->row(index++));
+        }
+        return true;
+    }
+
+private:
+    std::shared_ptr<Tensor> tensor;
+    size_t index = 0;
+};
+
+std::string formatNumber(double number) {
+    std::string s;
+    appendNumber(s, number);
+    return s;
+}
+} // namespace
+
+// --- RangeIterable ---
+std::unique_ptr<MegaladonIterator> RangeIterable::iterate() const {
+    return std::make_unique<RangeIterator>(start, step, rangeLength(start, stop, step));
+}
+
+std::string RangeIterable::toString() const {
+    return "range(" + formatNumber(start) + ", " + formatNumber(stop) + ", " + formatNumber(step) + ")";
+}
+
+bool RangeIterable::knownLength(size_t& length) const {
+    length = rangeLength(start, stop, step);
+    return true;
+}
+
+bool RangeIterable::integerBounds(double& low, double& high) const {
+    size_t length = rangeLength(start, stop, step);
+    if (length == 0 || std::floor(start) != start || std::floor(step) != step) return false;
+    double last = start + static_cast<double>(length - 1) * step;
+    low = std::min(start, last);
+    high = std::max(start, last);
+    return true;
+}
+
+// --- CharsIterable / LinesIterable ---
+std::unique_ptr<MegaladonIterator> CharsIterable::iterate() const {
+    return std::make_unique<CharsIterator>(text);
+}
+
+std::unique_ptr<MegaladonIterator> LinesIterable::iterate() const {
+    return std::make_unique<LinesIterator>(text);
+}
+
+// --- ListViewIterable ---
+std::unique_ptr<MegaladonIterator> ListViewIterable::iterate() const {
+    return std::make_unique<ListIterator>(storage, start, stop);
+}
+
+std::string ListViewIterable::toString() const {
+    return "view(" + std::to_string(stop - start) + " items)";
+}
+
+std::unique_ptr<MegaladonIterator> iterateValue(const MegaladonValue& value) {
+    switch (value.type) {
+        case ITERABLE:
+            return value.asIterable()->iterate();
+        case LIST: {
+            const auto& storage = value.listStorage();
+            return std::make_unique<ListIterator>(storage, 0, storage->elements.size());
+        }
+        case STRING:
+            return std::make_unique<CharsIterator>(value.asString());
+        case ARRAY:
+            return std::make_unique<ArrayIterator>(value.asArray());
+        case MAP:
+            return std::make_unique<MapKeyIterator>(value.asMap());
+        case SET:
+            return std::make_unique<SetIterator>(value.asSet());
+        case VECTOR:
+            return std::make_unique<VectorIterator>(value.asVector());
+        case BYTES:
+            return std::make_unique<BytesIterator>(value.asBytes());
+        case TENSOR:
+            return std::make_unique<TensorIterator>(value.asTensor());
+        default:
+            return nullptr;
+    }
+}
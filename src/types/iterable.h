@@ -0,0 +1,91 @@
+#pragma once
+
+#include <string>
+#include <memory>  // For std::shared_ptr, std::unique_ptr
+#include <cstddef> // For size_t
+#include "value.h" // For MegaladonValue, ListStorage
+
+// --- Iteration Protocol ---
+// A MegaladonIterator hands out one item at a time; 'for (x in ...)' loops and
+// the builtins that consume sequences pull from it instead of first building
+// a list, so iterating over a range or a big string takes constant memory.
+class MegaladonIterator {
+public:
+    virtual ~MegaladonIterator() = default;
+    // Stores the next item in 'item' and returns true, or returns false when done
+    virtual bool next(MegaladonValue& item) = 0;
+};
+
+// Lazy sequence value (range, chars, lines, list views). Iterables are
+// immutable and can be iterated any number of times.
+class MegaladonIterable {
+public:
+    virtual ~MegaladonIterable() = default;
+    virtual std::unique_ptr<MegaladonIterator> iterate() const = 0;
+    virtual std::string toString() const = 0;
+    // Number of items if it is known without iterating
+    virtual bool knownLength(size_t& length) const { (void)length; return false; }
+};
+
+// range(start, stop, step): numbers from 'start' towards 'stop' (exclusive)
+class RangeIterable : public MegaladonIterable {
+public:
+    RangeIterable(double start, double stop, double step) : start(start), stop(stop), step(step) {}
+    std::unique_ptr<MegaladonIterator> iterate() const override;
+    std::string toString() const override;
+    bool knownLength(size_t& length) const override;
+    // Smallest and largest item, when the range is not empty and every item is
+    // an integer
+    bool integerBounds(double& low, double& high) const;
+
+private:
+    double start;
+    double stop;
+    double step; // Never zero
+};
+
+// chars(string): one-character strings
+class CharsIterable : public MegaladonIterable {
+public:
+    explicit CharsIterable(MegaladonString text) : text(std::move(text)) {}
+    std::unique_ptr<MegaladonIterator> iterate() const override;
+    std::string toString() const override { return "chars(...)"; }
+    bool knownLength(size_t& length) const override { length = text.size(); return true; }
+
+private:
+    MegaladonString text;
+};
+
+// lines(string): lines without their terminators, as slices of the string
+class LinesIterable : public MegaladonIterable {
+public:
+    explicit LinesIterable(MegaladonString text) : text(std::move(text)) {}
+    std::unique_ptr<MegaladonIterator> iterate() const override;
+    std::string toString() const override { return "lines(...)"; }
+
+private:
+    MegaladonString text;
+};
+
+// view(list, start, stop): elements [start, stop) of a list without copying them.
+// The view keeps the list's storage as it was; later changes to the list copy
+// it (copy-on-write), so the view never sees them.
+class ListViewIterable : public MegaladonIterable {
+public:
+    ListViewIterable(std::shared_ptr<ListStorage> storage, size_t start, size_t stop)
+        : storage(std::move(storage)), start(start), stop(stop) {}
+    std::unique_ptr<MegaladonIterator> iterate() const override;
+    std::string toString() const override;
+    bool knownLength(size_t& length) const override { length = stop - start; return true; }
+
+private:
+    std::shared_ptr<ListStorage> storage;
+    size_t start;
+    size_t stop;
+};
+
+// Iterator over any iterable value: lazy iterables, lists, strings (characters),
+// arrays, map keys, set elements, vectors, bytes and tensors (along the first axis).
+// Returns nullptr if 'value' is not iterable.
+std::unique_ptr<MegaladonIterator> iterateValue(const MegaladonValue& value);
+// --- End Iteration Protocol ---
@@ -0,0 +1,138 @@
+#include "map_value.h"
+#include "../util/error.h"
+#include <cmath> // For std::isnan
+
+void MegaladonMap::checkKey(const MegaladonValue& key) {
+    if (key.isNumber()) {
+        if (std::isnan(key.asNumber())) {
+            throw MegaladonError("Map keys cannot be NaN.");
+        }
+        return;
+    }
+    if (!key.isString() && !key.isBoolean()) {
+        throw MegaladonError("Map keys must be numbers, strings or booleans.");
+    }
+}
+
+uint32_t MegaladonMap::findEntry(const MegaladonValue& key, size_t hash) const {
+    return index.find(hash, [&](uint32_t entry) {
+        return entries_[entry].key == key;
+    });
+}
+
+const MegaladonValue* MegaladonMap::get(const MegaladonValue& key) const {
+    checkKey(key);
+    uint32_t entry = findEntry(key, hashValue(key));
+    return entry == HashIndex::NOT_FOUND ? nullptr : &entries_[entry].value;
+}
+
+void MegaladonMap::getMany(const MegaladonValue* keys, size_t count, const MegaladonValue** found) const {
+    // Key i has its group prefetched at step i, its likely entry prefetched at
+    // step i + LOOKUP_AHEAD and is looked up at step i + 2 * LOOKUP_AHEAD
+    constexpr size_t LOOKUP_AHEAD = 8;
+    constexpr size_t RING = 32; // Power of two above 2 * LOOKUP_AHEAD
+    size_t hashes[RING];
+    for (size_t step = 0; step < count + 2 * LOOKUP_AHEAD; ++step) {
+        if (step < count) {
+            checkKey(keys[step]);
+            hashes[step % RING] = hashValue(keys[step]);
+            index.prefetch(hashes[step % RING]);
+        }
+        if (step >= LOOKUP_AHEAD && step - LOOKUP_AHEAD < count) {
+            uint32_t candidate = index.firstCandidate(hashes[(step - LOOKUP_AHEAD) % RING]);
+            if (candidate != HashIndex::NOT_FOUND) {
+                __builtin_prefetch(&entries_[candidate].key);
+                __builtin_prefetch(&entries_[candidate].value);
+            }
+        }
+        if (step >= 2 * LOOKUP_AHEAD) {
+            size_t i = step - 2 * LOOKUP_AHEAD;
+            uint32_t entry = findEntry(keys[i], hashes[i % RING]);
+            found[i] = entry == HashIndex::NOT_FOUND ? nullptr : &entries_[entry].value;
+        }
+    }
+}
+
+MegaladonValue* MegaladonMap::get(const MegaladonValue& key) {
+    return const_cast<MegaladonValue*>(static_cast<const MegaladonMap&>(*this).get(key));
+}
+
+void MegaladonMap::set(const MegaladonValue& key, const MegaladonValue& value) {
+    checkKey(key);
+    size_t hash = hashValue(key);
+    uint32_t entry = findEntry(key, hash);
+    if (entry != HashIndex::NOT_FOUND) {
+        entries_[entry].value = value;
+        return;
+    }
+    entries_.push_back(Entry{key, value});
+    index.insert(hash, static_cast<uint32_t>(entries_.size() - 1),
+                 [this](uint32_t existing) { return entryHash(existing); });
+}
+
+void MegaladonMap::reserve(size_t count) {
+    entries_.reserve(count);
+    index.reserve(count, [this](uint32_t entry) { return entryHash(entry); });
+}
+
+bool MegaladonMap::remove(const MegaladonValue& key) {
+    checkKey(key);
+    size_t hash = hashValue(key);
+    uint32_t entry = findEntry(key, hash);
+    if (entry == HashIndex::NOT_FOUND) {
+        return false;
+    }
+    index.erase(hash, entry);
+    entries_[entry].key = MegaladonValue(INVALID);
+    entries_[entry].value = MegaladonValue(); // Release whatever the value referenced
+    removedCount++;
+    if (iterators == 0 && removedCount * 2 > entries_.size()) {
+        compact();
+    }
+    return true;
+}
+
+void MegaladonMap::endIteration() {
+    iterators--;
+    if (iterators == 0 && removedCount * 2 > entries_.size()) {
+        compact(); // Deferred by removals during the loop
+    }
+}
+
+// Drops removed entries and re-indexes the survivors at their new positions
+void MegaladonMap::compact() {
+    std::vector<Entry> live;
+    live.reserve(entries_.size() - removedCount);
+    for (auto& entry : entries_) {
+        if (!entry.removed()) live.push_back(std::move(entry));
+    }
+    entries_ = std::move(live);
+    removedCount = 0;
+    index.rebuild(static_cast<uint32_t>(entries_.size()), [this](uint32_t entry) { return entryHash(entry); });
+}
+
+std::vector<MegaladonValue> MegaladonMap::keys() const {
+    std::vector<MegaladonValue> result;
+    result.reserve(size());
+    for (const auto& entry : entries_) {
+        if (!entry.removed()) result.push_back(entry.key);
+    }
+    return result;
+}
+
+void MegaladonMap::traceReferences(const std::function<void(HeapObject*)>& visit) {
+    for (const auto& entry : entries_) {
+        traceValue(entry.value, visit); // Keys are scalars
+    }
+}
+
+void MegaladonMap::clearReferences() {
+    auto dropped = std::move(entries_);
+    entries_.clear();
+    index.clear();
+    removedCount = 0;
+}
+
+size_t MegaladonMap::approximateSize() const {
+    return sizeof(MegaladonMap) + entries_.capacity() * sizeof(Entry) + index.approximateSize();
+}
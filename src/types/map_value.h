@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vector>
+#include <cstdint> // For uint32_t
+#include "value.h" // For MegaladonValue
+#include "../memory/heap.h" // For HeapObject
+#include "../util/hash_index.h" // For HashIndex
+
+// --- MegaladonMap Definition ---
+// Dictionary value keyed by numbers, strings and booleans.
+// Entries live in a vector in insertion order (which is also iteration order);
+// a HashIndex maps key hashes to positions in that vector. Removing a key leaves
+// a hole that is skipped during iteration and squeezed out once holes make up
+// half of the vector (but not while an iterator walks the vector by position).
+//
+// Maps are reference values like arrays: copies of a MegaladonValue share one map.
+// They can hold closures that capture the map itself, so they take part in cycle
+// collection.
+class MegaladonMap : public HeapObject {
+public:
+    // One cache line for the key and the next for its value; the key is
+    // compared on lookup, so keeping entries this tight saves a cache miss
+    struct alignas(64) Entry {
+        MegaladonValue key; // INVALID once the entry has been removed
+        MegaladonValue value;
+
+        bool removed() const { return key.isInvalid(); }
+    };
+
+    size_t size() const { return index.size(); }
+
+    // nullptr when 'key' is not in the map
+    const MegaladonValue* get(const MegaladonValue& key) const;
+    MegaladonValue* get(const MegaladonValue& key); // For updating a value in place
+    // Looks up keys[0..count) at once; found[i] is keys[i]'s value or nullptr.
+    // Each key's index group, and then its entry, is prefetched a few keys ahead,
+    // so the cache misses of neighbouring lookups overlap instead of queueing.
+    void getMany(const MegaladonValue* keys, size_t count, const MegaladonValue** found) const;
+    void set(const MegaladonValue& key, const MegaladonValue& value);
+    bool has(const MegaladonValue& key) const { return get(key) != nullptr; }
+    bool remove(const MegaladonValue& key); // Returns false if 'key' was not present
+    void reserve(size_t count); // Room for 'count' entries without growing
+
+    // Live and removed entries in insertion order; skip entries where removed() is true
+    const std::vector<Entry>& entries() const { return entries_; }
+    std::vector<MegaladonValue> keys() const;
+
+    // Iterators hold positions in entries(), which must not move under them:
+    // removals leave holes until the last live iterator ends
+    void beginIteration() { iterators++; }
+    void endIteration();
+
+    // Throws unless 'key' can be used as a map key
+    static void checkKey(const MegaladonValue& key);
+
+    // HeapObject: closures (and other maps) stored as values
+    void traceReferences(const std::function<void(HeapObject*)>& visit) override;
+    void clearReferences() override;
+    size_t approximateSize() const override;
+
+private:
+    uint32_t findEntry(const MegaladonValue& key, size_t hash) const;
+    size_t entryHash(uint32_t entry) const { return hashValue(entries_[entry].key); } // Strings cache their hash
+    void compact();
+
+    std::vector<Entry> entries_;
+    HashIndex index;
+    size_t removedCount = 0;
+    size_t iterators = 0; // Live iterators; compaction waits for them
+};
+// --- End MegaladonMap Definition ---
@@ -0,0 +1,25 @@
+#include "numeric_array.h"
+
+std::shared_ptr<NumericArray> arrayArithmetic(ArithmeticOp op, const NumericArray& a, const NumericArray& b) {
+    auto result = std::make_shared<NumericArray>(a.size());
+    kernelArithmetic(op, a.data(), b.data(), result->data(), a.size());
+    return result;
+}
+
+std::shared_ptr<NumericArray> arrayArithmetic(ArithmeticOp op, const NumericArray& a, double scalar, bool scalarOnLeft) {
+    auto result = std::make_shared<NumericArray>(a.size());
+    kernelArithmeticScalar(op, a.data(), scalar, scalarOnLeft, result->data(), a.size());
+    return result;
+}
+
+std::shared_ptr<NumericArray> arrayCompare(CompareOp op, const NumericArray& a, const NumericArray& b) {
+    auto result = std::make_shared<NumericArray>(a.size());
+    kernelCompare(op, a.data(), b.data(), result->data(), a.size());
+    return result;
+}
+
+std::shared_ptr<NumericArray> arrayCompare(CompareOp op, const NumericArray& a, double scalar, bool scalarOnLeft) {
+    auto result = std::make_shared<NumericArray>(a.size());
+    kernelCompareScalar(op, a.data(), scalar, scalarOnLeft, result->data(), a.size());
+    return result;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <vector>
+#include <memory> // For std::shared_ptr
+#include "../util/numeric_kernels.h" // For ArithmeticOp, CompareOp
+
+// --- NumericArray Definition ---
+// Dense array of doubles stored contiguously, so element-wise arithmetic,
+// comparisons and reductions run as SIMD kernels instead of interpreted loops.
+// Arrays are reference values: copies of a MegaladonValue share one NumericArray,
+// and element assignment is visible through every copy.
+class NumericArray {
+public:
+    NumericArray() = default;
+    explicit NumericArray(size_t size, double fill = 0.0) : values(size, fill) {}
+    explicit NumericArray(std::vector<double> values) : values(std::move(values)) {}
+
+    size_t size() const { return values.size(); }
+    const double* data() const { return values.data(); }
+    double* data() { return values.data(); }
+
+    std::vector<double> values;
+};
+
+// Element-wise operations; callers check that array operands have equal length
+std::shared_ptr<NumericArray> arrayArithmetic(ArithmeticOp op, const NumericArray& a, const NumericArray& b);
+std::shared_ptr<NumericArray> arrayArithmetic(ArithmeticOp op, const NumericArray& a, double scalar, bool scalarOnLeft);
+std::shared_ptr<NumericArray> arrayCompare(CompareOp op, const NumericArray& a, const NumericArray& b);
+std::shared_ptr<NumericArray> arrayCompare(CompareOp op, const NumericArray& a, double scalar, bool scalarOnLeft);
+// --- End NumericArray Definition ---
@@ -0,0 +1,158 @@
+#include "persistent_vector.h"
+#include <algorithm> // For std::min, std::copy
+
+namespace {
+using Node = PersistentVector::Node;
+using Leaf = PersistentVector::Leaf;
+using Branch = PersistentVector::Branch;
+
+// A chain of fresh branches from 'level' down to 'leaf'
+std::shared_ptr<const Node> newPath(size_t level, std::shared_ptr<const Leaf> leaf) {
+    if (level == 0) return leaf;
+    auto branch = std::make_shared<Branch>();
+    branch->children[0] = newPath(level - PersistentVector::BITS, std::move(leaf));
+    return branch;
+}
+
+// Copy of 'parent' with 'leaf' stored as the trie's element block starting at 'index'
+std::shared_ptr<const Branch> pushLeaf(size_t level, const Branch& parent, size_t index, std::shared_ptr<const Leaf> leaf) {
+    auto copy = std::make_shared<Branch>(parent);
+    size_t slot = (index >> level) & PersistentVector::MASK;
+    if (level == PersistentVector::BITS) {
+        copy->children[slot] = std::move(leaf);
+    } else if (parent.children[slot]) {
+        const auto& child = static_cast<const Branch&>(*parent.children[slot]);
+        copy->children[slot] = pushLeaf(level - PersistentVector::BITS, child, index, std::move(leaf));
+    } else {
+        copy->children[slot] = newPath(level - PersistentVector::BITS, std::move(leaf));
+    }
+    return copy;
+}
+
+// Copy of the path from 'node' down to the element at 'index', with that element replaced
+std::shared_ptr<const Node> setPath(size_t level, const Node& node, size_t index, const MegaladonValue& value) {
+    if (level == 0) {
+        auto leaf = std::make_shared<Leaf>(static_cast<const Leaf&>(node));
+        leaf->values[index & PersistentVector::MASK] = value;
+        return leaf;
+    }
+    const auto& branch = static_cast<const Branch&>(node);
+    auto copy = std::make_shared<Branch>(branch);
+    size_t slot = (index >> level) & PersistentVector::MASK;
+    copy->children[slot] = setPath(level - PersistentVector::BITS, *branch.children[slot], index, value);
+    return copy;
+}
+} // namespace
+
+PersistentVector::PersistentVector()
+    : root_(std::make_shared<Branch>()), tail_(std::make_shared<Leaf>()) {}
+
+std::shared_ptr<const PersistentVector> PersistentVector::fromValues(const std::vector<MegaladonValue>& values) {
+    static const auto empty = std::make_shared<const PersistentVector>();
+    return empty->appendAll(values.data(), values.size());
+}
+
+const MegaladonValue* PersistentVector::leafFor(size_t index) const {
+    if (index >= trieSize()) {
+        return tail_->values;
+    }
+    const Node* node = root_.get();
+    for (size_t level = shift_; level > 0; level -= BITS) {
+        node = static_cast<const Branch*>(node)->children[(index >> level) & MASK].get();
+    }
+    return static_cast<const Leaf*>(node)->values;
+}
+
+const MegaladonValue& PersistentVector::get(size_t index) const {
+    return leafFor(index)[index & MASK];
+}
+
+// Moves a full tail leaf into the trie, adding a level when the root is full
+void PersistentVector::pushTail(std::shared_ptr<const Leaf> leaf) {
+    size_t index = trieSize();
+    if (index == (size_t(1) << (shift_ + BITS))) {
+        auto root = std::make_shared<Branch>();
+        root->children[0] = root_;
+        root->children[1] = newPath(shift_, std::move(leaf));
+        root_ = std::move(root);
+        shift_ += BITS;
+    } else {
+        root_ = pushLeaf(shift_, *root_, index, std::move(leaf));
+    }
+}
+
+std::shared_ptr<const PersistentVector> PersistentVector::appendAll(const MegaladonValue* values, size_t count) const {
+    auto result = std::make_shared<PersistentVector>(*this);
+    if (count == 0) return result;
+    // The tail is copied once per call and then filled in place, since nobody
+    // else can see it until we return; full tails go into the trie
+    auto tail = std::make_shared<Leaf>(*tail_);
+    size_t done = 0;
+    while (done < count) {
+        if (result->tailSize_ == WIDTH) {
+            result->pushTail(std::move(tail));
+            result->tailSize_ = 0;
+            tail = std::make_shared<Leaf>();
+        }
+        size_t chunk = std::min(count - done, WIDTH - result->tailSize_);
+        std::copy(values + done, values + done + chunk, tail->values + result->tailSize_);
+        result->tailSize_ += chunk;
+        result->size_ += chunk;
+        done += chunk;
+    }
+    result->tail_ = std::move(tail);
+    return result;
+}
+
+std::shared_ptr<const PersistentVector> PersistentVector::push(const MegaladonValue& value) const {
+    return appendAll(&value, 1);
+}
+
+std::shared_ptr<const PersistentVector> PersistentVector::set(size_t index, const MegaladonValue& value) const {
+    auto result = std::make_shared<PersistentVector>(*this);
+    if (index >= trieSize()) {
+        auto tail = std::make_shared<Leaf>(*tail_);
+        tail->values[index & MASK] = value;
+        result->tail_ = std::move(tail);
+    } else {
+        result->root_ = std::static_pointer_cast<const Branch>(setPath(shift_, *root_, index, value));
+    }
+    return result;
+}
+
+// Not a relaxed (RRB) concatenation: the left side is shared as is and the
+// right side's elements are appended one leaf at a time, so the cost is
+// O(size of the right side) and the left side is never copied
+std::shared_ptr<const PersistentVector> PersistentVector::concat(const PersistentVector& other) const {
+    std::shared_ptr<const PersistentVector> result = std::make_shared<PersistentVector>(*this);
+    for (size_t start = 0; start < other.size_; start += WIDTH) {
+        size_t chunk = std::min(WIDTH, other.size_ - start);
+        result = result->appendAll(other.leafFor(start), chunk);
+    }
+    return result;
+}
+
+std::vector<MegaladonValue> PersistentVector::toVector() const {
+    std::vector<MegaladonValue> result;
+    result.reserve(size_);
+    for (size_t start = 0; start < size_; start += WIDTH) {
+        const MegaladonValue* leaf = leafFor(start);
+        result.insert(result.end(), leaf, leaf + std::min(WIDTH, size_ - start));
+    }
+    return result;
+}
+
+bool operator==(const PersistentVector& lhs, const PersistentVector& rhs) {
+    if (&lhs == &rhs) return true;
+    if (lhs.size() != rhs.size()) return false;
+    // Leaves line up at multiples of WIDTH in both vectors, and versions of one
+    // vector share most of their leaves, which then need no comparing
+    for (size_t start = 0; start < lhs.size(); start += PersistentVector::WIDTH) {
+        const MegaladonValue* a = lhs.leafFor(start);
+        const MegaladonValue* b = rhs.leafFor(start);
+        if (a == b) continue;
+        size_t chunk = std::min(PersistentVector::WIDTH, lhs.size() - start);
+        if (!std::equal(a, a + chunk, b)) return false;
+    }
+    return true;
+}
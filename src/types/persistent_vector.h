@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vector>
+#include <memory>  // For std::shared_ptr
+#include <cstddef> // For size_t
+#include "value.h" // For MegaladonValue
+
+// --- PersistentVector Definition ---
+// Immutable vector stored as a 32-way trie of leaves plus a separate tail leaf,
+// in the style of Clojure's vectors. Every "modification" returns a new vector
+// that shares all untouched nodes with the old one:
+//   - push appends to the tail, and moves a full tail into the trie: O(1) amortized
+//   - set copies one leaf and the branches above it: O(log32 n)
+//   - get walks at most log32 n branches (a trie of 1M elements is 4 levels deep)
+// Keeping many versions therefore costs memory proportional to what changed.
+class PersistentVector {
+public:
+    static constexpr size_t BITS = 5;
+    static constexpr size_t WIDTH = size_t(1) << BITS; // 32
+    static constexpr size_t MASK = WIDTH - 1;
+
+    struct Node {};
+    struct Leaf : Node {
+        MegaladonValue values[WIDTH];
+    };
+    struct Branch : Node {
+        std::shared_ptr<const Node> children[WIDTH];
+    };
+
+    PersistentVector();
+
+    static std::shared_ptr<const PersistentVector> fromValues(const std::vector<MegaladonValue>& values);
+
+    size_t size() const { return size_; }
+    // 'index' must be < size()
+    const MegaladonValue& get(size_t index) const;
+
+    std::shared_ptr<const PersistentVector> push(const MegaladonValue& value) const;
+    std::shared_ptr<const PersistentVector> set(size_t index, const MegaladonValue& value) const;
+    // Shares all of this vector and appends the other one's elements leaf by leaf
+    std::shared_ptr<const PersistentVector> concat(const PersistentVector& other) const;
+
+    // The 32-element leaf holding 'index' (for walking a vector leaf by leaf);
+    // the element itself is at [index & MASK]
+    const MegaladonValue* leafFor(size_t index) const;
+
+    std::vector<MegaladonValue> toVector() const;
+
+private:
+    size_t trieSize() const { return size_ - tailSize_; }
+
+    // Appends 'count' values, filling the tail and moving full tails into the trie
+    std::shared_ptr<const PersistentVector> appendAll(const MegaladonValue* values, size_t count) const;
+    void pushTail(std::shared_ptr<const Leaf> leaf);
+
+    std::shared_ptr<const Branch> root_; // Never null; leaves sit 'shift_ / BITS' levels below it
+    std::shared_ptr<const Leaf> tail_;   // Last (size_ - trieSize()) elements
+    size_t size_ = 0;
+    size_t tailSize_ = 0;
+    size_t shift_ = BITS;
+};
+
+bool operator==(const PersistentVector& lhs, const PersistentVector& rhs);
+// --- End PersistentVector Definition ---
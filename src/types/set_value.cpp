@@ -0,0 +1,156 @@
+#include "set_value.h"
+#include "../util/error.h"
+#include <algorithm> // For std::min
+#include <cmath>     // For std::isnan
+
+MegaladonSet::MegaladonSet(const std::vector<MegaladonValue>& values) {
+    reserve(values.size());
+    for (const auto& value : values) {
+        add(value);
+    }
+}
+
+void MegaladonSet::checkElement(const MegaladonValue& value) {
+    switch (value.type) {
+        case NUMBER:
+            if (std::isnan(value.asNumber())) {
+                throw MegaladonError("Sets cannot hold NaN.");
+            }
+            return;
+        case STRING:
+        case BOOLEAN:
+            return;
+        case LIST:
+            for (const auto& element : value.asList()) {
+                checkElement(element);
+            }
+            return;
+        default:
+            throw MegaladonError("Sets can only hold numbers, strings, booleans and lists of those.");
+    }
+}
+
+uint32_t MegaladonSet::findElement(const MegaladonValue& value, size_t hash) const {
+    return index.find(hash, [&](uint32_t element) {
+        return hashes[element] == hash && elements[element] == value;
+    });
+}
+
+void MegaladonSet::insertNew(const MegaladonValue& value, size_t hash) {
+    elements.push_back(value);
+    hashes.push_back(hash);
+    index.insert(hash, static_cast<uint32_t>(elements.size() - 1), [this](uint32_t element) { return hashes[element]; });
+}
+
+void MegaladonSet::reserve(size_t count) {
+    elements.reserve(count);
+    hashes.reserve(count);
+    index.reserve(count, [this](uint32_t element) { return hashes[element]; });
+}
+
+bool MegaladonSet::has(const MegaladonValue& value) const {
+    checkElement(value);
+    return findElement(value, hashValue(value)) != HashIndex::NOT_FOUND;
+}
+
+bool MegaladonSet::add(const MegaladonValue& value) {
+    checkElement(value);
+    size_t hash = hashValue(value);
+    if (findElement(value, hash) != HashIndex::NOT_FOUND) {
+        return false;
+    }
+    insertNew(value, hash);
+    return true;
+}
+
+bool MegaladonSet::remove(const MegaladonValue& value) {
+    checkElement(value);
+    size_t hash = hashValue(value);
+    uint32_t element = findElement(value, hash);
+    if (element == HashIndex::NOT_FOUND) {
+        return false;
+    }
+    index.erase(hash, element);
+    elements[element] = MegaladonValue(INVALID);
+    removedCount++;
+    if (iterators == 0 && removedCount * 2 > elements.size()) {
+        compact();
+    }
+    return true;
+}
+
+void MegaladonSet::endIteration() {
+    iterators--;
+    if (iterators == 0 && removedCount * 2 > elements.size()) {
+        compact(); // Deferred by removals during the loop
+    }
+}
+
+// Drops removed elements and re-indexes the survivors at their new positions
+void MegaladonSet::compact() {
+    size_t kept = 0;
+    for (size_t i = 0; i < elements.size(); ++i) {
+        if (elements[i].isInvalid()) continue;
+        if (kept != i) {
+            elements[kept] = std::move(elements[i]);
+            hashes[kept] = hashes[i];
+        }
+        kept++;
+    }
+    elements.resize(kept);
+    hashes.resize(kept);
+    removedCount = 0;
+    index.rebuild(static_cast<uint32_t>(kept), [this](uint32_t element) { return hashes[element]; });
+}
+
+std::vector<MegaladonValue> MegaladonSet::values() const {
+    std::vector<MegaladonValue> result;
+    result.reserve(size());
+    forEach([&result](const MegaladonValue& element) { result.push_back(element); });
+    return result;
+}
+
+// --- Set algebra ---
+// Elements of both operands are already validated and hashed, so these reuse
+// the stored hashes instead of going through add().
+
+namespace {
+// Calls visit(element, hash) for every live element
+template <typename Visit>
+void forEachHashed(const std::vector<MegaladonValue>& elements, const std::vector<size_t>& hashes, Visit&& visit) {
+    for (size_t i = 0; i < elements.size(); ++i) {
+        if (!elements[i].isInvalid()) visit(elements[i], hashes[i]);
+    }
+}
+} // namespace
+
+std::shared_ptr<MegaladonSet> setUnion(const MegaladonSet& a, const MegaladonSet& b) {
+    auto result = std::make_shared<MegaladonSet>();
+    result->reserve(a.size() + b.size());
+    forEachHashed(a.elements, a.hashes, [&result](const MegaladonValue& element, size_t hash) {
+        result->insertNew(element, hash);
+    });
+    forEachHashed(b.elements, b.hashes, [&](const MegaladonValue& element, size_t hash) {
+        if (a.findElement(element, hash) == HashIndex::NOT_FOUND) result->insertNew(element, hash);
+    });
+    return result;
+}
+
+// Keeps the order of 'a'
+std::shared_ptr<MegaladonSet> setIntersection(const MegaladonSet& a, const MegaladonSet& b) {
+    auto result = std::make_shared<MegaladonSet>();
+    result->reserve(std::min(a.size(), b.size()));
+    forEachHashed(a.elements, a.hashes, [&](const MegaladonValue& element, size_t hash) {
+        if (b.findElement(element, hash) != HashIndex::NOT_FOUND) result->insertNew(element, hash);
+    });
+    return result;
+}
+
+std::shared_ptr<MegaladonSet> setDifference(const MegaladonSet& a, const MegaladonSet& b) {
+    auto result = std::make_shared<MegaladonSet>();
+    result->reserve(a.size());
+    forEachHashed(a.elements, a.hashes, [&](const MegaladonValue& element, size_t hash) {
+        if (b.findElement(element, hash) == HashIndex::NOT_FOUND) result->insertNew(element, hash);
+    });
+    return result;
+}
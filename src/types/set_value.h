@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vector>
+#include <memory>  // For std::shared_ptr
+#include <cstdint> // For uint32_t
+#include "value.h" // For MegaladonValue
+#include "../util/hash_index.h" // For HashIndex
+
+// --- MegaladonSet Definition ---
+// Hash set of numbers, strings, booleans and (nested) lists of those.
+// Same layout as MegaladonMap: elements in insertion order plus a HashIndex
+// over their positions. Element hashes are kept alongside, since hashing a
+// nested list again on every rehash would be expensive.
+//
+// Sets are reference values like maps. Their elements can never hold
+// closures, so unlike maps they are not heap objects.
+class MegaladonSet {
+public:
+    MegaladonSet() = default;
+    explicit MegaladonSet(const std::vector<MegaladonValue>& values); // Drops duplicates, O(n)
+
+    size_t size() const { return index.size(); }
+
+    bool has(const MegaladonValue& value) const;
+    bool add(const MegaladonValue& value);    // Returns false if 'value' was already present
+    bool remove(const MegaladonValue& value); // Returns false if 'value' was not present
+    void reserve(size_t count);
+
+    // Live elements in insertion order
+    std::vector<MegaladonValue> values() const;
+    template <typename Visit>
+    void forEach(Visit&& visit) const {
+        for (const auto& element : elements) {
+            if (!element.isInvalid()) visit(element);
+        }
+    }
+
+    // Position-based access for iterators: positions in [0, positionCount()),
+    // where elementAt() is nullptr for removed elements. Positions stay put
+    // between beginIteration() and the matching endIteration().
+    size_t positionCount() const { return elements.size(); }
+    const MegaladonValue* elementAt(size_t position) const {
+        return elements[position].isInvalid() ? nullptr : &elements[position];
+    }
+    void beginIteration() { iterators++; }
+    void endIteration();
+
+    // Throws unless 'value' can be stored in a set
+    static void checkElement(const MegaladonValue& value);
+
+private:
+    friend std::shared_ptr<MegaladonSet> setUnion(const MegaladonSet& a, const MegaladonSet& b);
+    friend std::shared_ptr<MegaladonSet> setIntersection(const MegaladonSet& a, const MegaladonSet& b);
+    friend std::shared_ptr<MegaladonSet> setDifference(const MegaladonSet& a, const MegaladonSet& b);
+
+    uint32_t findElement(const MegaladonValue& value, size_t hash) const;
+    void insertNew(const MegaladonValue& value, size_t hash);
+    void compact();
+
+    std::vector<MegaladonValue> elements; // INVALID marks a removed element
+    std::vector<size_t> hashes;           // hashes[i] belongs to elements[i]
+    HashIndex index;
+    size_t removedCount = 0;
+    size_t iterators = 0; // Live iterators; compaction waits for them
+};
+
+// Bulk set algebra; each runs in time linear in the sizes of its operands
+std::shared_ptr<MegaladonSet> setUnion(const MegaladonSet& a, const MegaladonSet& b);
+std::shared_ptr<MegaladonSet> setIntersection(const MegaladonSet& a, const MegaladonSet& b);
+std::shared_ptr<MegaladonSet> setDifference(const MegaladonSet& a, const MegaladonSet& b);
+// --- End MegaladonSet Definition ---
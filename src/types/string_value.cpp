@@ -0,0 +1,305 @@
+#include "string_value.h"
+#include <algorithm>  // For std::max
+#include <cstring>    // For std::memcpy
+#include <deque>
+#include <functional> // For std::hash
+#include <mutex>      // For std::mutex, std::lock_guard
+#include <new>        // For placement new
+#include <vector>
+
+// Piece list shared by every version of a rope. A rope string of N bytes is the
+// concatenation of the pieces that add up to N bytes. Appending to the newest
+// version pushes one more piece; flattening copies pieces into 'flat', which only
+// ever grows, so every shorter version can read its bytes from the same buffer.
+// Pieces are released as soon as they are copied.
+//
+// data() hands out raw pointers into 'flat', so a string that has read from a flat
+// buffer is counted as its reader and remembers the pointer. When the buffer is
+// outgrown it is kept only while it still has readers, and each reader keeps
+// reading the buffer it started with.
+struct MegaladonString::RopeBuffer {
+    struct Retired {
+        size_t readers;
+        std::shared_ptr<char> bytes;
+    };
+
+    std::mutex lock;
+    std::deque<MegaladonString> pending; // Pieces not yet in 'flat', in order; never ropes themselves
+    std::shared_ptr<char> flat;          // Bytes of the pieces copied so far
+    size_t flatCapacity = 0;
+    size_t flatBytes = 0;
+    size_t totalBytes = 0;        // Length of the newest version: flatBytes plus the pending pieces
+    size_t readers = 0;           // Strings whose data() points into 'flat'
+    std::vector<Retired> retired; // Outgrown flat buffers that still have readers
+
+    void append(MegaladonString piece) {
+        totalBytes += piece.size();
+        pending.push_back(std::move(piece));
+    }
+
+    // Makes the first 'length' bytes (a version's length) contiguous. Caller holds 'lock'.
+    void flattenPrefix(size_t length) {
+        if (length <= flatBytes) return;
+
+        if (length > flatCapacity) {
+            size_t capacity = std::max(length, flatCapacity * 2);
+            std::shared_ptr<char> grown(new char[capacity], std::default_delete<char[]>());
+            if (flatBytes > 0) std::memcpy(grown.get(), flat.get(), flatBytes);
+            if (readers > 0) retired.push_back(Retired{readers, std::move(flat)});
+            flat = std::move(grown);
+            flatCapacity = capacity;
+            readers = 0;
+        }
+        while (flatBytes < length) {
+            const MegaladonString& piece = pending.front();
+            std::memcpy(flat.get() + flatBytes, piece.data(), piece.size());
+            flatBytes += piece.size();
+            pending.pop_front();
+        }
+    }
+
+    // Registers a string that has not read yet as a reader of 'flat'. Caller holds 'lock'.
+    const char* read() {
+        ++readers;
+        return flat.get();
+    }
+
+    // Called when a string reading 'bytes' goes away. Caller holds 'lock'.
+    void release(const char* bytes) {
+        if (bytes == flat.get()) {
+            --readers;
+            return;
+        }
+        for (size_t i = 0; i < retired.size(); ++i) {
+            if (retired[i].bytes.get() == bytes) {
+                if (--retired[i].readers == 0) retired.erase(retired.begin() + static_cast<std::ptrdiff_t>(i));
+                return;
+            }
+        }
+    }
+};
+
+namespace {
+// Allocates a refcounted buffer holding a copy of 'text'
+std::shared_ptr<const char> allocateBuffer(std::string_view text) {
+    std::shared_ptr<char> buffer(new char[text.size()], std::default_delete<char[]>());
+    std::memcpy(buffer.get(), text.data(), text.size());
+    return buffer;
+}
+} // namespace
+
+MegaladonString::MegaladonString(std::string_view text) : length_(text.size()), hash_(0) {
+    if (length_ <= INLINE_CAPACITY) {
+        rep_ = Rep::Inline;
+        std::memcpy(inline_, text.data(), text.size());
+    } else {
+        rep_ = Rep::Heap;
+        new (&heap_) std::shared_ptr<const char>(allocateBuffer(text));
+    }
+}
+
+MegaladonString::MegaladonString(std::string&& text) : length_(text.size()), hash_(0) {
+    if (length_ <= INLINE_CAPACITY) {
+        rep_ = Rep::Inline;
+        std::memcpy(inline_, text.data(), text.size());
+    } else {
+        // Keep the std::string alive and alias its bytes
+        rep_ = Rep::Heap;
+        auto owner = std::make_shared<std::string>(std::move(text));
+        new (&heap_) std::shared_ptr<const char>(owner, owner->data());
+    }
+}
+
+MegaladonString MegaladonString::fromBuffer(std::shared_ptr<const char> data, size_t length) {
+    if (length <= INLINE_CAPACITY) {
+        return MegaladonString(std::string_view(data.get(), length));
+    }
+    MegaladonString result;
+    result.length_ = length;
+    result.rep_ = Rep::Heap;
+    new (&result.heap_) std::shared_ptr<const char>(std::move(data));
+    return result;
+}
+
+MegaladonString MegaladonString::fromRope(std::shared_ptr<RopeBuffer> buffer, size_t length) {
+    MegaladonString result;
+    result.length_ = length;
+    result.rep_ = Rep::Rope;
+    new (&result.rope_) RopeRef(std::move(buffer));
+    return result;
+}
+
+MegaladonString::MegaladonString(const MegaladonString& other) {
+    copyFrom(other);
+}
+
+MegaladonString::MegaladonString(MegaladonString&& other) noexcept {
+    moveFrom(other);
+}
+
+MegaladonString& MegaladonString::operator=(const MegaladonString& other) {
+    if (this != &other) {
+        destroy();
+        copyFrom(other);
+    }
+    return *this;
+}
+
+MegaladonString& MegaladonString::operator=(MegaladonString&& other) noexcept {
+    if (this != &other) {
+        destroy();
+        moveFrom(other);
+    }
+    return *this;
+}
+
+MegaladonString::~MegaladonString() {
+    destroy();
+}
+
+void MegaladonString::destroy() {
+    if (rep_ == Rep::Heap) {
+        heap_.~shared_ptr();
+    } else if (rep_ == Rep::Rope) {
+        const char* flat = rope_.flat.load(std::memory_order_relaxed);
+        if (flat && rope_.buffer) {
+            std::lock_guard<std::mutex> guard(rope_.buffer->lock);
+            rope_.buffer->release(flat);
+        }
+        rope_.~RopeRef();
+    }
+    rep_ = Rep::Inline;
+    length_ = 0;
+}
+
+void MegaladonString::copyFrom(const MegaladonString& other) {
+    length_ = other.length_;
+    hash_ = other.hash_;
+    rep_ = other.rep_;
+    switch (rep_) {
+        case Rep::Inline: std::memcpy(inline_, other.inline_, length_); break;
+        case Rep::Heap: new (&heap_) std::shared_ptr<const char>(other.heap_); break;
+        case Rep::Rope: new (&rope_) RopeRef(other.rope_); break;
+    }
+}
+
+void MegaladonString::moveFrom(MegaladonString& other) {
+    length_ = other.length_;
+    hash_ = other.hash_;
+    rep_ = other.rep_;
+    switch (rep_) {
+        case Rep::Inline:
+            std::memcpy(inline_, other.inline_, length_);
+            return;
+        case Rep::Heap:
+            new (&heap_) std::shared_ptr<const char>(std::move(other.heap_));
+            break;
+        case Rep::Rope:
+            new (&rope_) RopeRef(std::move(other.rope_));
+            break;
+    }
+    other.destroy(); // Leave 'other' as a valid empty string
+    other.hash_ = 0;
+}
+
+// The first read of a rope: data() only calls this while 'flat' is not set yet
+const char* MegaladonString::flatten() const {
+    RopeBuffer& buffer = *rope_.buffer;
+    std::lock_guard<std::mutex> guard(buffer.lock);
+    const char* flat = rope_.flat.load(std::memory_order_relaxed);
+    if (flat) return flat; // Another thread read this string first
+    buffer.flattenPrefix(length_);
+    flat = buffer.read();
+    rope_.flat.store(flat, std::memory_order_release);
+    return flat;
+}
+
+std::shared_ptr<const char> MegaladonString::sharedData() const {
+    if (rep_ == Rep::Heap) return heap_;
+
+    RopeBuffer& buffer = *rope_.buffer;
+    std::lock_guard<std::mutex> guard(buffer.lock);
+    buffer.flattenPrefix(length_);
+    return buffer.flat;
+}
+
+size_t MegaladonString::hash() const {
+    if (hash_ == 0) {
+        size_t h = std::hash<std::string_view>{}(view());
+        hash_ = (h == 0) ? 1 : h; // Reserve 0 for "not computed"
+    }
+    return hash_;
+}
+
+MegaladonString MegaladonString::substr(size_t pos, size_t count) const {
+    if (pos >= length_) return MegaladonString();
+    if (count > length_ - pos) count = length_ - pos;
+    if (count == length_) return *this;
+
+    if (rep_ == Rep::Inline || count <= INLINE_CAPACITY) {
+        return MegaladonString(std::string_view(data() + pos, count));
+    }
+    // Share the parent buffer: the aliasing pointer keeps the whole allocation alive
+    std::shared_ptr<const char> base = sharedData();
+    return fromBuffer(std::shared_ptr<const char>(base, base.get() + pos), count);
+}
+
+MegaladonString MegaladonString::concat(const MegaladonString& lhs, const MegaladonString& rhs) {
+    if (lhs.empty()) return rhs;
+    if (rhs.empty()) return lhs;
+
+    size_t total = lhs.size() + rhs.size();
+    if (total < MIN_ROPE_LENGTH) {
+        std::string joined;
+        joined.reserve(total);
+        joined.append(lhs.data(), lhs.size());
+        joined.append(rhs.data(), rhs.size());
+        return MegaladonString(std::move(joined));
+    }
+
+    // Pieces are always flat, so a rope on the right is flattened first
+    MegaladonString piece = (rhs.rep_ == Rep::Rope) ? fromBuffer(rhs.sharedData(), rhs.size()) : rhs;
+
+    if (lhs.rep_ == Rep::Rope) {
+        RopeBuffer& buffer = *lhs.rope_.buffer;
+        std::lock_guard<std::mutex> guard(buffer.lock);
+        if (lhs.size() == buffer.totalBytes) {
+            // 'lhs' is the newest version of its rope: append in place
+            buffer.append(std::move(piece));
+            return fromRope(lhs.rope_.buffer, total);
+        }
+    }
+
+    // Start a new piece list. An older rope version on the left becomes a single flat piece.
+    auto buffer = std::make_shared<RopeBuffer>();
+    buffer->append((lhs.rep_ == Rep::Rope) ? fromBuffer(lhs.sharedData(), lhs.size()) : lhs);
+    buffer->append(std::move(piece));
+    return fromRope(std::move(buffer), total);
+}
+
+// True when both strings are views of the same bytes (copies of one value)
+bool MegaladonString::sharesBytesWith(const MegaladonString& other) const {
+    if (rep_ != other.rep_ || length_ != other.length_) return false;
+    if (rep_ == Rep::Heap) return heap_.get() == other.heap_.get();
+    if (rep_ == Rep::Rope) return rope_.buffer == other.rope_.buffer; // Same length, so the same version
+    return false; // Inline strings are short enough to just compare
+}
+
+bool operator==(const MegaladonString& lhs, const MegaladonString& rhs) {
+    if (lhs.size() != rhs.size()) return false;
+    if (lhs.sharesBytesWith(rhs)) return true;
+    if (lhs.hash_ != 0 && rhs.hash_ != 0 && lhs.hash_ != rhs.hash_) return false; // Both already hashed
+    return lhs.view() == rhs.view();
+}
+
+bool operator!=(const MegaladonString& lhs, const MegaladonString& rhs) {
+    return !(lhs == rhs);
+}
+
+bool operator<(const MegaladonString& lhs, const MegaladonString& rhs) {
+    return lhs.view() < rhs.view();
+}
+
+std::ostream& operator<<(std::ostream& out, const MegaladonString& str) {
+    return out.write(str.data(), static_cast<std::streamsize>(str.size()));
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <atomic>  // For std::atomic
+#include <memory>  // For std::shared_ptr
+#include <cstddef> // For size_t
+#include <ostream> // For operator<<
+
+// --- MegaladonString Definition ---
+// Immutable string storage used by MegaladonValue.
+// Short strings (up to INLINE_CAPACITY bytes) are stored inline in the value itself.
+// Longer strings point into a refcounted buffer, so copying a string value is a
+// refcount bump and substrings can share the parent's bytes instead of copying them.
+//
+// Concatenations that produce long strings are deferred: the result is a rope that
+// records its pieces and only copies them into one contiguous buffer when the bytes
+// are actually needed (data(), view(), hash(), ...). Appending to the newest version
+// of a rope reuses its piece list, so 's = s + piece' loops stay linear.
+class MegaladonString {
+public:
+    struct RopeBuffer; // Shared piece list behind rope strings (string_value.cpp)
+
+private:
+    // A rope string is the first size() bytes of its buffer's pieces. Pieces are
+    // never empty, so the length alone tells the versions of one rope apart.
+    struct RopeRef {
+        std::shared_ptr<RopeBuffer> buffer;
+        // The flat buffer this string reads, once it has read (see RopeBuffer). It
+        // stays alive and unchanged up to size() while the string is its reader,
+        // so data() returns it without taking the buffer's lock.
+        mutable std::atomic<const char*> flat{nullptr};
+
+        explicit RopeRef(std::shared_ptr<RopeBuffer> buffer) : buffer(std::move(buffer)) {}
+        RopeRef(const RopeRef& other) : buffer(other.buffer) {} // A copy registers as a reader of its own
+        RopeRef(RopeRef&& other) noexcept : buffer(std::move(other.buffer)), flat(other.flat.exchange(nullptr)) {}
+    };
+
+public:
+    static constexpr size_t INLINE_CAPACITY = sizeof(RopeRef);
+    static constexpr size_t MIN_ROPE_LENGTH = 256; // Shorter concatenations are copied eagerly
+
+    MegaladonString() : length_(0), hash_(0), rep_(Rep::Inline) {}
+    MegaladonString(const char* text) : MegaladonString(std::string_view(text)) {}
+    MegaladonString(std::string_view text);
+    MegaladonString(std::string&& text); // Adopts the string's buffer without copying
+    MegaladonString(const std::string& text) : MegaladonString(std::string_view(text)) {}
+
+    // Wraps an existing refcounted buffer (e.g. a slice of a larger allocation).
+    // 'data' must stay valid for as long as the shared_ptr keeps its owner alive.
+    static MegaladonString fromBuffer(std::shared_ptr<const char> data, size_t length);
+
+    MegaladonString(const MegaladonString& other);
+    MegaladonString(MegaladonString&& other) noexcept;
+    MegaladonString& operator=(const MegaladonString& other);
+    MegaladonString& operator=(MegaladonString&& other) noexcept;
+    ~MegaladonString();
+
+    // The length is always known without flattening a rope
+    size_t size() const { return length_; }
+    size_t length() const { return length_; }
+    bool empty() const { return length_ == 0; }
+
+    const char* data() const {
+        if (rep_ == Rep::Inline) return inline_;
+        if (rep_ == Rep::Heap) return heap_.get();
+        const char* flat = rope_.flat.load(std::memory_order_acquire);
+        return flat ? flat : flatten();
+    }
+    std::string_view view() const { return std::string_view(data(), length_); }
+    std::string str() const { return std::string(data(), length_); }
+    operator std::string_view() const { return view(); }
+
+    char operator[](size_t index) const { return data()[index]; }
+
+    // Hash of the contents, computed on first use and cached in the value
+    size_t hash() const;
+
+    // O(1) slice sharing this string's buffer (short slices are copied inline instead)
+    MegaladonString substr(size_t pos, size_t count = std::string_view::npos) const;
+
+    // Returns 'lhs' followed by 'rhs'; long results are built as ropes (amortized O(1))
+    static MegaladonString concat(const MegaladonString& lhs, const MegaladonString& rhs);
+
+private:
+    enum class Rep : unsigned char { Inline, Heap, Rope };
+
+    static MegaladonString fromRope(std::shared_ptr<RopeBuffer> buffer, size_t length);
+    const char* flatten() const;
+    std::shared_ptr<const char> sharedData() const; // Flattens ropes; not valid for inline strings
+    void destroy();
+    void copyFrom(const MegaladonString& other);
+    void moveFrom(MegaladonString& other);
+    bool sharesBytesWith(const MegaladonString& other) const;
+
+    friend bool operator==(const MegaladonString& lhs, const MegaladonString& rhs);
+
+    union {
+        char inline_[INLINE_CAPACITY];
+        std::shared_ptr<const char> heap_; // Points at the first byte of this string
+        RopeRef rope_;
+    };
+    size_t length_;
+    mutable size_t hash_; // 0 means "not computed yet"
+    Rep rep_;
+};
+
+bool operator==(const MegaladonString& lhs, const MegaladonString& rhs);
+bool operator!=(const MegaladonString& lhs, const MegaladonString& rhs);
+bool operator<(const MegaladonString& lhs, const MegaladonString& rhs);
+std::ostream& operator<<(std::ostream& out, const MegaladonString& str);
+// --- End MegaladonString Definition ---
@@ -0,0 +1,322 @@
+#include "tensor_value.h"
+#include "../util/error.h"
+#include "../util/number_format.h"
+#include "../util/thread_pool.h"
+#include <algorithm> // For std::fill, std::copy, std::equal, std::find, std::max
+#include <limits>
+#include <new>       // For std::align_val_t
+
+namespace {
+// Rows start on cache-line boundaries when the row size allows it, which keeps
+// the SIMD kernels' loads from splitting lines
+std::shared_ptr<double> allocateElements(size_t count, double fill) {
+    size_t bytes = std::max<size_t>(count, 1) * sizeof(double);
+    double* data = static_cast<double*>(::operator new[](bytes, std::align_val_t(64)));
+    std::fill(data, data + count, fill);
+    return std::shared_ptr<double>(data, [](double* elements) { ::operator delete[](elements, std::align_val_t(64)); });
+}
+
+// Result shape of a broadcast, and the element strides into each operand
+// (0 along axes where that operand is stretched)
+struct BroadcastPlan {
+    std::vector<size_t> shape;
+    std::vector<size_t> aStrides;
+    std::vector<size_t> bStrides;
+};
+
+BroadcastPlan planBroadcast(const Tensor& a, const Tensor& b) {
+    size_t rank = std::max(a.rank(), b.rank());
+    BroadcastPlan plan{std::vector<size_t>(rank), std::vector<size_t>(rank, 0), std::vector<size_t>(rank, 0)};
+    size_t aStride = 1;
+    size_t bStride = 1;
+    for (size_t fromEnd = 0; fromEnd < rank; ++fromEnd) {
+        size_t axis = rank - 1 - fromEnd;
+        size_t aDim = fromEnd < a.rank() ? a.shape()[a.rank() - 1 - fromEnd] : 1;
+        size_t bDim = fromEnd < b.rank() ? b.shape()[b.rank() - 1 - fromEnd] : 1;
+        if (aDim != bDim && aDim != 1 && bDim != 1) {
+            throw MegaladonError("Tensor shapes " + Tensor::shapeString(a.shape()) + " and " +
+                                 Tensor::shapeString(b.shape()) + " cannot be broadcast together.");
+        }
+        plan.shape[axis] = aDim == 1 ? bDim : aDim;
+        plan.aStrides[axis] = aDim == 1 ? 0 : aStride;
+        plan.bStrides[axis] = bDim == 1 ? 0 : bStride;
+        aStride *= aDim;
+        bStride *= bDim;
+    }
+    return plan;
+}
+
+// Runs 'run(x, xSteps, y, ySteps, out, length)' over each stretch of the result
+// along its last axis; an operand that does not step there is a single value.
+// Equal shapes are one call over the whole buffer.
+template <typename Run>
+std::shared_ptr<Tensor> broadcastApply(const Tensor& a, const Tensor& b, Run run) {
+    if (a.shape() == b.shape()) {
+        auto out = std::make_shared<Tensor>(a.shape());
+        run(a.data(), true, b.data(), true, out->data(), a.size());
+        return out;
+    }
+    BroadcastPlan plan = planBroadcast(a, b);
+    auto out = std::make_shared<Tensor>(plan.shape);
+    if (out->size() == 0) return out;
+
+    size_t rank = plan.shape.size();
+    size_t length = plan.shape.back();
+    bool aSteps = plan.aStrides.back() != 0;
+    bool bSteps = plan.bStrides.back() != 0;
+    std::vector<size_t> counter(rank, 0);
+    size_t aOffset = 0;
+    size_t bOffset = 0;
+    for (size_t outOffset = 0; outOffset < out->size(); outOffset += length) {
+        run(a.data() + aOffset, aSteps, b.data() + bOffset, bSteps, out->data() + outOffset, length);
+        // Advance the index over the axes before the last one, like an odometer
+        for (size_t axis = rank - 1; axis-- > 0;) {
+            aOffset += plan.aStrides[axis];
+            bOffset += plan.bStrides[axis];
+            if (++counter[axis] < plan.shape[axis]) break;
+            aOffset -= plan.aStrides[axis] * plan.shape[axis];
+            bOffset -= plan.bStrides[axis] * plan.shape[axis];
+            counter[axis] = 0;
+        }
+    }
+    return out;
+}
+
+void appendElements(std::string& s, const double* data, const std::vector<size_t>& shape, size_t axis, size_t stride,
+                    int precision) {
+    s += "[";
+    size_t count = shape[axis];
+    size_t step = stride / std::max<size_t>(count, 1);
+    for (size_t i = 0; i < count; ++i) {
+        if (i > 0) s += ", ";
+        if (axis + 1 == shape.size()) {
+            appendNumber(s, data[i], precision);
+        } else {
+            appendElements(s, data + i * step, shape, axis + 1, step, precision);
+        }
+    }
+    s += "]";
+}
+} // namespace
+
+// --- Tensor ---
+Tensor::Tensor(std::vector<size_t> shape, double fill)
+    : data_(allocateElements(elementCount(shape), fill)), shape_(std::move(shape)), size_(elementCount(shape_)) {}
+
+Tensor::Tensor(std::shared_ptr<double> data, std::vector<size_t> shape)
+    : data_(std::move(data)), shape_(std::move(shape)), size_(elementCount(shape_)) {}
+
+// Throws rather than wrap around when the elements' bytes would not fit a size_t
+size_t Tensor::elementCount(const std::vector<size_t>& shape) {
+    if (std::find(shape.begin(), shape.end(), size_t(0)) != shape.end()) return 0;
+    const size_t limit = std::numeric_limits<size_t>::max() / sizeof(double);
+    size_t count = 1;
+    for (size_t dimension : shape) {
+        if (count > limit / dimension) {
+            throw MegaladonError("A tensor of shape " + shapeString(shape) + " has too many elements.");
+        }
+        count *= dimension;
+    }
+    return count;
+}
+
+std::string Tensor::shapeString(const std::vector<size_t>& shape) {
+    std::string s = "(";
+    for (size_t i = 0; i < shape.size(); ++i) {
+        if (i > 0) s += ", ";
+        s += std::to_string(shape[i]);
+    }
+    return s + (shape.size() == 1 ? ",)" : ")");
+}
+
+std::string Tensor::toString() const {
+    std::string s;
+    appendTo(s);
+    return s;
+}
+
+void Tensor::appendTo(std::string& out, int precision) const {
+    out += "tensor(";
+    appendElements(out, data(), shape_, 0, size_, precision);
+    out += ')';
+}
+
+std::shared_ptr<Tensor> Tensor::row(size_t index) const {
+    size_t step = rowSize();
+    // Aliasing constructor: owns the whole buffer, points at the row
+    return std::shared_ptr<Tensor>(new Tensor(std::shared_ptr<double>(data_, data_.get() + index * step),
+                                              std::vector<size_t>(shape_.begin() + 1, shape_.end())));
+}
+
+std::shared_ptr<Tensor> Tensor::rows(size_t start, size_t stop) const {
+    std::vector<size_t> shape = shape_;
+    shape[0] = stop - start;
+    return std::shared_ptr<Tensor>(new Tensor(std::shared_ptr<double>(data_, data_.get() + start * rowSize()), std::move(shape)));
+}
+
+std::shared_ptr<Tensor> Tensor::reshaped(std::vector<size_t> shape) const {
+    if (elementCount(shape) != size_) {
+        throw MegaladonError("Cannot reshape a tensor of shape " + shapeString(shape_) + " into " + shapeString(shape) + ".");
+    }
+    return std::shared_ptr<Tensor>(new Tensor(data_, std::move(shape)));
+}
+
+bool operator==(const Tensor& lhs, const Tensor& rhs) {
+    return lhs.shape() == rhs.shape() &&
+           (lhs.data() == rhs.data() || std::equal(lhs.data(), lhs.data() + lhs.size(), rhs.data()));
+}
+
+// --- Element-wise operations ---
+std::shared_ptr<Tensor> tensorArithmetic(ArithmeticOp op, const Tensor& a, const Tensor& b) {
+    return broadcastApply(a, b, [op](const double* x, bool xSteps, const double* y, bool ySteps, double* out, size_t n) {
+        if (xSteps && ySteps) {
+            kernelArithmetic(op, x, y, out, n);
+        } else if (xSteps) {
+            kernelArithmeticScalar(op, x, *y, false, out, n);
+        } else if (ySteps) {
+            kernelArithmeticScalar(op, y, *x, true, out, n);
+        } else {
+            kernelArithmeticScalar(op, x, *y, false, out, 1);
+            std::fill(out + 1, out + n, out[0]);
+        }
+    });
+}
+
+std::shared_ptr<Tensor> tensorArithmetic(ArithmeticOp op, const Tensor& a, double scalar, bool scalarOnLeft) {
+    auto out = std::make_shared<Tensor>(a.shape());
+    kernelArithmeticScalar(op, a.data(), scalar, scalarOnLeft, out->data(), a.size());
+    return out;
+}
+
+std::shared_ptr<Tensor> tensorCompare(CompareOp op, const Tensor& a, const Tensor& b) {
+    return broadcastApply(a, b, [op](const double* x, bool xSteps, const double* y, bool ySteps, double* out, size_t n) {
+        if (xSteps && ySteps) {
+            kernelCompare(op, x, y, out, n);
+        } else if (xSteps) {
+            kernelCompareScalar(op, x, *y, false, out, n);
+        } else if (ySteps) {
+            kernelCompareScalar(op, y, *x, true, out, n);
+        } else {
+            kernelCompareScalar(op, x, *y, false, out, 1);
+            std::fill(out + 1, out + n, out[0]);
+        }
+    });
+}
+
+std::shared_ptr<Tensor> tensorCompare(CompareOp op, const Tensor& a, double scalar, bool scalarOnLeft) {
+    auto out = std::make_shared<Tensor>(a.shape());
+    kernelCompareScalar(op, a.data(), scalar, scalarOnLeft, out->data(), a.size());
+    return out;
+}
+
+// --- Linear algebra ---
+std::shared_ptr<Tensor> tensorMatmul(const Tensor& a, const Tensor& b) {
+    if (a.rank() > 2 || b.rank() > 2) {
+        throw MegaladonError("matmul() supports 1-D and 2-D tensors.");
+    }
+    size_t m = a.rank() == 2 ? a.shape()[0] : 1;
+    size_t k = a.shape().back();
+    size_t n = b.rank() == 2 ? b.shape()[1] : 1;
+    if (b.shape()[0] != k) {
+        throw MegaladonError("matmul() shapes " + Tensor::shapeString(a.shape()) + " and " +
+                             Tensor::shapeString(b.shape()) + " do not line up.");
+    }
+    std::vector<size_t> shape;
+    if (a.rank() == 2) shape.push_back(m);
+    if (b.rank() == 2) shape.push_back(n);
+    auto out = std::make_shared<Tensor>(shape);
+    if (b.rank() == 1) {
+        // Matrix times vector is one dot product per row; nothing to block
+        for (size_t i = 0; i < m; ++i) {
+            out->data()[i] = kernelDot(a.data() + i * k, b.data(), k);
+        }
+    } else {
+        kernelMatmul(a.data(), b.data(), out->data(), m, k, n, &ThreadPool::shared());
+    }
+    return out;
+}
+
+std::shared_ptr<Tensor> tensorTranspose(const std::shared_ptr<Tensor>& a) {
+    if (a->rank() < 2) return a;
+    std::vector<size_t> shape = a->shape();
+    size_t rows = shape[shape.size() - 2];
+    size_t cols = shape[shape.size() - 1];
+    std::swap(shape[shape.size() - 2], shape[shape.size() - 1]);
+    auto out = std::make_shared<Tensor>(shape);
+    size_t matrix = rows * cols;
+    for (size_t offset = 0; matrix > 0 && offset < a->size(); offset += matrix) {
+        kernelTranspose(a->data() + offset, out->data() + offset, rows, cols);
+    }
+    return out;
+}
+
+// --- Reductions ---
+double tensorReduce(Reduction reduction, const Tensor& a) {
+    if (a.size() == 0 && reduction != Reduction::SUM) {
+        throw MegaladonError("Cannot take the min, max or mean of an empty tensor.");
+    }
+    switch (reduction) {
+        case Reduction::SUM: return kernelSum(a.data(), a.size());
+        case Reduction::MEAN: return kernelSum(a.data(), a.size()) / static_cast<double>(a.size());
+        case Reduction::MIN: return kernelMin(a.data(), a.size());
+        case Reduction::MAX: return kernelMax(a.data(), a.size());
+    }
+    return 0.0;
+}
+
+// Viewed as (outer, length, inner) around 'axis': the last axis reduces each
+// contiguous run with one kernel call, other axes combine whole slices element-wise
+std::shared_ptr<Tensor> tensorReduce(Reduction reduction, const Tensor& a, size_t axis) {
+    const auto& shape = a.shape();
+    size_t length = shape[axis];
+    if (length == 0 && reduction != Reduction::SUM) {
+        throw MegaladonError("Cannot take the min, max or mean along an empty axis.");
+    }
+    size_t outer = Tensor::elementCount(std::vector<size_t>(shape.begin(), shape.begin() + axis));
+    size_t inner = Tensor::elementCount(std::vector<size_t>(shape.begin() + axis + 1, shape.end()));
+    std::vector<size_t> reducedShape = shape;
+    reducedShape.erase(reducedShape.begin() + axis);
+    auto out = std::make_shared<Tensor>(reducedShape);
+
+    for (size_t o = 0; o < outer; ++o) {
+        const double* block = a.data() + o * length * inner;
+        double* target = out->data() + o * inner;
+        if (inner == 1) {
+            switch (reduction) {
+                case Reduction::SUM:
+                case Reduction::MEAN: *target = kernelSum(block, length); break;
+                case Reduction::MIN: *target = kernelMin(block, length); break;
+                case Reduction::MAX: *target = kernelMax(block, length); break;
+            }
+            continue;
+        }
+        if (length == 0) continue; // Sums of nothing stay zero
+        std::copy(block, block + inner, target);
+        for (size_t l = 1; l < length; ++l) {
+            const double* slice = block + l * inner;
+            switch (reduction) {
+                case Reduction::SUM:
+                case Reduction::MEAN:
+                    kernelArithmetic(ArithmeticOp::ADD, target, slice, target, inner);
+                    break;
+                // A NaN on either side wins, as in kernelMin/kernelMax (std::min
+                // and std::max keep or drop it depending on the operand order)
+                case Reduction::MIN:
+                    for (size_t i = 0; i < inner; ++i) {
+                        if (slice[i] < target[i] || slice[i] != slice[i]) target[i] = slice[i];
+                    }
+                    break;
+                case Reduction::MAX:
+                    for (size_t i = 0; i < inner; ++i) {
+                        if (slice[i] > target[i] || slice[i] != slice[i]) target[i] = slice[i];
+                    }
+                    break;
+            }
+        }
+    }
+    if (reduction == Reduction::MEAN) {
+        kernelArithmeticScalar(ArithmeticOp::MULTIPLY, out->data(), 1.0 / static_cast<double>(length), false,
+                               out->data(), out->size());
+    }
+    return out;
+}
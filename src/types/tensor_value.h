@@ -0,0 +1,66 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>  // For std::shared_ptr
+#include <cstddef> // For size_t
+#include "../util/numeric_kernels.h" // For ArithmeticOp, CompareOp
+
+// --- Tensor Definition ---
+// N-dimensional array of doubles in row-major order, stored contiguously in a
+// 64-byte aligned buffer. Like NumericArray, tensors are reference values and
+// element assignment is seen through every copy. Indexing or slicing along the
+// first axis (t[i], t[a:b]) and reshape() return views that share the buffer,
+// so they are O(1) and writes through them update the original.
+class Tensor {
+public:
+    explicit Tensor(std::vector<size_t> shape, double fill = 0.0);
+
+    const std::vector<size_t>& shape() const { return shape_; }
+    size_t rank() const { return shape_.size(); }
+    size_t size() const { return size_; }
+    double* data() const { return data_.get(); }
+    // Elements per step along the first axis (the product of the other dimensions)
+    size_t rowSize() const { return shape_.empty() || shape_[0] == 0 ? 0 : size_ / shape_[0]; }
+
+    // Views sharing this tensor's buffer: one index / rows [start, stop) along the
+    // first axis, or all elements with another shape. The caller checks bounds
+    // and that rank() > 1 for row().
+    std::shared_ptr<Tensor> row(size_t index) const;
+    std::shared_ptr<Tensor> rows(size_t start, size_t stop) const;
+    std::shared_ptr<Tensor> reshaped(std::vector<size_t> shape) const; // Throws unless the sizes match
+
+    static size_t elementCount(const std::vector<size_t>& shape); // Throws if the product overflows
+    static std::string shapeString(const std::vector<size_t>& shape); // e.g. "(2, 3)"
+    std::string toString() const;
+    void appendTo(std::string& out, int precision = -1) const;
+
+private:
+    Tensor(std::shared_ptr<double> data, std::vector<size_t> shape);
+
+    std::shared_ptr<double> data_; // Points at this view's first element; owns the whole buffer
+    std::vector<size_t> shape_;
+    size_t size_;
+};
+
+bool operator==(const Tensor& lhs, const Tensor& rhs); // Same shape and elements
+
+// Element-wise operations with NumPy broadcasting: shapes are lined up at the
+// last axis and a dimension of 1 (or a missing one) stretches to match the
+// other side. Throws if the shapes cannot be broadcast together.
+std::shared_ptr<Tensor> tensorArithmetic(ArithmeticOp op, const Tensor& a, const Tensor& b);
+std::shared_ptr<Tensor> tensorArithmetic(ArithmeticOp op, const Tensor& a, double scalar, bool scalarOnLeft);
+std::shared_ptr<Tensor> tensorCompare(CompareOp op, const Tensor& a, const Tensor& b);
+std::shared_ptr<Tensor> tensorCompare(CompareOp op, const Tensor& a, double scalar, bool scalarOnLeft);
+
+// (m x k) @ (k x n); 1-D operands act as a row (left) or a column (right) vector
+// and that axis is dropped from the result. Two 1-D operands are handled by the
+// caller as a dot product. Large products are spread over the shared thread pool.
+std::shared_ptr<Tensor> tensorMatmul(const Tensor& a, const Tensor& b);
+// Swaps the last two axes (a copy); 1-D tensors are returned as they are
+std::shared_ptr<Tensor> tensorTranspose(const std::shared_ptr<Tensor>& a);
+
+enum class Reduction { SUM, MIN, MAX, MEAN };
+double tensorReduce(Reduction reduction, const Tensor& a); // Over all elements
+std::shared_ptr<Tensor> tensorReduce(Reduction reduction, const Tensor& a, size_t axis); // Needs rank() > 1
+// --- End Tensor Definition ---
@@ -1,46 +1,166 @@
 #include "value.h"
-#include <iomanip> // For std::fixed, std::setprecision
+#include "numeric_array.h"
+#include "map_value.h"
+#include "set_value.h"
+#include "iterable.h"
+#include "persistent_vector.h"
+#include "tensor_value.h"
+#include "../util/number_format.h"
+#include <algorithm>  // For std::min, std::none_of
+#include <cmath>      // For std::isnan
+#include <cstdint>    // For uint64_t
+#include <cstring>    // For std::memcpy
+#include <functional> // For std::hash
 
 // Implementation of MegaladonValue::toString()
 std::string MegaladonValue::toString() const {
+    std::string s;
+    appendTo(s);
+    return s;
+}
+
+// Containers append their elements into the same buffer, so printing a large
+// list is one growing string rather than a temporary per element
+void MegaladonValue::appendTo(std::string& out, int precision) const {
     switch (type) {
-        case VOID: return "void";
-        case NUMBER: {
-            double num = std::get<double>(data);
-            if (std::fmod(num, 1.0) == 0.0) { // Check if it's an integer
-                return std::to_string(static_cast<long long>(num));
-            } else {
-                // Use std::fixed and std::setprecision for consistent double output
-                std::stringstream ss;
-                ss << std::fixed << std::setprecision(6) << num; // Adjust precision as needed
-                std::string s = ss.str();
-                // Remove trailing zeros and decimal point if it's a whole number
-                s.erase(s.find_last_not_of('0') + 1, std::string::npos);
-                if (s.back() == '.') {
-                    s.pop_back();
-                }
-                return s;
+        case VOID: out += "void"; return;
+        case NUMBER: appendNumber(out, std::get<double>(data), precision); return;
+        case BOOLEAN: out += std::get<bool>(data) ? "true" : "false"; return;
+        case STRING: out += std::get<MegaladonString>(data).view(); return;
+        case LIST: {
+            out += '[';
+            const auto& list = asList();
+            for (size_t i = 0; i < list.size(); ++i) {
+                if (i > 0) out += ", ";
+                list[i].appendTo(out, precision);
+            }
+            out += ']';
+            return;
+        }
+        case ARRAY: {
+            out += "array([";
+            const auto& array = *std::get<std::shared_ptr<NumericArray>>(data);
+            for (size_t i = 0; i < array.size(); ++i) {
+                if (i > 0) out += ", ";
+                appendNumber(out, array.values[i], precision);
+            }
+            out += "])";
+            return;
+        }
+        case MAP: {
+            out += '{';
+            bool first = true;
+            for (const auto& entry : std::get<std::shared_ptr<MegaladonMap>>(data)->entries()) {
+                if (entry.removed()) continue;
+                if (!first) out += ", ";
+                entry.key.appendTo(out, precision);
+                out += ": ";
+                entry.value.appendTo(out, precision);
+                first = false;
+            }
+            out += '}';
+            return;
+        }
+        case SET: {
+            // Written like the to_set() call that builds it, so an empty set
+            // cannot be mistaken for an empty map
+            out += "to_set([";
+            bool first = true;
+            std::get<std::shared_ptr<MegaladonSet>>(data)->forEach([&](const MegaladonValue& element) {
+                if (!first) out += ", ";
+                element.appendTo(out, precision);
+                first = false;
+            });
+            out += "])";
+            return;
+        }
+        case VECTOR: {
+            out += "vec([";
+            const auto& vector = *std::get<std::shared_ptr<const PersistentVector>>(data);
+            for (size_t i = 0; i < vector.size(); ++i) {
+                if (i > 0) out += ", ";
+                vector.get(i).appendTo(out, precision);
             }
+            out += "])";
+            return;
         }
-        case BOOLEAN: return std::get<bool>(data) ? "true" : "false";
-        case STRING: return std::get<std::string>(data);
+        case BYTES: {
+            // Length plus the leading bytes in hex; buffers can be whole files
+            static const char digits[] = "0123456789abcdef";
+            const auto& bytes = std::get<MegaladonBytes>(data);
+            out += "bytes(";
+            out += std::to_string(bytes.size());
+            size_t shown = std::min<size_t>(bytes.size(), 32);
+            if (shown > 0) out += ':';
+            for (size_t i = 0; i < shown; ++i) {
+                out += ' ';
+                out += digits[bytes.data()[i] >> 4];
+                out += digits[bytes.data()[i] & 15];
+            }
+            if (shown < bytes.size()) out += " ...";
+            out += ')';
+            return;
+        }
+        case TENSOR: std::get<std::shared_ptr<Tensor>>(data)->appendTo(out, precision); return;
+        case ITERABLE: out += std::get<std::shared_ptr<MegaladonIterable>>(data)->toString(); return;
+        case FUNCTION: out += std::get<std::shared_ptr<MegaladonCallable>>(data)->toString(); return;
+        case INVALID: out += "invalid"; return;
+        default: out += "unknown"; return;
+    }
+}
+
+namespace {
+// Lists at least this long are hashed (once, the hash is cached) before their
+// elements are compared, so comparing unequal lists again is O(1)
+constexpr size_t HASH_COMPARE_MIN_LENGTH = 32;
+
+// Hash of 'value' for equality shortcuts. Returns false for values whose
+// contents can change in place (arrays, maps, sets), which must never be cached.
+bool structuralHash(const MegaladonValue& value, size_t& hash) {
+    switch (value.type) {
+        case VOID:
+        case NUMBER:
+        case BOOLEAN:
+        case STRING:
+            hash = hashValue(value);
+            return true;
+        case FUNCTION:
+            // Functions compare by identity
+            hash = std::hash<const void*>{}(value.asCallable().get());
+            return true;
         case LIST: {
-            std::string s = "[";
-            const auto& list = std::get<std::vector<MegaladonValue>>(data);
-            for (size_t i = 0; i < list.size(); ++i) {
-                s += list[i].toString();
-                if (i < list.size() - 1) {
-                    s += ", ";
+            const ListStorage& storage = *value.listStorage();
+            if (storage.hashState == ListStorage::HASH_CACHED) {
+                hash = storage.hash;
+                return true;
+            }
+            if (storage.hashState == ListStorage::HASH_UNCACHEABLE) {
+                return false;
+            }
+            // Order matters for lists, so fold the element hashes in sequence
+            size_t combined = 0x345678 + storage.elements.size();
+            bool holdsNaN = false;
+            for (const auto& element : storage.elements) {
+                size_t elementHash;
+                if (!structuralHash(element, elementHash)) {
+                    storage.hashState = ListStorage::HASH_UNCACHEABLE;
+                    return false;
                 }
+                combined ^= elementHash + 0x9e3779b97f4a7c15ULL + (combined << 6) + (combined >> 2);
+                if (element.type == NUMBER) holdsNaN |= std::isnan(element.asNumber());
+                if (element.type == LIST) holdsNaN |= element.listStorage()->holdsNaN;
             }
-            s += "]";
-            return s;
+            storage.hash = combined;
+            storage.holdsNaN = holdsNaN;
+            storage.hashState = ListStorage::HASH_CACHED;
+            hash = combined;
+            return true;
         }
-        case FUNCTION: return std::get<std::shared_ptr<MegaladonCallable>>(data)->toString();
-        case INVALID: return "invalid";
-        default: return "unknown";
+        default:
+            return false;
     }
 }
+} // namespace
 
 // Implementation of equality operator
 bool operator==(const MegaladonValue& lhs, const MegaladonValue& rhs) {
@@ -58,8 +178,65 @@ bool operator==(const MegaladonValue& lhs, const MegaladonValue& rhs) {
             return lhs.asBoolean() == rhs.asBoolean();
         case STRING:
             return lhs.asString() == rhs.asString();
-        case LIST:
-            return lhs.asList() == rhs.asList(); // std::vector has operator==
+        case LIST: {
+            const auto& a = lhs.listStorage();
+            const auto& b = rhs.listStorage();
+            // Copies of one list share storage, and are equal unless an element is NaN
+            // (NaN != NaN, so sharing must not change the answer)
+            if (a == b) {
+                size_t ignored;
+                if (a->sortState != ListStorage::SORT_UNKNOWN) return true; // Sorted lists hold no NaN
+                if (structuralHash(lhs, ignored)) return !a->holdsNaN;
+            }
+            if (a->elements.size() != b->elements.size()) return false;
+            if (a->elements.size() >= HASH_COMPARE_MIN_LENGTH ||
+                (a->hashState == ListStorage::HASH_CACHED && b->hashState == ListStorage::HASH_CACHED)) {
+                size_t hashA, hashB;
+                if (structuralHash(lhs, hashA) && structuralHash(rhs, hashB) && hashA != hashB) return false;
+            }
+            return a->elements == b->elements; // std::vector has operator==
+        }
+        case ARRAY: {
+            // Arrays compare by contents, like lists; an array equals itself unless it holds NaN
+            const auto& values = lhs.asArray()->values;
+            if (lhs.asArray() == rhs.asArray()) {
+                return std::none_of(values.begin(), values.end(), [](double v) { return std::isnan(v); });
+            }
+            return values == rhs.asArray()->values;
+        }
+        case MAP: {
+            // Same keys with equal values, in any order
+            const auto& a = *lhs.asMap();
+            const auto& b = *rhs.asMap();
+            if (&a == &b) return true;
+            if (a.size() != b.size()) return false;
+            for (const auto& entry : a.entries()) {
+                if (entry.removed()) continue;
+                const MegaladonValue* other = b.get(entry.key);
+                if (!other || *other != entry.value) return false;
+            }
+            return true;
+        }
+        case SET: {
+            const auto& a = *lhs.asSet();
+            const auto& b = *rhs.asSet();
+            if (&a == &b) return true;
+            if (a.size() != b.size()) return false;
+            bool same = true;
+            a.forEach([&](const MegaladonValue& element) {
+                if (same && !b.has(element)) same = false;
+            });
+            return same;
+        }
+        case VECTOR:
+            // By contents; leaves shared between versions are skipped
+            return *lhs.asVector() == *rhs.asVector();
+        case BYTES:
+            return lhs.asBytes() == rhs.asBytes();
+        case TENSOR:
+            return *lhs.asTensor() == *rhs.asTensor();
+        case ITERABLE:
+            return lhs.asIterable() == rhs.asIterable();
         case FUNCTION:
             // Compare shared_ptr raw pointers or a custom ID for functions
             return lhs.asCallable() == rhs.asCallable();
@@ -71,4 +248,31 @@ bool operator==(const MegaladonValue& lhs, const MegaladonValue& rhs) {
 // Implementation of inequality operator
 bool operator!=(const MegaladonValue& lhs, const MegaladonValue& rhs) {
     return !(lhs == rhs);
-}
\ No newline at end of file
+}
+
+size_t hashValue(const MegaladonValue& value) {
+    switch (value.type) {
+        case NUMBER: {
+            double number = value.asNumber();
+            if (number == 0.0) number = 0.0; // -0 == 0, so they must hash alike
+            uint64_t bits;
+            std::memcpy(&bits, &number, sizeof(bits)); // Hash tables mix the bits themselves
+            return static_cast<size_t>(bits ^ (bits >> 29));
+        }
+        case BOOLEAN:
+            return value.asBoolean() ? 0x9e3779b97f4a7c15ULL : 0x7f4a7c159e3779b9ULL;
+        case STRING:
+            return value.asString().hash();
+        case LIST: {
+            size_t hash;
+            if (!structuralHash(value, hash)) {
+                throw std::runtime_error("MegaladonError: Value is not hashable.");
+            }
+            return hash; // Cached on the list's storage
+        }
+        case VOID:
+            return 0;
+        default:
+            throw std::runtime_error("MegaladonError: Value is not hashable.");
+    }
+}
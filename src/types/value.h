@@ -8,10 +8,50 @@
 #include <sstream>   // For std::stringstream
 #include <cmath>     // For std::fmod
 #include <iomanip>   // For std::fixed, std::setprecision
+#include "string_value.h" // For MegaladonString
+#include "bytes_value.h"  // For MegaladonBytes
 
 // Forward declarations for circular dependencies
 class Interpreter;
 class MegaladonCallable; // Forward declare MegaladonCallable because MegaladonValue uses it
+class NumericArray;      // Defined in numeric_array.h
+class MegaladonMap;      // Defined in map_value.h
+class MegaladonSet;      // Defined in set_value.h
+class MegaladonIterable; // Defined in iterable.h
+class PersistentVector;  // Defined in persistent_vector.h
+class Tensor;            // Defined in tensor_value.h
+
+class MegaladonValue;
+
+// --- ListStorage Definition ---
+// Element storage shared by list values. Copying a list value only bumps a
+// refcount; the elements are copied the first time one of the copies is
+// modified (asListMutable). Since shared storage never changes, its structural
+// hash can be cached on it and reused by every copy, and so can whether it is
+// known to be sorted.
+struct ListStorage {
+    enum HashState : unsigned char {
+        HASH_UNKNOWN,
+        HASH_CACHED,
+        HASH_UNCACHEABLE // Holds arrays, maps, ... whose contents can change underneath
+    };
+    // Set by list.sort(); lets searches use binary search
+    enum SortState : unsigned char {
+        SORT_UNKNOWN,
+        SORTED_NUMBERS, // Ascending numbers, no NaN
+        SORTED_STRINGS  // Ascending strings, by bytes
+    };
+
+    ListStorage() = default;
+    explicit ListStorage(std::vector<MegaladonValue> elements) : elements(std::move(elements)) {}
+
+    std::vector<MegaladonValue> elements;
+    mutable size_t hash = 0;
+    mutable bool holdsNaN = false; // Some element (or element of a nested list) is NaN; set with the hash
+    mutable HashState hashState = HASH_UNKNOWN;
+    mutable SortState sortState = SORT_UNKNOWN;
+};
+// --- End ListStorage Definition ---
 
 // --- MegaladonValue Definition ---
 // Define a variant to hold different types of values
@@ -21,6 +61,13 @@ enum ValueType {
     BOOLEAN,
     STRING,
     LIST,
+    ARRAY,    // Dense numeric array (NumericArray)
+    MAP,      // Hash map (MegaladonMap)
+    SET,      // Hash set (MegaladonSet)
+    ITERABLE, // Lazy sequence (range, chars, lines, list views)
+    VECTOR,   // Persistent immutable vector (PersistentVector)
+    BYTES,    // Byte buffer (MegaladonBytes)
+    TENSOR,   // N-dimensional numeric array (Tensor)
     FUNCTION, // For user-defined functions and built-in callables
     INVALID   // For error states or uninitialized values
 };
@@ -29,7 +76,11 @@ class MegaladonValue {
 public:
     // Use std::variant to hold different types of data
     // std::monostate is for VOID type
-    std::variant<std::monostate, double, bool, std::string, std::vector<MegaladonValue>, std::shared_ptr<MegaladonCallable>> data;
+    std::variant<std::monostate, double, bool, MegaladonString, std::shared_ptr<ListStorage>, std::shared_ptr<MegaladonCallable>,
+                 std::shared_ptr<NumericArray>, std::shared_ptr<MegaladonMap>,
+                 std::shared_ptr<MegaladonSet>, std::shared_ptr<MegaladonIterable>,
+                 std::shared_ptr<const PersistentVector>, MegaladonBytes,
+                 std::shared_ptr<Tensor>> data;
     ValueType type;
 
     // Constructors
@@ -37,16 +88,32 @@ public:
     MegaladonValue(ValueType type) : type(type) { // For specific VOID or INVALID initialization
         if (type == NUMBER) data = 0.0;
         else if (type == BOOLEAN) data = false;
-        else if (type == STRING) data = "";
-        else if (type == LIST) data = std::vector<MegaladonValue>();
+        else if (type == STRING) data = MegaladonString();
+        else if (type == LIST) data = std::make_shared<ListStorage>();
         else if (type == FUNCTION) data = std::shared_ptr<MegaladonCallable>();
+        else if (type == ARRAY) data = std::shared_ptr<NumericArray>();
+        else if (type == MAP) data = std::shared_ptr<MegaladonMap>();
+        else if (type == SET) data = std::shared_ptr<MegaladonSet>();
+        else if (type == ITERABLE) data = std::shared_ptr<MegaladonIterable>();
+        else if (type == VECTOR) data = std::shared_ptr<const PersistentVector>();
+        else if (type == BYTES) data = MegaladonBytes();
+        else if (type == TENSOR) data = std::shared_ptr<Tensor>();
     }
 
     MegaladonValue(double val) : data(val), type(NUMBER) {}
     MegaladonValue(bool val) : data(val), type(BOOLEAN) {}
-    MegaladonValue(std::string val) : data(std::move(val)), type(STRING) {}
-    MegaladonValue(std::vector<MegaladonValue> val) : data(std::move(val)), type(LIST) {}
+    MegaladonValue(std::string val) : data(MegaladonString(std::move(val))), type(STRING) {}
+    MegaladonValue(const char* val) : data(MegaladonString(val)), type(STRING) {} // Without this, string literals would pick the bool overload
+    MegaladonValue(MegaladonString val) : data(std::move(val)), type(STRING) {}
+    MegaladonValue(std::vector<MegaladonValue> val) : data(std::make_shared<ListStorage>(std::move(val))), type(LIST) {}
     MegaladonValue(std::shared_ptr<MegaladonCallable> val) : data(std::move(val)), type(FUNCTION) {}
+    MegaladonValue(std::shared_ptr<NumericArray> val) : data(std::move(val)), type(ARRAY) {}
+    MegaladonValue(std::shared_ptr<MegaladonMap> val) : data(std::move(val)), type(MAP) {}
+    MegaladonValue(std::shared_ptr<MegaladonSet> val) : data(std::move(val)), type(SET) {}
+    MegaladonValue(std::shared_ptr<MegaladonIterable> val) : data(std::move(val)), type(ITERABLE) {}
+    MegaladonValue(std::shared_ptr<const PersistentVector> val) : data(std::move(val)), type(VECTOR) {}
+    MegaladonValue(MegaladonBytes val) : data(std::move(val)), type(BYTES) {}
+    MegaladonValue(std::shared_ptr<Tensor> val) : data(std::move(val)), type(TENSOR) {}
 
     // Type checking methods
     bool isVoid() const { return type == VOID; }
@@ -55,6 +122,13 @@ public:
     bool isString() const { return type == STRING; }
     bool isList() const { return type == LIST; }
     bool isFunction() const { return type == FUNCTION; }
+    bool isArray() const { return type == ARRAY; }
+    bool isMap() const { return type == MAP; }
+    bool isSet() const { return type == SET; }
+    bool isIterable() const { return type == ITERABLE; }
+    bool isVector() const { return type == VECTOR; }
+    bool isBytes() const { return type == BYTES; }
+    bool isTensor() const { return type == TENSOR; }
     bool isInvalid() const { return type == INVALID; }
 
     // Value conversion methods (with checks for safety)
@@ -69,21 +143,34 @@ public:
         throw std::runtime_error("MegaladonError: Value is not a boolean.");
     }
 
-    const std::string& asString() const {
-        if (type == STRING) return std::get<std::string>(data);
+    // Strings are immutable; copy the MegaladonString (cheap) or use view() to read the bytes
+    const MegaladonString& asString() const {
+        if (type == STRING) return std::get<MegaladonString>(data);
         throw std::runtime_error("MegaladonError: Value is not a string.");
     }
 
     const std::vector<MegaladonValue>& asList() const {
-        if (type == LIST) return std::get<std::vector<MegaladonValue>>(data);
+        if (type == LIST) return std::get<std::shared_ptr<ListStorage>>(data)->elements;
         throw std::runtime_error("MegaladonError: Value is not a list.");
     }
 
     // For modifying list in place for methods
     // NOTE: This should only be called on a non-const MegaladonValue
+    // Copies the elements first if another value shares them (copy-on-write)
     std::vector<MegaladonValue>& asListMutable() {
-        if (type == LIST) return std::get<std::vector<MegaladonValue>>(data);
-        throw std::runtime_error("MegaladonError: Value is not a list or cannot be modified.");
+        if (type != LIST) throw std::runtime_error("MegaladonError: Value is not a list or cannot be modified.");
+        auto& storage = std::get<std::shared_ptr<ListStorage>>(data);
+        if (storage.use_count() > 1) {
+            storage = std::make_shared<ListStorage>(storage->elements);
+        }
+        storage->hashState = ListStorage::HASH_UNKNOWN; // The caller is about to change the elements
+        storage->sortState = ListStorage::SORT_UNKNOWN;
+        return storage->elements;
+    }
+
+    const std::shared_ptr<ListStorage>& listStorage() const {
+        if (type == LIST) return std::get<std::shared_ptr<ListStorage>>(data);
+        throw std::runtime_error("MegaladonError: Value is not a list.");
     }
 
     std::shared_ptr<MegaladonCallable> asCallable() const {
@@ -91,14 +178,72 @@ public:
         throw std::runtime_error("MegaladonError: Value is not a callable function.");
     }
 
+    const std::shared_ptr<NumericArray>& asArray() const {
+        if (type == ARRAY) return std::get<std::shared_ptr<NumericArray>>(data);
+        throw std::runtime_error("MegaladonError: Value is not an array.");
+    }
+
+    const std::shared_ptr<MegaladonMap>& asMap() const {
+        if (type == MAP) return std::get<std::shared_ptr<MegaladonMap>>(data);
+        throw std::runtime_error("MegaladonError: Value is not a map.");
+    }
+
+    const std::shared_ptr<MegaladonSet>& asSet() const {
+        if (type == SET) return std::get<std::shared_ptr<MegaladonSet>>(data);
+        throw std::runtime_error("MegaladonError: Value is not a set.");
+    }
+
+    const std::shared_ptr<MegaladonIterable>& asIterable() const {
+        if (type == ITERABLE) return std::get<std::shared_ptr<MegaladonIterable>>(data);
+        throw std::runtime_error("MegaladonError: Value is not an iterable.");
+    }
+
+    const std::shared_ptr<const PersistentVector>& asVector() const {
+        if (type == VECTOR) return std::get<std::shared_ptr<const PersistentVector>>(data);
+        throw std::runtime_error("MegaladonError: Value is not a vector.");
+    }
+
+    // Copies share the buffer, so writes through this are seen by every copy
+    const MegaladonBytes& asBytes() const {
+        if (type == BYTES) return std::get<MegaladonBytes>(data);
+        throw std::runtime_error("MegaladonError: Value is not a bytes buffer.");
+    }
+
+    const std::shared_ptr<Tensor>& asTensor() const {
+        if (type == TENSOR) return std::get<std::shared_ptr<Tensor>>(data);
+        throw std::runtime_error("MegaladonError: Value is not a tensor.");
+    }
+
     // String representation for debugging and 'print' function
     std::string toString() const; // Implemented in value.cpp
+    // Appends the same text to 'out'; precision >= 0 prints every number in the
+    // value with that many digits after the point (see appendNumber)
+    void appendTo(std::string& out, int precision = -1) const;
 };
 
 // Equality operator (for comparing MegaladonValues)
 bool operator==(const MegaladonValue& lhs, const MegaladonValue& rhs);
 bool operator!=(const MegaladonValue& lhs, const MegaladonValue& rhs);
 
+// Hash consistent with operator== (equal values hash equally); used by maps and sets
+size_t hashValue(const MegaladonValue& value);
+
+// A call's arguments, viewed where the caller already holds them (no copy)
+class ArgumentSpan {
+public:
+    ArgumentSpan(const MegaladonValue* data, size_t size) : data_(data), size_(size) {}
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const MegaladonValue& operator[](size_t index) const { return data_[index]; }
+    const MegaladonValue* begin() const { return data_; }
+    const MegaladonValue* end() const { return data_ + size_; }
+
+private:
+    const MegaladonValue* data_;
+    size_t size_;
+};
+
 // --- MegaladonCallable Definition ---
 // Define MegaladonCallable AFTER MegaladonValue, as it uses MegaladonValue directly
 class MegaladonCallable {
@@ -108,6 +253,17 @@ public:
     virtual std::string toString() const = 0;
     virtual MegaladonValue call(Interpreter& interpreter, const std::vector<MegaladonValue>& arguments) = 0;
 
+    // Fast calling convention used by the interpreter: the arguments stay in the
+    // caller's frame and the arity has already been checked. Callables that can
+    // read a span override this; the default copies it into a vector for call().
+    virtual MegaladonValue fastCall(Interpreter& interpreter, ArgumentSpan arguments) {
+        return call(interpreter, std::vector<MegaladonValue>(arguments.begin(), arguments.end()));
+    }
+
+    // True if calls only read their arguments and touch no interpreter state, so
+    // map and filter may make them from several threads at once
+    virtual bool isPure() const { return false; }
+
     // A virtual destructor is crucial for proper polymorphism with shared_ptr
     virtual ~MegaladonCallable() = default;
 };
@@ -0,0 +1,23 @@
+#include "cpu_features.h"
+#include <cstdlib> // For std::getenv
+
+const CpuFeatures& CpuFeatures::get() {
+    static const CpuFeatures features = [] {
+        CpuFeatures detected;
+#if MEGALADON_X86_SIMD
+        __builtin_cpu_init();
+        detected.sse2 = __builtin_cpu_supports("sse2");
+        detected.sse42 = __builtin_cpu_supports("sse4.2");
+        detected.avx2 = __builtin_cpu_supports("avx2");
+        detected.fma = __builtin_cpu_supports("fma");
+#endif
+        // MEGALADON_NO_AVX2=1 runs the portable kernels, e.g. to compare them (bench/)
+        const char* disable = std::getenv("MEGALADON_NO_AVX2");
+        if (disable && *disable && *disable != '0') {
+            detected.avx2 = false;
+            detected.fma = false;
+        }
+        return detected;
+    }();
+    return features;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+// Runtime CPU feature detection for SIMD kernel dispatch.
+// Results are computed once and cached. Setting MEGALADON_NO_AVX2 (to anything
+// but 0) reports AVX2 and FMA as missing.
+struct CpuFeatures {
+    bool sse2 = false;
+    bool sse42 = false;
+    bool avx2 = false;
+    bool fma = false;
+
+    static const CpuFeatures& get();
+};
+
+// Function-level target attributes let one binary carry AVX2 code paths
+// without requiring AVX2 to build or run.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define MEGALADON_X86_SIMD 1
+#define MEGALADON_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+#define MEGALADON_X86_SIMD 0
+#define MEGALADON_TARGET_AVX2
+#endif
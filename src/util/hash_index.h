@@ -0,0 +1,232 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef> // For size_t
+#include <vector>
+#include <algorithm> // For std::fill
+#include <iterator>  // For std::begin, std::end
+
+#if defined(__SSE2__)
+#include <emmintrin.h> // For _mm_cmpeq_epi8, _mm_movemask_epi8
+#endif
+
+// --- HashIndex Definition ---
+// Open-addressing hash index in the SwissTable layout. It maps hashes to entry
+// numbers (positions in the owner's insertion-ordered entry vector); the owner
+// stores the keys and does the final equality check, so one index serves maps
+// and sets alike.
+//
+// Slots come in groups of 16, each with a control byte: EMPTY, DELETED, or the
+// low 7 bits of the hash of the entry in it. A lookup compares all 16 control
+// bytes of a group against the hash bits in one SSE2 instruction, so most
+// lookups touch one group and only compare keys whose 7 hash bits already match.
+class HashIndex {
+public:
+    static constexpr uint32_t NOT_FOUND = UINT32_MAX;
+    static constexpr size_t GROUP_WIDTH = 16;
+
+    size_t size() const { return size_; }
+
+    // Returns the entry number whose key matches, or NOT_FOUND.
+    // 'matches(entry)' compares the caller's key against entry 'entry'.
+    template <typename Matches>
+    uint32_t find(size_t hash, Matches&& matches) const {
+        if (groups_.empty()) return NOT_FOUND;
+        size_t h = mix(hash);
+        uint8_t tag = static_cast<uint8_t>(h & 0x7F);
+        size_t group = (h >> 7) & groupMask();
+        for (size_t step = 1;; ++step) {
+            const Group& g = groups_[group];
+            for (uint32_t bits = g.match(tag); bits != 0; bits &= bits - 1) {
+                uint32_t entry = g.slots[lowestBit(bits)];
+                if (matches(entry)) return entry;
+            }
+            if (g.match(EMPTY) != 0) return NOT_FOUND;
+            group = (group + step) & groupMask();
+        }
+    }
+
+    // Starts loading the group a lookup of 'hash' probes first (both of its
+    // cache lines), so batched lookups can overlap their misses
+    void prefetch(size_t hash) const {
+        if (groups_.empty()) return;
+        const char* group = reinterpret_cast<const char*>(&groups_[(mix(hash) >> 7) & groupMask()]);
+        __builtin_prefetch(group);
+        __builtin_prefetch(group + sizeof(Group) - 1);
+    }
+
+    // The entry in the first slot of the first group whose tag matches 'hash',
+    // or NOT_FOUND: the likely result of find(), read without comparing keys
+    uint32_t firstCandidate(size_t hash) const {
+        if (groups_.empty()) return NOT_FOUND;
+        size_t h = mix(hash);
+        const Group& g = groups_[(h >> 7) & groupMask()];
+        uint32_t bits = g.match(static_cast<uint8_t>(h & 0x7F));
+        return bits != 0 ? g.slots[lowestBit(bits)] : NOT_FOUND;
+    }
+
+    // Adds 'entry' under 'hash'; the caller has checked that the key is not present.
+    // 'hashOf(entry)' must return the hash of any existing entry (used when growing).
+    template <typename HashOf>
+    void insert(size_t hash, uint32_t entry, HashOf&& hashOf) {
+        if (growthLeft_ == 0) {
+            // Mostly tombstones: rehash in place; otherwise double
+            size_t capacity = capacity_();
+            size_t target = (size_ * 2 < capacity - capacity / 8) ? capacity : capacity * 2;
+            rehash(target < GROUP_WIDTH ? GROUP_WIDTH : target, hashOf);
+        }
+        place(mix(hash), entry);
+    }
+
+    // Removes the slot holding 'entry' under 'hash'. Returns false if it was not indexed.
+    bool erase(size_t hash, uint32_t entry) {
+        if (groups_.empty()) return false;
+        size_t h = mix(hash);
+        uint8_t tag = static_cast<uint8_t>(h & 0x7F);
+        size_t group = (h >> 7) & groupMask();
+        for (size_t step = 1;; ++step) {
+            Group& g = groups_[group];
+            for (uint32_t bits = g.match(tag); bits != 0; bits &= bits - 1) {
+                unsigned slot = lowestBit(bits);
+                if (g.slots[slot] == entry) {
+                    g.control[slot] = DELETED;
+                    size_--;
+                    return true;
+                }
+            }
+            if (g.match(EMPTY) != 0) return false;
+            group = (group + step) & groupMask();
+        }
+    }
+
+    // Drops every slot and indexes entries [0, count) from scratch
+    // (used after the owner compacts its entry vector).
+    template <typename HashOf>
+    void rebuild(uint32_t count, HashOf&& hashOf) {
+        reset(capacityFor(count));
+        for (uint32_t entry = 0; entry < count; ++entry) {
+            place(mix(hashOf(entry)), entry);
+        }
+    }
+
+    // Sizes the table so 'count' entries fit without growing
+    template <typename HashOf>
+    void reserve(size_t count, HashOf&& hashOf) {
+        if (count <= size_ + growthLeft_) return;
+        rehash(capacityFor(count), hashOf);
+    }
+
+    void clear() {
+        groups_.clear();
+        size_ = 0;
+        growthLeft_ = 0;
+    }
+
+    size_t approximateSize() const { return groups_.capacity() * sizeof(Group); }
+
+private:
+    static constexpr uint8_t EMPTY = 0x80;
+    static constexpr uint8_t DELETED = 0xFE;
+
+    // Control bytes and the slots they describe share a group, so a lookup
+    // that finds its tag reads the entry number from the same page
+    struct alignas(16) Group {
+        uint8_t control[GROUP_WIDTH];
+        uint32_t slots[GROUP_WIDTH];
+
+        // Bit i is set when control byte i equals 'tag'
+        uint32_t match(uint8_t tag) const {
+#if defined(__SSE2__)
+            __m128i bytes = _mm_load_si128(reinterpret_cast<const __m128i*>(control));
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(static_cast<char>(tag)))));
+#else
+            uint32_t bits = 0;
+            for (size_t i = 0; i < GROUP_WIDTH; ++i) {
+                if (control[i] == tag) bits |= 1u << i;
+            }
+            return bits;
+#endif
+        }
+
+        // EMPTY and DELETED are the only control bytes with the high bit set
+        uint32_t matchEmptyOrDeleted() const {
+#if defined(__SSE2__)
+            __m128i bytes = _mm_load_si128(reinterpret_cast<const __m128i*>(control));
+            return static_cast<uint32_t>(_mm_movemask_epi8(bytes));
+#else
+            uint32_t bits = 0;
+            for (size_t i = 0; i < GROUP_WIDTH; ++i) {
+                if (control[i] & 0x80) bits |= 1u << i;
+            }
+            return bits;
+#endif
+        }
+    };
+
+    // Spreads pointer-like or small-integer hashes over all bits
+    static size_t mix(size_t hash) {
+        uint64_t x = static_cast<uint64_t>(hash);
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        return static_cast<size_t>(x);
+    }
+
+    static unsigned lowestBit(uint32_t bits) { return static_cast<unsigned>(__builtin_ctz(bits)); }
+
+    // Smallest power-of-two slot count holding 'count' entries at the 7/8 max load factor
+    static size_t capacityFor(size_t count) {
+        size_t capacity = GROUP_WIDTH;
+        while (capacity - capacity / 8 < count) capacity *= 2;
+        return capacity;
+    }
+
+    size_t capacity_() const { return groups_.size() * GROUP_WIDTH; }
+    size_t groupMask() const { return groups_.size() - 1; }
+
+    // Stores 'entry' in the first free slot of its probe sequence (triangular
+    // steps over a power-of-two group count visit every group)
+    void place(size_t h, uint32_t entry) {
+        size_t group = (h >> 7) & groupMask();
+        for (size_t step = 1;; ++step) {
+            Group& g = groups_[group];
+            uint32_t bits = g.matchEmptyOrDeleted();
+            if (bits != 0) {
+                unsigned slot = lowestBit(bits);
+                if (g.control[slot] == EMPTY) growthLeft_--;
+                g.control[slot] = static_cast<uint8_t>(h & 0x7F);
+                g.slots[slot] = entry;
+                size_++;
+                return;
+            }
+            group = (group + step) & groupMask();
+        }
+    }
+
+    void reset(size_t capacity) {
+        Group empty;
+        std::fill(std::begin(empty.control), std::end(empty.control), EMPTY);
+        std::fill(std::begin(empty.slots), std::end(empty.slots), 0u);
+        groups_.assign(capacity / GROUP_WIDTH, empty);
+        size_ = 0;
+        growthLeft_ = capacity - capacity / 8; // Max load factor 7/8
+    }
+
+    template <typename HashOf>
+    void rehash(size_t capacity, HashOf&& hashOf) {
+        std::vector<Group> old = std::move(groups_);
+        reset(capacity);
+        for (const Group& g : old) {
+            for (size_t slot = 0; slot < GROUP_WIDTH; ++slot) {
+                if ((g.control[slot] & 0x80) == 0) {
+                    place(mix(hashOf(g.slots[slot])), g.slots[slot]);
+                }
+            }
+        }
+    }
+
+    std::vector<Group> groups_; // Power-of-two count (empty before the first insert)
+    size_t size_ = 0;
+    size_t growthLeft_ = 0; // Inserts into EMPTY slots left before the table must grow
+};
+// --- End HashIndex Definition ---
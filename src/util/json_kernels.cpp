@@ -0,0 +1,228 @@
+#include "json_kernels.h"
+#include "cpu_features.h"
+#include <cstring> // For std::memcpy, std::memset
+
+#if MEGALADON_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace {
+
+bool useAvx2() {
+#if MEGALADON_X86_SIMD
+    static const bool available = CpuFeatures::get().avx2;
+    return available;
+#else
+    return false;
+#endif
+}
+
+constexpr size_t BLOCK = 64;
+
+// One bit per byte of a 64-byte block
+struct BlockMasks {
+    uint64_t quote;
+    uint64_t backslash;
+    uint64_t op;         // { } [ ] : ,
+    uint64_t whitespace; // Space, tab, newline, carriage return
+};
+
+// What carries over from one block to the next
+struct ScanState {
+    uint64_t escapedNext = 0; // 1 if the block ended in an odd run of backslashes
+    uint64_t inString = 0;    // All ones if the block ended inside a string
+    uint64_t scalarNext = 0;  // 1 if the block ended inside a number or literal
+    size_t count = 0;         // Positions written so far
+};
+
+// Bits of the bytes escaped by a backslash: the byte after an odd-length run.
+// Runs starting on even and odd bits are told apart with one carrying add.
+inline uint64_t findEscaped(uint64_t backslash, uint64_t& escapedNext) {
+    const uint64_t evenBits = 0x5555555555555555ULL;
+    backslash &= ~escapedNext; // An escaped backslash does not escape anything
+    uint64_t followsEscape = backslash << 1 | escapedNext;
+    uint64_t oddStarts = backslash & ~evenBits & ~followsEscape;
+    uint64_t evenStartRuns;
+    escapedNext = __builtin_add_overflow(oddStarts, backslash, &evenStartRuns) ? 1 : 0;
+    uint64_t invert = evenStartRuns << 1;
+    return (evenBits ^ invert) & followsEscape;
+}
+
+// Bit i is the XOR of bits 0..i: ones from each opening quote up to (not
+// including) its closing quote
+inline uint64_t prefixXor(uint64_t bits) {
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+    return bits;
+}
+
+// Turns one block's masks into structural positions
+inline void consumeBlock(const BlockMasks& masks, ScanState& state, size_t base, std::vector<uint32_t>& positions) {
+    uint64_t quote = masks.quote & ~findEscaped(masks.backslash, state.escapedNext);
+    uint64_t inString = prefixXor(quote) ^ state.inString;
+    state.inString = static_cast<uint64_t>(static_cast<int64_t>(inString) >> 63);
+    uint64_t stringTail = inString ^ quote; // String contents and closing quotes
+
+    uint64_t scalar = ~(masks.op | masks.whitespace);
+    uint64_t nonQuoteScalar = scalar & ~quote;
+    uint64_t followsScalar = nonQuoteScalar << 1 | state.scalarNext;
+    state.scalarNext = nonQuoteScalar >> 63;
+    uint64_t starts = (masks.op | (scalar & ~followsScalar)) & ~stringTail;
+
+    if (state.count + BLOCK > positions.size()) {
+        positions.resize(positions.size() * 2 + BLOCK);
+    }
+    uint32_t* out = positions.data() + state.count;
+    uint32_t offset = static_cast<uint32_t>(base);
+    while (starts != 0) {
+        *out++ = offset + static_cast<uint32_t>(__builtin_ctzll(starts));
+        starts &= starts - 1;
+    }
+    state.count = static_cast<size_t>(out - positions.data());
+}
+
+// --- Portable scalar classification ---
+
+enum ByteClass : unsigned char { QUOTE = 1, BACKSLASH = 2, OPERATOR = 4, WHITESPACE = 8 };
+
+struct ClassTable {
+    unsigned char of[256] = {};
+    ClassTable() {
+        of[static_cast<unsigned char>('"')] = QUOTE;
+        of[static_cast<unsigned char>('\\')] = BACKSLASH;
+        for (unsigned char c : {'{', '}', '[', ']', ':', ','}) of[c] = OPERATOR;
+        for (unsigned char c : {' ', '\t', '\n', '\r'}) of[c] = WHITESPACE;
+    }
+};
+
+BlockMasks classifyScalar(const char* block) {
+    static const ClassTable table;
+    BlockMasks masks = {0, 0, 0, 0};
+    for (size_t i = 0; i < BLOCK; ++i) {
+        unsigned char kind = table.of[static_cast<unsigned char>(block[i])];
+        uint64_t bit = uint64_t(1) << i;
+        if (kind & QUOTE) masks.quote |= bit;
+        if (kind & BACKSLASH) masks.backslash |= bit;
+        if (kind & OPERATOR) masks.op |= bit;
+        if (kind & WHITESPACE) masks.whitespace |= bit;
+    }
+    return masks;
+}
+
+size_t findSpecialScalar(std::string_view text, size_t from) {
+    for (size_t i = from; i < text.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c == '"' || c == '\\' || c < 0x20) return i;
+    }
+    return text.size();
+}
+
+// The last, partial block is padded with spaces
+bool indexScalar(std::string_view text, std::vector<uint32_t>& positions) {
+    ScanState state;
+    size_t whole = text.size() / BLOCK * BLOCK;
+    for (size_t base = 0; base < whole; base += BLOCK) {
+        consumeBlock(classifyScalar(text.data() + base), state, base, positions);
+    }
+    if (whole < text.size()) {
+        char last[BLOCK];
+        std::memset(last, ' ', BLOCK);
+        std::memcpy(last, text.data() + whole, text.size() - whole);
+        consumeBlock(classifyScalar(last), state, whole, positions);
+    }
+    positions.resize(state.count);
+    return state.inString == 0;
+}
+
+// --- AVX2 versions (two 32-byte vectors per block) ---
+#if MEGALADON_X86_SIMD
+
+MEGALADON_TARGET_AVX2 inline uint64_t maskOf(__m256i low, __m256i high) {
+    return static_cast<uint32_t>(_mm256_movemask_epi8(low)) |
+           static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(high))) << 32;
+}
+
+MEGALADON_TARGET_AVX2 inline __m256i equalTo(__m256i bytes, char c) {
+    return _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(c));
+}
+
+MEGALADON_TARGET_AVX2 inline __m256i operatorsOf(__m256i bytes) {
+    // Setting bit 5 turns '[' and ']' into '{' and '}', so four compares find all six
+    __m256i folded = _mm256_or_si256(bytes, _mm256_set1_epi8(0x20));
+    return _mm256_or_si256(_mm256_or_si256(equalTo(folded, '{'), equalTo(folded, '}')),
+                           _mm256_or_si256(equalTo(bytes, ':'), equalTo(bytes, ',')));
+}
+
+MEGALADON_TARGET_AVX2 inline __m256i whitespaceOf(__m256i bytes) {
+    return _mm256_or_si256(_mm256_or_si256(equalTo(bytes, ' '), equalTo(bytes, '\t')),
+                           _mm256_or_si256(equalTo(bytes, '\n'), equalTo(bytes, '\r')));
+}
+
+MEGALADON_TARGET_AVX2 inline BlockMasks classifyAvx2(const char* block) {
+    __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+    __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+    BlockMasks masks;
+    masks.quote = maskOf(equalTo(low, '"'), equalTo(high, '"'));
+    masks.backslash = maskOf(equalTo(low, '\\'), equalTo(high, '\\'));
+    masks.op = maskOf(operatorsOf(low), operatorsOf(high));
+    masks.whitespace = maskOf(whitespaceOf(low), whitespaceOf(high));
+    return masks;
+}
+
+MEGALADON_TARGET_AVX2 bool indexAvx2(std::string_view text, std::vector<uint32_t>& positions) {
+    ScanState state;
+    size_t whole = text.size() / BLOCK * BLOCK;
+    for (size_t base = 0; base < whole; base += BLOCK) {
+        consumeBlock(classifyAvx2(text.data() + base), state, base, positions);
+    }
+    if (whole < text.size()) {
+        char last[BLOCK];
+        std::memset(last, ' ', BLOCK);
+        std::memcpy(last, text.data() + whole, text.size() - whole);
+        consumeBlock(classifyAvx2(last), state, whole, positions);
+    }
+    positions.resize(state.count);
+    return state.inString == 0;
+}
+
+MEGALADON_TARGET_AVX2 size_t findSpecialAvx2(std::string_view text, size_t from) {
+    const char* data = text.data();
+    size_t n = text.size();
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i control = _mm256_set1_epi8(0x1F);
+    size_t i = from;
+    for (; i + 32 <= n; i += 32) {
+        __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        // max(c, 0x1F) == 0x1F exactly for the (unsigned) bytes below 0x20
+        __m256i special = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(bytes, quote), _mm256_cmpeq_epi8(bytes, backslash)),
+                                          _mm256_cmpeq_epi8(_mm256_max_epu8(bytes, control), control));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(special));
+        if (mask != 0) return i + static_cast<size_t>(__builtin_ctz(mask));
+    }
+    return findSpecialScalar(text, i);
+}
+
+#endif
+
+} // namespace
+
+bool jsonStructuralIndex(std::string_view text, std::vector<uint32_t>& positions) {
+    positions.clear();
+    positions.resize(text.size() / 8 + BLOCK); // Typical documents have a structural every few bytes
+#if MEGALADON_X86_SIMD
+    if (useAvx2()) return indexAvx2(text, positions);
+#endif
+    return indexScalar(text, positions);
+}
+
+size_t jsonFindSpecial(std::string_view text, size_t from) {
+#if MEGALADON_X86_SIMD
+    if (useAvx2() && text.size() - from >= 32) return findSpecialAvx2(text, from);
+#endif
+    return findSpecialScalar(text, from);
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>     // For size_t
+#include <cstdint>     // For uint32_t
+#include <string_view>
+#include <vector>
+
+// Kernels for the JSON builtins. Like the string kernels, each picks an AVX2
+// implementation at runtime when the CPU supports it and falls back to a
+// portable loop otherwise.
+
+// Largest text the structural index can address
+constexpr size_t JSON_MAX_TEXT = 0xFFFFFFFFu;
+
+// Stage one of a simdjson-style parse: appends to 'positions', in order, the
+// offset of every structural character ({ } [ ] : ,) outside strings, of every
+// string's opening quote and of the first byte of every other scalar (number,
+// true, false, null). Escaped quotes are told apart from closing ones and the
+// contents of strings never appear. Text is classified 64 bytes at a time into
+// bit masks, so the work per byte is a handful of vector compares and integer
+// operations, with no branch on the data.
+// Returns false if the text ends inside a string. 'text' must be at most
+// JSON_MAX_TEXT bytes.
+bool jsonStructuralIndex(std::string_view text, std::vector<uint32_t>& positions);
+
+// Offset of the first byte at or after 'from' that ends a plain run inside a
+// JSON string: '"', '\\' or a control character below 0x20. text.size() if
+// there is none.
+size_t jsonFindSpecial(std::string_view text, size_t from);
@@ -0,0 +1,20 @@
+#include "number_format.h"
+#include <charconv>  // For std::to_chars
+#include <cmath>     // For std::fabs, std::trunc
+#include <algorithm> // For std::min
+
+void appendNumber(std::string& out, double number, int precision) {
+    // Fixed notation of a double up to 1e308 with 17 decimals fits comfortably
+    char buffer[352];
+    std::to_chars_result result;
+    if (precision >= 0) {
+        result = std::to_chars(buffer, buffer + sizeof(buffer), number, std::chars_format::fixed,
+                               std::min(precision, MAX_NUMBER_PRECISION));
+    } else if (std::trunc(number) == number && std::fabs(number) < 9007199254740992.0) {
+        // Exact integers; also keeps "-0" as "0"
+        result = std::to_chars(buffer, buffer + sizeof(buffer), static_cast<long long>(number));
+    } else {
+        result = std::to_chars(buffer, buffer + sizeof(buffer), number);
+    }
+    out.append(buffer, result.ptr);
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <string>
+
+// Appends 'number' to 'out' without building a temporary string.
+// Integral values below 2^53 print as integers ("3", not "3.0"). Other values
+// use the shortest digits that read back as the same double ("0.1", "1e+300"),
+// or exactly 'precision' digits after the point when precision >= 0.
+void appendNumber(std::string& out, double number, int precision = -1);
+
+// Largest precision appendNumber accepts; larger requests are clamped
+constexpr int MAX_NUMBER_PRECISION = 17;
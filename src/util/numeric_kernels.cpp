@@ -0,0 +1,472 @@
+#include "numeric_kernels.h"
+#include "cpu_features.h"
+#include "thread_pool.h"
+#include <algorithm> // For std::min, std::max, std::fill
+#include <limits>    // For std::numeric_limits
+#include <vector>
+
+#if MEGALADON_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// --- Portable scalar versions ---
+
+template <ArithmeticOp Op>
+inline double applyOp(double x, double y) {
+    switch (Op) {
+        case ArithmeticOp::ADD: return x + y;
+        case ArithmeticOp::SUBTRACT: return x - y;
+        case ArithmeticOp::MULTIPLY: return x * y;
+        case ArithmeticOp::DIVIDE: return x / y;
+    }
+    return 0.0;
+}
+
+template <CompareOp Op>
+inline bool compareOp(double x, double y) {
+    switch (Op) {
+        case CompareOp::LESS: return x < y;
+        case CompareOp::LESS_EQUAL: return x <= y;
+        case CompareOp::GREATER: return x > y;
+        case CompareOp::GREATER_EQUAL: return x >= y;
+        case CompareOp::EQUAL: return x == y;
+        case CompareOp::NOT_EQUAL: return x != y;
+    }
+    return false;
+}
+
+template <ArithmeticOp Op>
+void arithmeticScalar(const double* a, const double* b, double* out, size_t from, size_t n) {
+    for (size_t i = from; i < n; ++i) out[i] = applyOp<Op>(a[i], b[i]);
+}
+
+template <ArithmeticOp Op>
+void arithmeticBroadcastScalar(const double* a, double s, bool left, double* out, size_t from, size_t n) {
+    for (size_t i = from; i < n; ++i) out[i] = left ? applyOp<Op>(s, a[i]) : applyOp<Op>(a[i], s);
+}
+
+template <CompareOp Op>
+void compareScalar(const double* a, const double* b, double* out, size_t from, size_t n) {
+    for (size_t i = from; i < n; ++i) out[i] = compareOp<Op>(a[i], b[i]) ? 1.0 : 0.0;
+}
+
+template <CompareOp Op>
+void compareBroadcastScalar(const double* a, double s, bool left, double* out, size_t from, size_t n) {
+    for (size_t i = from; i < n; ++i) out[i] = (left ? compareOp<Op>(s, a[i]) : compareOp<Op>(a[i], s)) ? 1.0 : 0.0;
+}
+
+// Smallest (or largest) of a[from..n) and 'result'. Any NaN makes the result
+// NaN, on this path and the AVX2 one alike.
+template <bool IsMin>
+double extremumScalar(const double* a, double result, size_t from, size_t n) {
+    bool sawNaN = result != result;
+    for (size_t i = from; i < n; ++i) {
+        double x = a[i];
+        sawNaN |= x != x;
+        result = IsMin ? (x < result ? x : result) : (x > result ? x : result);
+    }
+    return sawNaN ? std::numeric_limits<double>::quiet_NaN() : result;
+}
+
+// --- AVX2 versions (4 doubles per vector) ---
+#if MEGALADON_X86_SIMD
+
+template <ArithmeticOp Op>
+MEGALADON_TARGET_AVX2 inline __m256d applyAvx2(__m256d x, __m256d y) {
+    switch (Op) {
+        case ArithmeticOp::ADD: return _mm256_add_pd(x, y);
+        case ArithmeticOp::SUBTRACT: return _mm256_sub_pd(x, y);
+        case ArithmeticOp::MULTIPLY: return _mm256_mul_pd(x, y);
+        case ArithmeticOp::DIVIDE: return _mm256_div_pd(x, y);
+    }
+    return x;
+}
+
+template <CompareOp Op>
+MEGALADON_TARGET_AVX2 inline __m256d compareAvx2(__m256d x, __m256d y) {
+    // Ordered predicates are false for NaN, like the C++ operators; != is unordered
+    switch (Op) {
+        case CompareOp::LESS: return _mm256_cmp_pd(x, y, _CMP_LT_OQ);
+        case CompareOp::LESS_EQUAL: return _mm256_cmp_pd(x, y, _CMP_LE_OQ);
+        case CompareOp::GREATER: return _mm256_cmp_pd(x, y, _CMP_GT_OQ);
+        case CompareOp::GREATER_EQUAL: return _mm256_cmp_pd(x, y, _CMP_GE_OQ);
+        case CompareOp::EQUAL: return _mm256_cmp_pd(x, y, _CMP_EQ_OQ);
+        case CompareOp::NOT_EQUAL: return _mm256_cmp_pd(x, y, _CMP_NEQ_UQ);
+    }
+    return x;
+}
+
+template <ArithmeticOp Op>
+MEGALADON_TARGET_AVX2 void arithmeticAvx2(const double* a, const double* b, double* out, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(out + i, applyAvx2<Op>(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+    }
+    arithmeticScalar<Op>(a, b, out, i, n);
+}
+
+template <ArithmeticOp Op>
+MEGALADON_TARGET_AVX2 void arithmeticBroadcastAvx2(const double* a, double s, bool left, double* out, size_t n) {
+    __m256d scalar = _mm256_set1_pd(s);
+    size_t i = 0;
+    if (left) {
+        for (; i + 4 <= n; i += 4) _mm256_storeu_pd(out + i, applyAvx2<Op>(scalar, _mm256_loadu_pd(a + i)));
+    } else {
+        for (; i + 4 <= n; i += 4) _mm256_storeu_pd(out + i, applyAvx2<Op>(_mm256_loadu_pd(a + i), scalar));
+    }
+    arithmeticBroadcastScalar<Op>(a, s, left, out, i, n);
+}
+
+template <CompareOp Op>
+MEGALADON_TARGET_AVX2 void compareAvx2Loop(const double* a, const double* b, double* out, size_t n) {
+    const __m256d ones = _mm256_set1_pd(1.0);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d mask = compareAvx2<Op>(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i));
+        _mm256_storeu_pd(out + i, _mm256_and_pd(mask, ones));
+    }
+    compareScalar<Op>(a, b, out, i, n);
+}
+
+template <CompareOp Op>
+MEGALADON_TARGET_AVX2 void compareBroadcastAvx2(const double* a, double s, bool left, double* out, size_t n) {
+    const __m256d ones = _mm256_set1_pd(1.0);
+    __m256d scalar = _mm256_set1_pd(s);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d x = _mm256_loadu_pd(a + i);
+        __m256d mask = left ? compareAvx2<Op>(scalar, x) : compareAvx2<Op>(x, scalar);
+        _mm256_storeu_pd(out + i, _mm256_and_pd(mask, ones));
+    }
+    compareBroadcastScalar<Op>(a, s, left, out, i, n);
+}
+
+MEGALADON_TARGET_AVX2 inline double horizontalSum(__m256d v) {
+    __m128d low = _mm256_castpd256_pd128(v);
+    __m128d high = _mm256_extractf128_pd(v, 1);
+    low = _mm_add_pd(low, high);
+    return _mm_cvtsd_f64(_mm_add_sd(low, _mm_unpackhi_pd(low, low)));
+}
+
+MEGALADON_TARGET_AVX2 double sumAvx2(const double* a, size_t n) {
+    // Four independent accumulators hide the add latency
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    __m256d acc2 = _mm256_setzero_pd(), acc3 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm256_add_pd(acc0, _mm256_loadu_pd(a + i));
+        acc1 = _mm256_add_pd(acc1, _mm256_loadu_pd(a + i + 4));
+        acc2 = _mm256_add_pd(acc2, _mm256_loadu_pd(a + i + 8));
+        acc3 = _mm256_add_pd(acc3, _mm256_loadu_pd(a + i + 12));
+    }
+    for (; i + 4 <= n; i += 4) acc0 = _mm256_add_pd(acc0, _mm256_loadu_pd(a + i));
+    double total = horizontalSum(_mm256_add_pd(_mm256_add_pd(acc0, acc1), _mm256_add_pd(acc2, acc3)));
+    for (; i < n; ++i) total += a[i];
+    return total;
+}
+
+MEGALADON_TARGET_AVX2 double dotAvx2(const double* a, const double* b, size_t n) {
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), acc0);
+        acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4), acc1);
+    }
+    for (; i + 4 <= n; i += 4) acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), acc0);
+    double total = horizontalSum(_mm256_add_pd(acc0, acc1));
+    for (; i < n; ++i) total += a[i] * b[i];
+    return total;
+}
+
+template <bool IsMin>
+MEGALADON_TARGET_AVX2 double extremumAvx2(const double* a, size_t n) {
+    if (n < 4) return extremumScalar<IsMin>(a, a[0], 1, n);
+    // vminpd/vmaxpd return their second operand when either is NaN, so a NaN
+    // could be dropped again by a later element; NaNs are tracked on the side
+    __m256d acc = _mm256_loadu_pd(a);
+    __m256d nan = _mm256_cmp_pd(acc, acc, _CMP_UNORD_Q);
+    size_t i = 4;
+    for (; i + 4 <= n; i += 4) {
+        __m256d x = _mm256_loadu_pd(a + i);
+        nan = _mm256_or_pd(nan, _mm256_cmp_pd(x, x, _CMP_UNORD_Q));
+        acc = IsMin ? _mm256_min_pd(acc, x) : _mm256_max_pd(acc, x);
+    }
+    if (_mm256_movemask_pd(nan) != 0) return std::numeric_limits<double>::quiet_NaN();
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, acc);
+    double result = extremumScalar<IsMin>(lanes, lanes[0], 1, 4);
+    return extremumScalar<IsMin>(a, result, i, n);
+}
+
+#endif // MEGALADON_X86_SIMD
+
+bool useAvx2() {
+#if MEGALADON_X86_SIMD
+    static const bool available = CpuFeatures::get().avx2 && CpuFeatures::get().fma;
+    return available;
+#else
+    return false;
+#endif
+}
+
+template <ArithmeticOp Op>
+void dispatchArithmetic(const double* a, const double* b, double* out, size_t n) {
+#if MEGALADON_X86_SIMD
+    if (useAvx2()) return arithmeticAvx2<Op>(a, b, out, n);
+#endif
+    arithmeticScalar<Op>(a, b, out, 0, n);
+}
+
+template <ArithmeticOp Op>
+void dispatchArithmeticScalar(const double* a, double s, bool left, double* out, size_t n) {
+#if MEGALADON_X86_SIMD
+    if (useAvx2()) return arithmeticBroadcastAvx2<Op>(a, s, left, out, n);
+#endif
+    arithmeticBroadcastScalar<Op>(a, s, left, out, 0, n);
+}
+
+template <CompareOp Op>
+void dispatchCompare(const double* a, const double* b, double* out, size_t n) {
+#if MEGALADON_X86_SIMD
+    if (useAvx2()) return compareAvx2Loop<Op>(a, b, out, n);
+#endif
+    compareScalar<Op>(a, b, out, 0, n);
+}
+
+template <CompareOp Op>
+void dispatchCompareScalar(const double* a, double s, bool left, double* out, size_t n) {
+#if MEGALADON_X86_SIMD
+    if (useAvx2()) return compareBroadcastAvx2<Op>(a, s, left, out, n);
+#endif
+    compareBroadcastScalar<Op>(a, s, left, out, 0, n);
+}
+
+} // namespace
+
+void kernelArithmetic(ArithmeticOp op, const double* a, const double* b, double* out, size_t n) {
+    switch (op) {
+        case ArithmeticOp::ADD: return dispatchArithmetic<ArithmeticOp::ADD>(a, b, out, n);
+        case ArithmeticOp::SUBTRACT: return dispatchArithmetic<ArithmeticOp::SUBTRACT>(a, b, out, n);
+        case ArithmeticOp::MULTIPLY: return dispatchArithmetic<ArithmeticOp::MULTIPLY>(a, b, out, n);
+        case ArithmeticOp::DIVIDE: return dispatchArithmetic<ArithmeticOp::DIVIDE>(a, b, out, n);
+    }
+}
+
+void kernelArithmeticScalar(ArithmeticOp op, const double* a, double scalar, bool scalarOnLeft, double* out, size_t n) {
+    switch (op) {
+        case ArithmeticOp::ADD: return dispatchArithmeticScalar<ArithmeticOp::ADD>(a, scalar, scalarOnLeft, out, n);
+        case ArithmeticOp::SUBTRACT: return dispatchArithmeticScalar<ArithmeticOp::SUBTRACT>(a, scalar, scalarOnLeft, out, n);
+        case ArithmeticOp::MULTIPLY: return dispatchArithmeticScalar<ArithmeticOp::MULTIPLY>(a, scalar, scalarOnLeft, out, n);
+        case ArithmeticOp::DIVIDE: return dispatchArithmeticScalar<ArithmeticOp::DIVIDE>(a, scalar, scalarOnLeft, out, n);
+    }
+}
+
+void kernelCompare(CompareOp op, const double* a, const double* b, double* out, size_t n) {
+    switch (op) {
+        case CompareOp::LESS: return dispatchCompare<CompareOp::LESS>(a, b, out, n);
+        case CompareOp::LESS_EQUAL: return dispatchCompare<CompareOp::LESS_EQUAL>(a, b, out, n);
+        case CompareOp::GREATER: return dispatchCompare<CompareOp::GREATER>(a, b, out, n);
+        case CompareOp::GREATER_EQUAL: return dispatchCompare<CompareOp::GREATER_EQUAL>(a, b, out, n);
+        case CompareOp::EQUAL: return dispatchCompare<CompareOp::EQUAL>(a, b, out, n);
+        case CompareOp::NOT_EQUAL: return dispatchCompare<CompareOp::NOT_EQUAL>(a, b, out, n);
+    }
+}
+
+void kernelCompareScalar(CompareOp op, const double* a, double scalar, bool scalarOnLeft, double* out, size_t n) {
+    switch (op) {
+        case CompareOp::LESS: return dispatchCompareScalar<CompareOp::LESS>(a, scalar, scalarOnLeft, out, n);
+        case CompareOp::LESS_EQUAL: return dispatchCompareScalar<CompareOp::LESS_EQUAL>(a, scalar, scalarOnLeft, out, n);
+        case CompareOp::GREATER: return dispatchCompareScalar<CompareOp::GREATER>(a, scalar, scalarOnLeft, out, n);
+        case CompareOp::GREATER_EQUAL: return dispatchCompareScalar<CompareOp::GREATER_EQUAL>(a, scalar, scalarOnLeft, out, n);
+        case CompareOp::EQUAL: return dispatchCompareScalar<CompareOp::EQUAL>(a, scalar, scalarOnLeft, out, n);
+        case CompareOp::NOT_EQUAL: return dispatchCompareScalar<CompareOp::NOT_EQUAL>(a, scalar, scalarOnLeft, out, n);
+    }
+}
+
+double kernelSum(const double* a, size_t n) {
+#if MEGALADON_X86_SIMD
+    if (useAvx2()) return sumAvx2(a, n);
+#endif
+    double total = 0.0;
+    for (size_t i = 0; i < n; ++i) total += a[i];
+    return total;
+}
+
+double kernelMin(const double* a, size_t n) {
+#if MEGALADON_X86_SIMD
+    if (useAvx2()) return extremumAvx2<true>(a, n);
+#endif
+    return extremumScalar<true>(a, a[0], 1, n);
+}
+
+double kernelMax(const double* a, size_t n) {
+#if MEGALADON_X86_SIMD
+    if (useAvx2()) return extremumAvx2<false>(a, n);
+#endif
+    return extremumScalar<false>(a, a[0], 1, n);
+}
+
+double kernelDot(const double* a, const double* b, size_t n) {
+#if MEGALADON_X86_SIMD
+    if (useAvx2()) return dotAvx2(a, b, n);
+#endif
+    double total = 0.0;
+    for (size_t i = 0; i < n; ++i) total += a[i] * b[i];
+    return total;
+}
+
+// --- Matrix kernels ---
+// Matmul follows the usual BLIS layout: a KC x NR panel of b (16 KB) stays in L1
+// while it is multiplied with every MR-row strip of an MC x KC block of a (which
+// stays in L2), and the packed KC x NC block of b is reused from L3 by all row blocks.
+
+namespace {
+constexpr size_t MR = 4;    // Rows of c per micro-kernel call
+constexpr size_t NR = 8;    // Columns of c per micro-kernel call (two AVX2 vectors)
+constexpr size_t KC = 256;
+constexpr size_t MC = 64;
+constexpr size_t NC = 2048;
+
+using MicroKernel = void (*)(const double* a, size_t lda, const double* panel, size_t kc,
+                             double* c, size_t ldc, size_t rows, size_t cols);
+
+// Copies b[pc .. pc+kc) x [jc .. jc+nc) into NR-column panels, each kc rows of NR
+// values, zero-padding the last panel
+void packPanels(const double* b, size_t n, size_t pc, size_t kc, size_t jc, size_t nc, double* packed) {
+    for (size_t jr = 0; jr < nc; jr += NR) {
+        size_t cols = std::min(NR, nc - jr);
+        double* panel = packed + (jr / NR) * kc * NR;
+        for (size_t p = 0; p < kc; ++p) {
+            const double* row = b + (pc + p) * n + jc + jr;
+            size_t j = 0;
+            for (; j < cols; ++j) panel[p * NR + j] = row[j];
+            for (; j < NR; ++j) panel[p * NR + j] = 0.0;
+        }
+    }
+}
+
+// c[rows x cols] += a[rows x kc] * panel
+void microKernelScalar(const double* a, size_t lda, const double* panel, size_t kc,
+                       double* c, size_t ldc, size_t rows, size_t cols) {
+    double acc[MR][NR] = {};
+    for (size_t p = 0; p < kc; ++p) {
+        const double* bp = panel + p * NR;
+        for (size_t i = 0; i < rows; ++i) {
+            double x = a[i * lda + p];
+            for (size_t j = 0; j < NR; ++j) acc[i][j] += x * bp[j];
+        }
+    }
+    for (size_t i = 0; i < rows; ++i) {
+        for (size_t j = 0; j < cols; ++j) c[i * ldc + j] += acc[i][j];
+    }
+}
+
+#if MEGALADON_X86_SIMD
+// 4 x 8 tile of c in eight registers; each step broadcasts one element of each
+// row of a and does eight FMAs against two vectors of the panel
+MEGALADON_TARGET_AVX2 void microKernelAvx2(const double* a, size_t lda, const double* panel, size_t kc,
+                                           double* c, size_t ldc, size_t rows, size_t cols) {
+    if (rows < MR) {
+        microKernelScalar(a, lda, panel, kc, c, ldc, rows, cols);
+        return;
+    }
+    const double* a0 = a;
+    const double* a1 = a + lda;
+    const double* a2 = a + 2 * lda;
+    const double* a3 = a + 3 * lda;
+    __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+    __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+    __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+    __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+    for (size_t p = 0; p < kc; ++p) {
+        __m256d b0 = _mm256_loadu_pd(panel + p * NR);
+        __m256d b1 = _mm256_loadu_pd(panel + p * NR + 4);
+        __m256d x = _mm256_broadcast_sd(a0 + p);
+        c00 = _mm256_fmadd_pd(x, b0, c00);
+        c01 = _mm256_fmadd_pd(x, b1, c01);
+        x = _mm256_broadcast_sd(a1 + p);
+        c10 = _mm256_fmadd_pd(x, b0, c10);
+        c11 = _mm256_fmadd_pd(x, b1, c11);
+        x = _mm256_broadcast_sd(a2 + p);
+        c20 = _mm256_fmadd_pd(x, b0, c20);
+        c21 = _mm256_fmadd_pd(x, b1, c21);
+        x = _mm256_broadcast_sd(a3 + p);
+        c30 = _mm256_fmadd_pd(x, b0, c30);
+        c31 = _mm256_fmadd_pd(x, b1, c31);
+    }
+    alignas(32) double tile[MR][NR];
+    _mm256_store_pd(tile[0], c00);
+    _mm256_store_pd(tile[0] + 4, c01);
+    _mm256_store_pd(tile[1], c10);
+    _mm256_store_pd(tile[1] + 4, c11);
+    _mm256_store_pd(tile[2], c20);
+    _mm256_store_pd(tile[2] + 4, c21);
+    _mm256_store_pd(tile[3], c30);
+    _mm256_store_pd(tile[3] + 4, c31);
+    for (size_t i = 0; i < MR; ++i) {
+        double* row = c + i * ldc;
+        if (cols == NR) {
+            _mm256_storeu_pd(row, _mm256_add_pd(_mm256_loadu_pd(row), _mm256_load_pd(tile[i])));
+            _mm256_storeu_pd(row + 4, _mm256_add_pd(_mm256_loadu_pd(row + 4), _mm256_load_pd(tile[i] + 4)));
+        } else {
+            for (size_t j = 0; j < cols; ++j) row[j] += tile[i][j];
+        }
+    }
+}
+#endif
+} // namespace
+
+void kernelMatmul(const double* a, const double* b, double* c, size_t m, size_t k, size_t n, ThreadPool* pool) {
+    std::fill(c, c + m * n, 0.0);
+    if (m == 0 || n == 0 || k == 0) return;
+
+    MicroKernel micro = microKernelScalar;
+#if MEGALADON_X86_SIMD
+    if (useAvx2()) micro = microKernelAvx2;
+#endif
+    size_t panelColumns = (std::min(NC, n) + NR - 1) / NR * NR;
+    std::vector<double> packed(std::min(KC, k) * panelColumns);
+    size_t rowBlocks = (m + MC - 1) / MC;
+    // Below roughly a million multiply-adds, waking the workers costs more than it saves
+    bool parallel = pool && pool->size() > 1 && rowBlocks > 1 && m * n * k >= (size_t(1) << 20);
+
+    for (size_t jc = 0; jc < n; jc += NC) {
+        size_t nc = std::min(NC, n - jc);
+        for (size_t pc = 0; pc < k; pc += KC) {
+            size_t kc = std::min(KC, k - pc);
+            packPanels(b, n, pc, kc, jc, nc, packed.data());
+            auto multiplyRows = [&](size_t firstBlock, size_t lastBlock) {
+                for (size_t ic = firstBlock * MC; ic < std::min(m, lastBlock * MC); ic += MC) {
+                    size_t mc = std::min(MC, m - ic);
+                    for (size_t jr = 0; jr < nc; jr += NR) {
+                        const double* panel = packed.data() + (jr / NR) * kc * NR;
+                        for (size_t ir = 0; ir < mc; ir += MR) {
+                            micro(a + (ic + ir) * k + pc, k, panel, kc, c + (ic + ir) * n + jc + jr, n,
+                                  std::min(MR, mc - ir), std::min(NR, nc - jr));
+                        }
+                    }
+                }
+            };
+            if (parallel) {
+                pool->parallelFor(rowBlocks, 1, multiplyRows);
+            } else {
+                multiplyRows(0, rowBlocks);
+            }
+        }
+    }
+}
+
+void kernelTranspose(const double* a, double* out, size_t rows, size_t cols) {
+    constexpr size_t TILE = 32; // Two 8 KB tiles, both in L1
+    for (size_t i0 = 0; i0 < rows; i0 += TILE) {
+        size_t i1 = std::min(rows, i0 + TILE);
+        for (size_t j0 = 0; j0 < cols; j0 += TILE) {
+            size_t j1 = std::min(cols, j0 + TILE);
+            for (size_t i = i0; i < i1; ++i) {
+                for (size_t j = j0; j < j1; ++j) out[j * rows + i] = a[i * cols + j];
+            }
+        }
+    }
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef> // For size_t
+
+class ThreadPool; // thread_pool.h
+
+// Element-wise and reduction kernels over contiguous doubles.
+// Each kernel picks an AVX2 implementation at runtime when the CPU supports it
+// and falls back to a portable loop otherwise.
+
+enum class ArithmeticOp { ADD, SUBTRACT, MULTIPLY, DIVIDE };
+enum class CompareOp { LESS, LESS_EQUAL, GREATER, GREATER_EQUAL, EQUAL, NOT_EQUAL };
+
+// out[i] = a[i] op b[i]
+void kernelArithmetic(ArithmeticOp op, const double* a, const double* b, double* out, size_t n);
+// out[i] = a[i] op scalar, or scalar op a[i] when 'scalarOnLeft'
+void kernelArithmeticScalar(ArithmeticOp op, const double* a, double scalar, bool scalarOnLeft, double* out, size_t n);
+
+// out[i] = (a[i] op b[i]) ? 1.0 : 0.0
+void kernelCompare(CompareOp op, const double* a, const double* b, double* out, size_t n);
+// out[i] = (a[i] op scalar) ? 1.0 : 0.0, operands swapped when 'scalarOnLeft'
+void kernelCompareScalar(CompareOp op, const double* a, double scalar, bool scalarOnLeft, double* out, size_t n);
+
+double kernelSum(const double* a, size_t n);
+// n must be > 0. NaN if any element is NaN, whichever path runs.
+double kernelMin(const double* a, size_t n);
+double kernelMax(const double* a, size_t n);
+double kernelDot(const double* a, const double* b, size_t n);
+
+// c = a * b for row-major a (m x k), b (k x n) and c (m x n). Cache-blocked with
+// packed panels of b; blocks of rows are spread over 'pool' when one is given.
+void kernelMatmul(const double* a, const double* b, double* c, size_t m, size_t k, size_t n, ThreadPool* pool = nullptr);
+// out (cols x rows) = transpose of row-major a (rows x cols), one cache-sized tile at a time
+void kernelTranspose(const double* a, double* out, size_t rows, size_t cols);
@@ -0,0 +1,149 @@
+#include "output_buffer.h"
+#include <chrono>
+#include <cstdio> // For std::fflush, std::fwrite
+#include <ctime>  // For clock_gettime
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>     // For errno, EINTR
+#include <sys/uio.h>  // For writev
+#include <unistd.h>   // For isatty
+#define MEGALADON_HAS_WRITEV 1
+#else
+#define MEGALADON_HAS_WRITEV 0
+#endif
+
+namespace {
+// Read at the end of every line, so it has to be cheap: the coarse clock costs
+// a few nanoseconds against tens for steady_clock, and its few milliseconds of
+// resolution are plenty for FLUSH_INTERVAL_MS
+uint64_t monotonicMillis() {
+#ifdef CLOCK_MONOTONIC_COARSE
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000 + static_cast<uint64_t>(now.tv_nsec) / 1000000;
+#else
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(now).count());
+#endif
+}
+} // namespace
+
+OutputBuffer::OutputBuffer(int fd) : fd(fd), lastWrite(monotonicMillis()) {
+#if MEGALADON_HAS_WRITEV
+    interactive = isatty(fd) != 0;
+#else
+    interactive = true; // Without a way to tell, keep lines prompt
+#endif
+    pending.reserve(FLUSH_SIZE + FLUSH_SIZE / 4); // Room for the line that crosses FLUSH_SIZE
+}
+
+OutputBuffer::~OutputBuffer() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_one();
+    if (flusher.joinable()) flusher.join();
+    flush();
+}
+
+OutputBuffer& OutputBuffer::standardOutput() {
+    static OutputBuffer buffer(1);
+    return buffer;
+}
+
+void OutputBuffer::endLine(bool wasEmpty) {
+    pending.push_back('\n');
+    if (interactive || pending.size() >= FLUSH_SIZE || monotonicMillis() - lastWrite >= FLUSH_INTERVAL_MS) {
+        flushLocked();
+        return;
+    }
+    // The text waits for more lines; the flusher writes it if none come in time
+    if (!flusher.joinable()) {
+        flusher = std::thread([this] { flusherLoop(); });
+    } else if (wasEmpty) {
+        wake.notify_one();
+    }
+}
+
+void OutputBuffer::writeLine(std::string_view line) {
+    if (line.size() < FLUSH_SIZE) {
+        appendLine([line](std::string& text) { text.append(line); });
+        return;
+    }
+    std::lock_guard<std::mutex> guard(lock);
+    std::fflush(stdout);
+    writeAll(pending, line, "\n");
+    pending.clear();
+    lastWrite = monotonicMillis();
+}
+
+void OutputBuffer::flush() {
+    std::lock_guard<std::mutex> guard(lock);
+    flushLocked();
+}
+
+void OutputBuffer::flushLocked() {
+    // Text already sitting in stdio's buffer goes first. Code that writes through
+    // std::cout as well (the REPL prompt) flushes this buffer before it does.
+    std::fflush(stdout);
+    if (!pending.empty()) {
+        writeAll(pending);
+        pending.clear();
+    }
+    lastWrite = monotonicMillis();
+}
+
+// Sleeps while nothing is pending; otherwise writes the text once it has
+// waited FLUSH_INTERVAL_MS since the last write
+void OutputBuffer::flusherLoop() {
+    std::unique_lock<std::mutex> guard(lock);
+    while (!stopping) {
+        if (pending.empty()) {
+            wake.wait(guard);
+            continue;
+        }
+        uint64_t now = monotonicMillis();
+        if (now - lastWrite >= FLUSH_INTERVAL_MS) {
+            flushLocked();
+            continue;
+        }
+        wake.wait_for(guard, std::chrono::milliseconds(lastWrite + FLUSH_INTERVAL_MS - now));
+    }
+}
+
+void OutputBuffer::writeAll(std::string_view first, std::string_view second, std::string_view third) {
+#if MEGALADON_HAS_WRITEV
+    iovec pieces[3];
+    int count = 0;
+    for (std::string_view piece : {first, second, third}) {
+        if (piece.empty()) continue;
+        pieces[count].iov_base = const_cast<char*>(piece.data());
+        pieces[count].iov_len = piece.size();
+        ++count;
+    }
+    iovec* next = pieces;
+    while (count > 0) {
+        ssize_t written = ::writev(fd, next, count);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return; // The output is gone (closed pipe, full disk); drop the text like std::cout would
+        }
+        size_t left = static_cast<size_t>(written);
+        while (count > 0 && left >= next->iov_len) {
+            left -= next->iov_len;
+            ++next;
+            --count;
+        }
+        if (count > 0) {
+            next->iov_base = static_cast<char*>(next->iov_base) + left;
+            next->iov_len -= left;
+        }
+    }
+#else
+    FILE* stream = fd == 2 ? stderr : stdout;
+    for (std::string_view piece : {first, second, third}) {
+        std::fwrite(piece.data(), 1, piece.size(), stream);
+    }
+    std::fflush(stream);
+#endif
+}
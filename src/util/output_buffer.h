@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef> // For size_t
+#include <condition_variable>
+#include <cstdint> // For uint64_t
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+// Buffered writer for the script's standard output. print formats values
+// straight into the pending text (MegaladonValue::appendTo), and the text
+// reaches the file descriptor in few, large writes instead of one stream
+// insertion per value and newline.
+//
+// When the descriptor is a terminal, every finished line is written at once.
+// Otherwise (a pipe or a file) the text is written when FLUSH_SIZE bytes are
+// pending, or once it has waited FLUSH_INTERVAL_MS since the last write: a line
+// ending that late writes it, and so does a flusher thread (started with the
+// first line left pending) while the script is busy in a long native call or
+// stops printing, so slow scripts still show progress. flush() writes
+// everything now; it runs before input is read, before runtime errors are
+// reported and at exit.
+class OutputBuffer {
+public:
+    static constexpr size_t FLUSH_SIZE = 64 * 1024;
+    static constexpr uint64_t FLUSH_INTERVAL_MS = 100;
+
+    explicit OutputBuffer(int fd);
+    ~OutputBuffer(); // Flushes
+
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+    // Appends one line: 'format(text)' appends its contents to the pending
+    // text, then the line is ended and the flush policy applied. The buffer is
+    // locked meanwhile, so the flusher thread only ever writes whole lines.
+    template <typename Format>
+    void appendLine(Format&& format) {
+        std::lock_guard<std::mutex> guard(lock);
+        bool wasEmpty = pending.empty();
+        format(pending);
+        endLine(wasEmpty);
+    }
+
+    // Writes 'line' and a newline. A line of FLUSH_SIZE bytes or more is
+    // written together with the pending text by one gathering write instead of
+    // being copied into the buffer.
+    void writeLine(std::string_view line);
+
+    void flush();
+
+    // The buffer in front of standard output, used by print
+    static OutputBuffer& standardOutput();
+
+private:
+    // The rest of appendLine(); 'wasEmpty' tells whether the line is the only pending text
+    void endLine(bool wasEmpty);
+    void flushLocked();
+    void flusherLoop();
+
+    // Writes the pieces in order, retrying short writes
+    void writeAll(std::string_view first, std::string_view second = {}, std::string_view third = {});
+
+    int fd;
+    bool interactive;
+    std::mutex lock; // Guards everything below, and the writes
+    std::string pending;
+    uint64_t lastWrite; // Milliseconds, from monotonicMillis()
+    std::condition_variable wake; // Tells the flusher that text is pending, or to stop
+    std::thread flusher;          // Only for non-interactive output, started on demand
+    bool stopping = false;
+};
@@ -0,0 +1,71 @@
+#include "sort_kernels.h"
+#include <cstring> // For std::memcpy
+#include <cmath>   // For std::isnan
+
+namespace {
+// Maps a double to an unsigned key with the same order: negative numbers have
+// all bits flipped, others only the sign bit. Every NaN becomes the largest key.
+inline uint64_t orderedKey(double value) {
+    if (std::isnan(value)) return UINT64_MAX;
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return (bits >> 63) ? ~bits : bits | (uint64_t(1) << 63);
+}
+
+inline double fromOrderedKey(uint64_t key, double nan) {
+    if (key == UINT64_MAX) return nan;
+    uint64_t bits = (key >> 63) ? key & ~(uint64_t(1) << 63) : ~key;
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// LSD radix sort of 'keys' by bytes, carrying 'payload' along when given
+template <typename Payload>
+void radixSort(std::vector<uint64_t>& keys, std::vector<Payload>* payload) {
+    size_t n = keys.size();
+    // All eight histograms in one pass over the keys
+    std::vector<size_t> counts(8 * 256, 0);
+    for (uint64_t key : keys) {
+        for (int b = 0; b < 8; ++b) counts[b * 256 + ((key >> (8 * b)) & 0xFF)]++;
+    }
+    std::vector<uint64_t> keyBuffer(n);
+    std::vector<Payload> payloadBuffer(payload ? n : 0);
+    for (int b = 0; b < 8; ++b) {
+        size_t* count = counts.data() + b * 256;
+        if (count[(keys[0] >> (8 * b)) & 0xFF] == n) continue; // Every key has the same byte here
+        size_t offset = 0;
+        for (int digit = 0; digit < 256; ++digit) {
+            size_t c = count[digit];
+            count[digit] = offset;
+            offset += c;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            size_t slot = count[(keys[i] >> (8 * b)) & 0xFF]++;
+            keyBuffer[slot] = keys[i];
+            if (payload) payloadBuffer[slot] = (*payload)[i];
+        }
+        keys.swap(keyBuffer);
+        if (payload) payload->swap(payloadBuffer);
+    }
+}
+} // namespace
+
+void radixSortDoubles(double* values, size_t n) {
+    if (n < 2) return;
+    double nan = 0.0;
+    std::vector<uint64_t> keys(n);
+    for (size_t i = 0; i < n; ++i) {
+        keys[i] = orderedKey(values[i]);
+        if (keys[i] == UINT64_MAX) nan = values[i];
+    }
+    radixSort<uint32_t>(keys, nullptr);
+    for (size_t i = 0; i < n; ++i) values[i] = fromOrderedKey(keys[i], nan);
+}
+
+void radixSortByKeys(const std::vector<double>& keys, std::vector<uint32_t>& order) {
+    if (order.size() < 2) return;
+    std::vector<uint64_t> ordered(order.size());
+    for (size_t i = 0; i < order.size(); ++i) ordered[i] = orderedKey(keys[order[i]]);
+    radixSort(ordered, &order);
+}
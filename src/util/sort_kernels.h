@@ -0,0 +1,76 @@
+#pragma once
+
+#include <algorithm> // For std::sort, std::stable_sort, std::merge
+#include <cstddef>   // For size_t
+#include <cstdint>   // For uint32_t
+#include <iterator>  // For std::make_move_iterator
+#include <vector>
+#include "thread_pool.h"
+
+// Sorts 'values' ascending with an LSD radix sort over their IEEE-754 bit
+// patterns: O(n), stable, and passes whose byte is the same for every value
+// (the high bytes of small integers, say) are skipped. -0 sorts before +0 and
+// NaNs sort last.
+void radixSortDoubles(double* values, size_t n);
+
+// The order radixSortDoubles sorts in, for comparison sorts and searches over
+// the same values: NaNs are equal to each other and greater than any number.
+inline bool lessNanLast(double a, double b) {
+    return a < b || (b != b && a == a);
+}
+
+// Sorts 'order' (indexes into 'keys') so keys[order[i]] ascend; ties keep their
+// order in 'order'. Used to sort elements by a key extracted once per element.
+void radixSortByKeys(const std::vector<double>& keys, std::vector<uint32_t>& order);
+
+// Lists shorter than this are sorted on the calling thread
+constexpr size_t PARALLEL_SORT_MIN = size_t(1) << 16;
+
+// Sorts 'items' by 'less'. Long inputs are cut into one run per pool thread,
+// the runs are sorted in parallel and then merged pairwise, each round of
+// merges also in parallel. 'less' must be safe to call from several threads.
+// With 'stable', equal items keep their relative order.
+template <typename T, typename Less>
+void parallelSort(std::vector<T>& items, Less less, bool stable, ThreadPool& pool = ThreadPool::shared()) {
+    size_t n = items.size();
+    auto sortRange = [&](T* first, T* last) {
+        if (stable) {
+            std::stable_sort(first, last, less);
+        } else {
+            std::sort(first, last, less);
+        }
+    };
+    if (n < PARALLEL_SORT_MIN || pool.size() == 1) {
+        sortRange(items.data(), items.data() + n);
+        return;
+    }
+
+    size_t runs = pool.size();
+    std::vector<size_t> bounds(runs + 1);
+    for (size_t r = 0; r <= runs; ++r) bounds[r] = n * r / runs;
+    pool.parallelFor(runs, 1, [&](size_t begin, size_t end) {
+        for (size_t r = begin; r < end; ++r) sortRange(items.data() + bounds[r], items.data() + bounds[r + 1]);
+    });
+
+    // Each round merges neighbouring runs from 'source' into 'target'. std::merge
+    // takes from the left run on ties, which keeps the result stable.
+    std::vector<T> buffer(n);
+    std::vector<T>* source = &items;
+    std::vector<T>* target = &buffer;
+    for (size_t width = 1; width < runs; width *= 2) {
+        size_t pairs = (runs + 2 * width - 1) / (2 * width);
+        pool.parallelFor(pairs, 1, [&](size_t begin, size_t end) {
+            for (size_t p = begin; p < end; ++p) {
+                size_t lo = bounds[p * 2 * width];
+                size_t mid = bounds[std::min(runs, p * 2 * width + width)];
+                size_t hi = bounds[std::min(runs, p * 2 * width + 2 * width)];
+                T* in = source->data();
+                std::merge(std::make_move_iterator(in + lo), std::make_move_iterator(in + mid),
+                           std::make_move_iterator(in + mid), std::make_move_iterator(in + hi),
+                           target->data() + lo, less);
+            }
+        });
+        std::swap(source, target);
+    }
+    if (source != &items) items = std::move(*source);
+}
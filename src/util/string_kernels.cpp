@@ -0,0 +1,153 @@
+#include "string_kernels.h"
+#include "cpu_features.h"
+#include <cstdint> // For uint32_t
+#include <cstring> // For std::memchr, std::memcmp
+
+#if MEGALADON_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace {
+
+bool useAvx2() {
+#if MEGALADON_X86_SIMD
+    static const bool available = CpuFeatures::get().avx2;
+    return available;
+#else
+    return false;
+#endif
+}
+
+// --- Portable scalar versions ---
+
+size_t findScalar(std::string_view haystack, std::string_view needle, size_t from) {
+    return haystack.find(needle, from);
+}
+
+// Flips bit 5 of every byte in [lo, lo + 26), which maps one ASCII case to the other
+void caseMapScalar(const char* in, char* out, size_t from, size_t n, unsigned char lo) {
+    for (size_t i = from; i < n; ++i) {
+        unsigned char c = static_cast<unsigned char>(in[i]);
+        out[i] = static_cast<char>(static_cast<unsigned char>(c - lo) < 26 ? c ^ 0x20 : c);
+    }
+}
+
+size_t countAnyOfScalar(const unsigned char* text, size_t from, size_t n, const bool (&member)[256]) {
+    size_t count = 0;
+    for (size_t i = from; i < n; ++i) count += member[text[i]];
+    return count;
+}
+
+// --- AVX2 versions (32 bytes per vector) ---
+#if MEGALADON_X86_SIMD
+
+// Compares the needle's first and last bytes against 32 candidate positions at
+// once; only positions where both match are checked in full (the "generic
+// SIMD" substring search). Skips most of a text that has no partial matches.
+MEGALADON_TARGET_AVX2 size_t findAvx2(std::string_view haystack, std::string_view needle, size_t from) {
+    const char* text = haystack.data();
+    size_t n = haystack.size();
+    size_t m = needle.size();
+    const __m256i first = _mm256_set1_epi8(needle.front());
+    const __m256i last = _mm256_set1_epi8(needle.back());
+    size_t i = from;
+    for (; i + m - 1 + 32 <= n; i += 32) {
+        __m256i blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i));
+        __m256i blockLast = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i + m - 1));
+        uint32_t candidates = static_cast<uint32_t>(_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(blockFirst, first), _mm256_cmpeq_epi8(blockLast, last))));
+        while (candidates != 0) {
+            size_t offset = static_cast<size_t>(__builtin_ctz(candidates));
+            if (std::memcmp(text + i + offset + 1, needle.data() + 1, m - 2) == 0) return i + offset;
+            candidates &= candidates - 1;
+        }
+    }
+    return findScalar(haystack, needle, i);
+}
+
+MEGALADON_TARGET_AVX2 void caseMapAvx2(const char* in, char* out, size_t n, unsigned char lo) {
+    // Adding 128 - lo moves [lo, lo + 26) to the bottom of the signed range,
+    // so one signed compare finds the letters
+    const __m256i shift = _mm256_set1_epi8(static_cast<char>(128 - lo));
+    const __m256i limit = _mm256_set1_epi8(static_cast<char>(-128 + 26));
+    const __m256i caseBit = _mm256_set1_epi8(0x20);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        __m256i letters = _mm256_cmpgt_epi8(limit, _mm256_add_epi8(bytes, shift));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                            _mm256_xor_si256(bytes, _mm256_and_si256(letters, caseBit)));
+    }
+    caseMapScalar(in, out, i, n, lo);
+}
+
+// One compare per member byte per 32 text bytes; used for small classes
+MEGALADON_TARGET_AVX2 size_t countAnyOfAvx2(std::string_view text, std::string_view bytes, const bool (&member)[256]) {
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(text.data());
+    size_t n = text.size();
+    __m256i targets[16];
+    for (size_t k = 0; k < bytes.size(); ++k) targets[k] = _mm256_set1_epi8(bytes[k]);
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i hits = _mm256_setzero_si256();
+        for (size_t k = 0; k < bytes.size(); ++k) {
+            hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(block, targets[k]));
+        }
+        count += static_cast<size_t>(__builtin_popcount(static_cast<uint32_t>(_mm256_movemask_epi8(hits))));
+    }
+    return count + countAnyOfScalar(data, i, n, member);
+}
+
+#endif // MEGALADON_X86_SIMD
+
+} // namespace
+
+size_t kernelFind(std::string_view haystack, std::string_view needle, size_t from) {
+    if (from > haystack.size() || needle.size() > haystack.size() - from) {
+        return needle.empty() && from == haystack.size() ? from : std::string_view::npos;
+    }
+    if (needle.empty()) return from;
+    if (needle.size() == 1) {
+        // memchr is already vectorized by the C library
+        const void* hit = std::memchr(haystack.data() + from, needle[0], haystack.size() - from);
+        return hit ? static_cast<size_t>(static_cast<const char*>(hit) - haystack.data()) : std::string_view::npos;
+    }
+#if MEGALADON_X86_SIMD
+    if (useAvx2()) return findAvx2(haystack, needle, from);
+#endif
+    return findScalar(haystack, needle, from);
+}
+
+size_t kernelCount(std::string_view haystack, std::string_view needle) {
+    size_t count = 0;
+    for (size_t pos = kernelFind(haystack, needle); pos != std::string_view::npos;
+         pos = kernelFind(haystack, needle, pos + needle.size())) {
+        ++count;
+    }
+    return count;
+}
+
+void kernelAsciiLower(const char* in, char* out, size_t n) {
+#if MEGALADON_X86_SIMD
+    if (useAvx2()) return caseMapAvx2(in, out, n, 'A');
+#endif
+    caseMapScalar(in, out, 0, n, 'A');
+}
+
+void kernelAsciiUpper(const char* in, char* out, size_t n) {
+#if MEGALADON_X86_SIMD
+    if (useAvx2()) return caseMapAvx2(in, out, n, 'a');
+#endif
+    caseMapScalar(in, out, 0, n, 'a');
+}
+
+size_t kernelCountAnyOf(std::string_view text, std::string_view bytes) {
+    bool member[256] = {};
+    for (char c : bytes) member[static_cast<unsigned char>(c)] = true;
+#if MEGALADON_X86_SIMD
+    if (useAvx2() && !bytes.empty() && bytes.size() <= 16) return countAnyOfAvx2(text, bytes, member);
+#endif
+    return countAnyOfScalar(reinterpret_cast<const unsigned char*>(text.data()), 0, text.size(), member);
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>     // For size_t
+#include <string_view>
+
+// Byte-string kernels for the string builtins. Like the numeric kernels, each
+// picks an AVX2 implementation at runtime when the CPU supports it and falls
+// back to a portable loop otherwise. Case mapping and character classes are
+// ASCII-only; other bytes pass through unchanged, as with std::tolower in the
+// "C" locale.
+
+// Position of the first 'needle' in 'haystack' at or after 'from', or
+// std::string_view::npos. An empty needle matches at 'from' (if in range).
+size_t kernelFind(std::string_view haystack, std::string_view needle, size_t from = 0);
+
+// Number of non-overlapping occurrences of a non-empty 'needle'
+size_t kernelCount(std::string_view haystack, std::string_view needle);
+
+// out[i] = in[i] with A-Z mapped to a-z (or a-z to A-Z); 'in' and 'out' may be the same buffer
+void kernelAsciiLower(const char* in, char* out, size_t n);
+void kernelAsciiUpper(const char* in, char* out, size_t n);
+
+// Number of bytes of 'text' that appear in 'bytes', e.g. "aeiouAEIOU" for vowels
+size_t kernelCountAnyOf(std::string_view text, std::string_view bytes);
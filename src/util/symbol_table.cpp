@@ -0,0 +1,48 @@
+#include "symbol_table.h"
+#include <deque>
+#include <mutex>
+#include <stdexcept> // For std::runtime_error
+#include <unordered_map>
+
+namespace {
+struct SymbolStorage {
+    std::mutex lock;
+    std::deque<std::string> names; // deque keeps references stable as it grows
+    std::unordered_map<std::string_view, SymbolId> ids; // Keys view into 'names'
+};
+
+SymbolStorage& storage() {
+    static SymbolStorage instance;
+    return instance;
+}
+} // namespace
+
+SymbolId SymbolTable::intern(std::string_view name) {
+    SymbolStorage& table = storage();
+    std::lock_guard<std::mutex> guard(table.lock);
+
+    auto it = table.ids.find(name);
+    if (it != table.ids.end()) {
+        return it->second;
+    }
+
+    SymbolId id = static_cast<SymbolId>(table.names.size());
+    table.names.emplace_back(name);
+    table.ids.emplace(table.names.back(), id);
+    return id;
+}
+
+const std::string& SymbolTable::name(SymbolId id) {
+    SymbolStorage& table = storage();
+    std::lock_guard<std::mutex> guard(table.lock);
+    if (id >= table.names.size()) {
+        throw std::runtime_error("MegaladonError: Internal error: Unknown symbol id.");
+    }
+    return table.names[id];
+}
+
+size_t SymbolTable::size() {
+    SymbolStorage& table = storage();
+    std::lock_guard<std::mutex> guard(table.lock);
+    return table.names.size();
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <cstdint> // For uint32_t
+
+// Dense integer id for an interned identifier
+using SymbolId = uint32_t;
+constexpr SymbolId NO_SYMBOL = UINT32_MAX; // Token is not an identifier / not interned
+
+// Process-wide identifier table. The lexer interns every identifier once, so
+// environments and builtin registration can compare integer ids instead of strings.
+// Interning is thread-safe; ids are never reused.
+class SymbolTable {
+public:
+    static SymbolId intern(std::string_view name);
+    static const std::string& name(SymbolId id);
+    static size_t size();
+};
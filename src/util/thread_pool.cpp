@@ -0,0 +1,109 @@
+#include "thread_pool.h"
+#include <algorithm> // For std::min, std::max
+#include <cstdlib>   // For std::getenv, std::strtoul
+
+namespace {
+// Set while a thread is running chunks, so nested parallelFor calls run inline
+thread_local bool insidePool = false;
+
+size_t defaultThreadCount() {
+    if (const char* setting = std::getenv("MEGALADON_THREADS")) {
+        unsigned long threads = std::strtoul(setting, nullptr, 10);
+        if (threads > 0) return threads;
+    }
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+} // namespace
+
+ThreadPool::ThreadPool(size_t threads) {
+    for (size_t i = 1; i < threads; ++i) {
+        workers.emplace_back([this] { workerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(stateLock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool(defaultThreadCount());
+    return pool;
+}
+
+void ThreadPool::workerLoop() {
+    size_t seen = 0;
+    std::unique_lock<std::mutex> lock(stateLock);
+    while (true) {
+        wake.wait(lock, [&] { return stopping || generation != seen; });
+        if (stopping) return;
+        seen = generation;
+        lock.unlock();
+        runChunks();
+        lock.lock();
+    }
+}
+
+void ThreadPool::runChunks() {
+    insidePool = true;
+    std::unique_lock<std::mutex> lock(stateLock);
+    while (body && nextChunk * chunkSize < count) {
+        size_t begin = nextChunk++ * chunkSize;
+        size_t end = std::min(count, begin + chunkSize);
+        const auto* job = body;
+        lock.unlock();
+        std::exception_ptr error;
+        try {
+            (*job)(begin, end);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        lock.lock();
+        if (error && !failure) failure = error;
+        if (--chunksLeft == 0) finished.notify_all();
+    }
+    insidePool = false;
+}
+
+void ThreadPool::parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body) {
+    if (count == 0) return;
+    grain = std::max<size_t>(grain, 1);
+    size_t chunks = (count + grain - 1) / grain;
+    if (workers.empty() || chunks == 1 || insidePool || !jobLock.try_lock()) {
+        body(0, count);
+        return;
+    }
+    std::lock_guard<std::mutex> job(jobLock, std::adopt_lock);
+
+    // A few chunks per thread, so a slow chunk does not leave the others idle
+    chunks = std::min(chunks, size() * 4);
+    size_t size = (count + chunks - 1) / chunks;
+    {
+        std::lock_guard<std::mutex> lock(stateLock);
+        this->body = &body;
+        this->count = count;
+        chunkSize = size;
+        nextChunk = 0;
+        chunksLeft = (count + size - 1) / size;
+        failure = nullptr;
+        generation++;
+    }
+    wake.notify_all();
+    runChunks();
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(stateLock);
+        finished.wait(lock, [this] { return chunksLeft == 0; });
+        this->body = nullptr;
+        error = failure;
+        failure = nullptr;
+    }
+    if (error) std::rethrow_exception(error);
+}
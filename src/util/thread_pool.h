@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef> // For size_t
+#include <functional>
+#include <thread>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <exception> // For std::exception_ptr
+
+// Fixed set of worker threads for data-parallel loops in native code (matrix
+// kernels, bulk builtins). The interpreter itself stays single-threaded: work
+// handed to the pool must not touch interpreter state.
+//
+// The shared pool has one thread per hardware thread, or MEGALADON_THREADS if
+// that environment variable is set (1 turns multithreading off).
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threads); // Total threads, including the caller's
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return workers.size() + 1; }
+
+    // Runs body(begin, end) over chunks covering [0, count), each at least 'grain'
+    // items long, and returns when all of them are done. The calling thread
+    // works on chunks too. The first exception thrown by 'body' is rethrown here.
+    // Calls made while the pool is busy (e.g. from inside 'body') run inline.
+    void parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body);
+
+    static ThreadPool& shared();
+
+private:
+    void workerLoop();
+    void runChunks(); // Claims and runs chunks of the current job until none are left
+
+    std::vector<std::thread> workers;
+    std::mutex jobLock;  // Held by the thread running a parallelFor
+    std::mutex stateLock;
+    std::condition_variable wake;
+    std::condition_variable finished;
+
+    // Current job; written under 'stateLock' before workers are woken
+    const std::function<void(size_t, size_t)>* body = nullptr;
+    size_t count = 0;
+    size_t chunkSize = 0;
+    size_t nextChunk = 0;      // Guarded by 'stateLock'
+    size_t chunksLeft = 0;     // Chunks not yet finished
+    size_t generation = 0;     // Bumped for every job so workers notice new work
+    std::exception_ptr failure;
+    bool stopping = false;
+};
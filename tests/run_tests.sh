@@ -0,0 +1,42 @@
+#!/bin/sh
+# Runs every tests/*.meg script with the interpreter and checks its output.
+#
+# A script states what it must print with '// expect: <line>' comments, in
+# order. A script that must stop with a runtime error ends with
+# '// expect runtime error: <text>', where <text> is part of the message.
+#
+# Usage: tests/run_tests.sh [path/to/megaladon]   (default: ./megaladon)
+# C++ tests of individual modules are in tests/unit (see run_unit_tests.sh).
+
+interpreter=${1:-./megaladon}
+dir=$(dirname "$0")
+failed=0
+total=0
+
+for script in "$dir"/*.meg; do
+    total=$((total + 1))
+    expected=$(sed -n 's/.*\/\/ expect: //p' "$script")
+    error=$(sed -n 's/.*\/\/ expect runtime error: //p' "$script")
+
+    actual=$("$interpreter" "$script" 2>/tmp/megaladon_test_stderr)
+    status=$?
+
+    ok=1
+    [ "$actual" = "$expected" ] || ok=0
+    if [ -n "$error" ]; then
+        [ "$status" -eq 70 ] && grep -qF "$error" /tmp/megaladon_test_stderr || ok=0
+    else
+        [ "$status" -eq 0 ] || ok=0
+    fi
+
+    if [ "$ok" -eq 0 ]; then
+        failed=$((failed + 1))
+        echo "FAIL $script"
+        echo "--- expected"; echo "$expected"; [ -n "$error" ] && echo "runtime error: $error"
+        echo "--- actual (exit $status)"; echo "$actual"; cat /tmp/megaladon_test_stderr
+    fi
+done
+
+rm -f /tmp/megaladon_test_stderr
+echo "$((total - failed)) of $total passed"
+[ "$failed" -eq 0 ]
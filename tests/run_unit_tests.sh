@@ -0,0 +1,30 @@
+#!/bin/sh
+# Builds and runs every tests/unit/*_test.cpp against the interpreter's value,
+# utility and memory sources (src/types, src/util, src/memory). A test passes
+# when it exits with 0.
+#
+# Usage: tests/run_unit_tests.sh   (CXX picks the compiler)
+
+dir=$(dirname "$0")
+src="$dir/../src"
+binary=${TMPDIR:-/tmp}/megaladon_unit_test
+failed=0
+total=0
+
+for test in "$dir"/unit/*_test.cpp; do
+    total=$((total + 1))
+    if ! ${CXX:-g++} -std=c++17 -O1 -I"$src" "$test" "$src"/types/*.cpp "$src"/util/*.cpp "$src"/memory/*.cpp \
+        -lpthread -o "$binary"; then
+        failed=$((failed + 1))
+        echo "FAIL $test (build)"
+        continue
+    fi
+    if ! "$binary"; then
+        failed=$((failed + 1))
+        echo "FAIL $test"
+    fi
+done
+
+rm -f "$binary"
+echo "$((total - failed)) of $total passed"
+[ "$failed" -eq 0 ]
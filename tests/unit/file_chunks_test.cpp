@@ -0,0 +1,144 @@
+// Chunk boundaries of map_file's readers (src/types/file_records.h). The same
+// bytes read from a mapped file and from a pipe must be cut at the same
+// places, and the records of the chunks must be the records read_records
+// gives, also for delimiters that overlap themselves ("aa" in "aaa").
+
+#include "types/file_records.h"
+#include <cstdio>
+#include <cstdlib>    // For mkdtemp
+#include <fcntl.h>    // For open
+#include <string>
+#include <sys/stat.h> // For mkfifo
+#include <thread>
+#include <unistd.h>   // For write, close, unlink, rmdir
+#include <vector>
+
+namespace {
+
+int failures = 0;
+
+void check(bool ok, const std::string& what) {
+    if (!ok) {
+        ++failures;
+        std::fprintf(stderr, "FAIL %s\n", what.c_str());
+    }
+}
+
+// Records split left to right, as read_records documents them
+std::vector<std::string> expectedRecords(std::string text, const std::string& delimiter) {
+    std::vector<std::string> records;
+    while (!text.empty()) {
+        size_t end = text.find(delimiter);
+        if (end == std::string::npos) {
+            records.push_back(text);
+            break;
+        }
+        records.push_back(text.substr(0, end));
+        text.erase(0, end + delimiter.size());
+    }
+    return records;
+}
+
+std::vector<std::string> readChunks(const std::string& path, const std::string& delimiter, size_t target) {
+    std::vector<std::string> chunks;
+    auto reader = FileChunkReader::open(path, delimiter, target);
+    std::shared_ptr<const char> owner;
+    std::string_view chunk;
+    while (reader->next(owner, chunk)) chunks.emplace_back(chunk);
+    return chunks;
+}
+
+std::vector<std::string> recordsOf(const std::vector<std::string>& chunks, const std::string& delimiter) {
+    std::vector<MegaladonValue> values;
+    for (const auto& chunk : chunks) {
+        auto owner = std::shared_ptr<const char>(std::make_shared<std::string>(chunk), chunk.data());
+        appendRecords(owner, chunk, delimiter, values);
+    }
+    std::vector<std::string> records;
+    for (const auto& value : values) records.push_back(value.asString().str());
+    return records;
+}
+
+std::vector<std::string> readRecords(const std::string& path, const std::string& delimiter) {
+    std::vector<std::string> records;
+    auto iterator = FileRecordsIterable(path, delimiter).iterate();
+    MegaladonValue item;
+    while (iterator->next(item)) records.push_back(item.asString().str());
+    return records;
+}
+
+void writeFile(const std::string& path, const std::string& text) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    std::fwrite(text.data(), 1, text.size(), file);
+    std::fclose(file);
+}
+
+// The chunks of 'text' written into a named pipe, which is read as a stream
+std::vector<std::string> readChunksFromPipe(const std::string& fifo, const std::string& text, const std::string& delimiter,
+                                            size_t target) {
+    std::thread writer([&] {
+        int fd = ::open(fifo.c_str(), O_WRONLY);
+        for (size_t done = 0; done < text.size();) {
+            ssize_t wrote = ::write(fd, text.data() + done, text.size() - done);
+            if (wrote <= 0) break;
+            done += static_cast<size_t>(wrote);
+        }
+        ::close(fd);
+    });
+    std::vector<std::string> chunks = readChunks(fifo, delimiter, target);
+    writer.join();
+    return chunks;
+}
+
+} // namespace
+
+int main() {
+    char pattern[] = "/tmp/megaladon_chunks_XXXXXX";
+    if (!::mkdtemp(pattern)) {
+        std::perror("mkdtemp");
+        return 1;
+    }
+    std::string dir = pattern;
+    std::string file = dir + "/input";
+    std::string fifo = dir + "/pipe";
+    if (::mkfifo(fifo.c_str(), 0600) != 0) {
+        std::perror("mkfifo");
+        return 1;
+    }
+
+    const std::vector<std::string> delimiters = {"\n", "a", "aa", "ba", "aba", "abab"};
+    const std::vector<size_t> targets = {1, 2, 3, 5, 8, 13, 40};
+    unsigned state = 12345;
+    for (int round = 0; round < 30; ++round) {
+        std::string text;
+        size_t length = static_cast<size_t>(round * 11 % 97 + (round == 0 ? 0 : 3));
+        for (size_t i = 0; i < length; ++i) {
+            state = state * 1103515245u + 12345u;
+            text.push_back("aab\n"[(state >> 16) % 4]);
+        }
+        writeFile(file, text);
+
+        for (const auto& delimiter : delimiters) {
+            std::vector<std::string> expected = expectedRecords(text, delimiter);
+            std::string name = "text #" + std::to_string(round) + ", delimiter \"" + (delimiter == "\n" ? "\\n" : delimiter) + "\"";
+            check(readRecords(file, delimiter) == expected, name + ": read_records");
+            for (size_t target : targets) {
+                std::string where = name + ", target " + std::to_string(target);
+                std::vector<std::string> mapped = readChunks(file, delimiter, target);
+                std::vector<std::string> streamed = readChunksFromPipe(fifo, text, delimiter, target);
+                check(mapped == streamed, where + ": mapped and streamed chunks differ");
+                check(recordsOf(mapped, delimiter) == expected, where + ": records of mapped chunks");
+                check(recordsOf(streamed, delimiter) == expected, where + ": records of streamed chunks");
+                std::string joined;
+                for (const auto& chunk : mapped) joined += chunk;
+                check(joined == text, where + ": chunks do not cover the file");
+            }
+        }
+    }
+
+    ::unlink(file.c_str());
+    ::unlink(fifo.c_str());
+    ::rmdir(dir.c_str());
+    std::printf("file_chunks_test: %s\n", failures == 0 ? "ok" : "FAILED");
+    return failures == 0 ? 0 : 1;
+}